@@ -0,0 +1,164 @@
+/*******************************************************************************
+
+    bench_eex_ao.c - Active object event throughput on the console build.
+
+    Reports events dispatched per second by a ring of n active objects. An
+    interrupt handler takes events from a pool and posts them to the first
+    object, and each object forwards an event to the next one in the ring
+    until it has made BENCH_HOPS hops, when it is recycled. Going up the ring
+    each post readies a higher priority object, which runs when the
+    dispatch completes, the post from the top object back to the first is
+    queued. Events are passed by pointer and never copied.
+
+    With more than one event in flight the objects find several events
+    queued and dispatch them in one run. A waiting object's notification is
+    tried on every scheduler pass, so the rate falls as objects are added.
+
+    The platform functions are provided here so the kernel can be driven
+    without eexKernelStart. Objects that are not part of a measurement are
+    suspended.
+
+    gcc -std=gnu99 -O2 -D__CONSOLE__ -DNDEBUG -Ihdr bench/bench_eex_ao.c src/eex_os.c src/eex_ao.c -o bench_eex_ao
+
+    COPYRIGHT NOTICE: (c) ee-quipment.com
+    All Rights Reserved
+
+ ******************************************************************************/
+
+
+#include  <stdint.h>
+#include  <stdio.h>
+#include  <time.h>
+#include  "eex_os.h"
+#include  "eex_ao.h"
+
+#define STATIC static
+
+#define BENCH_NS_MIN        200000000   // run each measurement for at least 200 ms
+#define BENCH_RUNNING_PRI   1           // the thread that is interrupted
+#define BENCH_AO_PRI        2           // objects are BENCH_AO_PRI to BENCH_AO_PRI + BENCH_N_AO - 1
+#define BENCH_N_AO          31
+#define BENCH_N_EVENTS      16          // queue and pool size
+#define BENCH_HOPS          64          // dispatches per event
+
+typedef struct {
+    eex_ao_event_t    super;
+    uint32_t          hops;             // dispatches left
+} bench_event_t;
+
+EEX_AO_POOL_NEW(bench_pool, sizeof(bench_event_t), BENCH_N_EVENTS);
+
+static eex_ao_slot_t     g_slots[BENCH_N_AO][BENCH_N_EVENTS];
+static eex_ao_cb_t       g_ao[BENCH_N_AO];
+static uint32_t          g_n_ao;                    // objects in the ring
+static volatile uint32_t g_in_interrupt = 0;
+static volatile uint32_t g_n_run        = 0;
+volatile uint32_t        g_timer_ms     = 0;
+
+
+// Console platform, interrupt context is simulated with g_in_interrupt
+uint32_t eexCPUAtomic32CAS(uint32_t volatile *addr, uint32_t expected, uint32_t store) {
+    return (__sync_bool_compare_and_swap(addr, expected, store) ? 0 : 1);
+}
+uint32_t eexCPUAtomic64CAS(uint64_t volatile *addr, uint64_t expected, uint64_t store) {
+    return (__sync_bool_compare_and_swap(addr, expected, store) ? 0 : 1);
+}
+void *   eexCPUAtomicPtrCAS(void * volatile *addr, void * expected, void * store) {
+    return (__sync_bool_compare_and_swap(addr, expected, store) ? NULL : (void *) 1);
+}
+uint32_t eexCPUCLZ(uint32_t x)              { return (x ? __builtin_clz(x) : 32); }
+uint32_t eexInInterrupt()                   { return (g_in_interrupt); }
+void     eexSchedulerPend(void)             { }
+uint32_t eexKernelTime(uint32_t *us)        { if (us) { *us = 0; } return (g_timer_ms); }
+
+
+static uint64_t _nowNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t) ts.tv_sec * 1000000000u + (uint64_t) ts.tv_nsec);
+}
+
+// argument is the object's place in the ring
+static void ao_forward(void * const argument, eex_ao_event_t *event) {
+    bench_event_t *evt = (bench_event_t *) event;
+
+    ++g_n_run;
+    if (--evt->hops) { (void) eexAOPost(&g_ao[((uint32_t) (uintptr_t) argument + 1) % g_n_ao], evt); }
+}
+
+static void thread_running(void * const argument) {
+    eexThreadEntry();
+}
+
+// run the scheduler and the threads it dispatches until it returns to the interrupted thread
+static void _runUntilIdle(void) {
+    eex_thread_cb_t *tcb;
+
+    tcb = eexScheduler(true);
+    while (tcb) {
+        tcb->fn_thread(tcb->arg);
+        tcb = eexScheduler(false);
+    }
+}
+
+static void roundEvents(uint32_t n_events) {
+    bench_event_t *evt;
+
+    g_in_interrupt = 1;
+    for (uint32_t i=0; i<n_events; ++i) {
+        evt = (bench_event_t *) eexAOEventNew(bench_pool, 0);
+        evt->hops = BENCH_HOPS;
+        (void) eexAOPost(&g_ao[0], evt);
+    }
+    g_in_interrupt = 0;
+    _runUntilIdle();
+}
+
+// Resume the first n objects, suspend the rest
+static void _measuring(uint32_t n) {
+    g_n_ao = n;
+    for (uint32_t i=0; i<BENCH_N_AO; ++i) {
+        if (i < n) { eexThreadResume(BENCH_AO_PRI + i); }
+        else       { eexThreadSuspend(BENCH_AO_PRI + i); }
+    }
+}
+
+#define BENCH_RUN(n_ao, n_events)                                                       \
+    do {                                                                                \
+        uint64_t t0 = _nowNs(), t1, n = 0;                                              \
+        g_n_run = 0;                                                                    \
+        do {                                                                            \
+            for (uint32_t j=0; j<256; ++j, n+=(n_events) * BENCH_HOPS) {               \
+                roundEvents(n_events);                                                  \
+            }                                                                           \
+            t1 = _nowNs();                                                              \
+        } while ((t1 - t0) < BENCH_NS_MIN);                                             \
+        printf("%2u objects %2u in flight  %12.0f events/s  %s\n", (unsigned) (n_ao),   \
+               (unsigned) (n_events), (double) n * 1e9 / (double) (t1 - t0),            \
+               (g_n_run == n) ? "" : "(events lost)");                                  \
+    } while(0)
+
+
+int main(void) {
+    static const uint32_t n_ao[]     = { 2, 8, 16, 31 };
+    static const uint32_t n_events[] = { 1, 8 };
+    eex_thread_cb_t *tcb;
+
+    for (uint32_t i=0; i<BENCH_N_AO; ++i) {
+        g_ao[i] = (eex_ao_cb_t) { { g_slots[i], BENCH_N_EVENTS - 1, 0, 0, 0 }, NULL, NULL, 0 };
+        (void) eexAOCreate(&g_ao[i], ao_forward, (void *) (uintptr_t) i, BENCH_AO_PRI + i, NULL);
+    }
+    (void) eexThreadCreate(thread_running, NULL, BENCH_RUNNING_PRI, NULL);
+    for (uint32_t i=0; i<(BENCH_N_AO + 1); ++i) {   // dispatch the objects to wait, then leave the lowest running
+        tcb = eexScheduler(false);
+        tcb->fn_thread(tcb->arg);
+    }
+
+    for (uint32_t a=0; a<(sizeof(n_ao) / sizeof(n_ao[0])); ++a) {
+        _measuring(n_ao[a]);
+        for (uint32_t e=0; e<(sizeof(n_events) / sizeof(n_events[0])); ++e) {
+            BENCH_RUN(n_ao[a], n_events[e]);
+        }
+    }
+    return (0);
+}
@@ -0,0 +1,182 @@
+/*******************************************************************************
+
+    bench_eex_defer.c - Interrupt handler cost of waking a thread on the console build.
+
+    Times the part of an interrupt handler that hands its work to a thread,
+    either by posting a semaphore the thread waits on, which initializes an
+    event and tries the semaphore in eexPendPost, or by deferring a work item
+    with eexDefer, which pushes it onto the deferred list. The interrupts'
+    own work is the same either way and is left out.
+
+    The second table adds the thread side, the scheduler passes and the
+    thread running the work, for 1 and 8 interrupts between dispatches. The
+    deferred work thread takes all the items deferred since it last ran in
+    one batch.
+
+    The platform functions are provided here so the kernel can be driven
+    without eexKernelStart. The thread of the other measurement is suspended.
+
+    gcc -std=gnu99 -O2 -D__CONSOLE__ -DNDEBUG -Ihdr bench/bench_eex_defer.c src/eex_os.c -o bench_eex_defer
+
+    COPYRIGHT NOTICE: (c) ee-quipment.com
+    All Rights Reserved
+
+ ******************************************************************************/
+
+
+#include  <stdint.h>
+#include  <stdio.h>
+#include  <time.h>
+#include  "eex_os.h"
+
+#define STATIC static
+
+#define BENCH_NS_MIN        200000000   // run each measurement for at least 200 ms
+#define BENCH_RUNNING_PRI   1           // the thread that is interrupted
+#define BENCH_THREAD_PRI    2
+#define BENCH_DEFER_PRI     3
+#define BENCH_N_ITEMS       8           // most interrupts between dispatches
+
+EEX_SEMAPHORE_NEW(sema_bench, BENCH_N_ITEMS, 0);
+
+static eex_defer_t       g_item[BENCH_N_ITEMS];     // one per interrupt source
+static volatile uint32_t g_in_interrupt = 0;
+static volatile uint32_t g_n_run        = 0;
+volatile uint32_t        g_timer_ms     = 0;
+
+void _eexDeferThread(void * const argument);
+
+
+// Console platform, interrupt context is simulated with g_in_interrupt
+uint32_t eexCPUAtomic32CAS(uint32_t volatile *addr, uint32_t expected, uint32_t store) {
+    return (__sync_bool_compare_and_swap(addr, expected, store) ? 0 : 1);
+}
+uint32_t eexCPUAtomic64CAS(uint64_t volatile *addr, uint64_t expected, uint64_t store) {
+    return (__sync_bool_compare_and_swap(addr, expected, store) ? 0 : 1);
+}
+void *   eexCPUAtomicPtrCAS(void * volatile *addr, void * expected, void * store) {
+    return (__sync_bool_compare_and_swap(addr, expected, store) ? NULL : (void *) 1);
+}
+uint32_t eexCPUCLZ(uint32_t x)              { return (x ? __builtin_clz(x) : 32); }
+uint32_t eexInInterrupt()                   { return (g_in_interrupt); }
+void     eexSchedulerPend(void)             { }
+uint32_t eexKernelTime(uint32_t *us)        { if (us) { *us = 0; } return (g_timer_ms); }
+
+
+static uint64_t _nowNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t) ts.tv_sec * 1000000000u + (uint64_t) ts.tv_nsec);
+}
+
+static void work(void * const argument) {
+    ++g_n_run;
+}
+
+static void thread_running(void * const argument) {
+    eexThreadEntry();
+}
+
+static void thread_sema_wait(void * const argument) {
+    static eex_status_t  rtn_status;
+
+    eexThreadEntry();
+    for (;;) {
+        eexPend(&rtn_status, NULL, eexWaitForever, sema_bench);
+        work(NULL);
+    }
+}
+
+// run the scheduler and the threads it dispatches until it returns to the interrupted thread
+static void _runUntilIdle(void) {
+    eex_thread_cb_t *tcb;
+
+    tcb = eexScheduler(true);
+    while (tcb) {
+        tcb->fn_thread(tcb->arg);
+        tcb = eexScheduler(false);
+    }
+}
+
+static void isrPost(uint32_t i) {
+    eex_status_t  rtn_status;
+
+    g_in_interrupt = 1;
+    eexPost(&rtn_status, 0, 0, sema_bench);
+    g_in_interrupt = 0;
+}
+
+static void isrDefer(uint32_t i) {
+    g_in_interrupt = 1;
+    (void) eexDefer(&g_item[i]);
+    g_in_interrupt = 0;
+}
+
+// Resume the thread at pri, suspend the other one
+static void _measuring(uint32_t pri) {
+    for (uint32_t p=BENCH_THREAD_PRI; p<=BENCH_DEFER_PRI; ++p) {
+        if (p == pri) { eexThreadResume(p); }
+        else          { eexThreadSuspend(p); }
+    }
+}
+
+// only the interrupts are timed, not the thread that runs their work
+#define BENCH_ISR(label, isr)                                                           \
+    do {                                                                                \
+        uint64_t t0, t = 0, n = 0;                                                      \
+        do {                                                                            \
+            for (uint32_t j=0; j<1024; ++j) {                                           \
+                t0 = _nowNs();                                                          \
+                for (uint32_t i=0; i<BENCH_N_ITEMS; ++i) { isr(i); }                    \
+                t += _nowNs() - t0;                                                     \
+                n += BENCH_N_ITEMS;                                                     \
+                _runUntilIdle();                                                        \
+            }                                                                           \
+        } while (t < BENCH_NS_MIN);                                                     \
+        printf("%-10s %8.1f ns/interrupt\n", label, (double) t / (double) n);           \
+    } while(0)
+
+// interrupts and the thread that runs their work
+#define BENCH_RUN(label, n_isr, isr)                                                    \
+    do {                                                                                \
+        uint64_t t0 = _nowNs(), t1, n = 0;                                              \
+        g_n_run = 0;                                                                    \
+        do {                                                                            \
+            for (uint32_t j=0; j<1024; ++j, n+=(n_isr)) {                               \
+                for (uint32_t i=0; i<(n_isr); ++i) { isr(i); }                          \
+                _runUntilIdle();                                                        \
+            }                                                                           \
+            t1 = _nowNs();                                                              \
+        } while ((t1 - t0) < BENCH_NS_MIN);                                             \
+        printf("%-10s %u per dispatch %8.1f ns/interrupt  %s\n", label, (unsigned) (n_isr), \
+               (double) (t1 - t0) / (double) n, (g_n_run == n) ? "" : "(work lost)");  \
+    } while(0)
+
+
+int main(void) {
+    eex_thread_cb_t *tcb;
+
+    for (uint32_t i=0; i<BENCH_N_ITEMS; ++i) { g_item[i] = (eex_defer_t) { NULL, work, NULL, 0 }; }
+    (void) eexThreadCreate(thread_sema_wait, NULL, BENCH_THREAD_PRI, NULL);
+    (void) eexThreadCreate(_eexDeferThread, NULL, BENCH_DEFER_PRI, NULL);
+    (void) eexThreadCreate(thread_running, NULL, BENCH_RUNNING_PRI, NULL);
+    for (int i=0; i<3; ++i) {                   // dispatch the waiting threads, then leave the lowest running
+        tcb = eexScheduler(false);
+        tcb->fn_thread(tcb->arg);
+    }
+
+    printf("interrupt handler only\n");
+    _measuring(BENCH_THREAD_PRI);
+    BENCH_ISR("post",  isrPost);
+    _measuring(BENCH_DEFER_PRI);
+    BENCH_ISR("defer", isrDefer);
+
+    printf("interrupt handler and thread\n");
+    _measuring(BENCH_THREAD_PRI);
+    BENCH_RUN("post",  1, isrPost);
+    BENCH_RUN("post",  BENCH_N_ITEMS, isrPost);
+    _measuring(BENCH_DEFER_PRI);
+    BENCH_RUN("defer", 1, isrDefer);
+    BENCH_RUN("defer", BENCH_N_ITEMS, isrDefer);
+    return (0);
+}
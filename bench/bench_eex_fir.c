@@ -0,0 +1,99 @@
+/*******************************************************************************
+
+    bench_eex_fir.c - FIR filter throughput on the console build.
+
+    Reports samples per second by tap count for each filter kernel, and for
+    a ring buffer delay line that fetches each tap through a modulo index
+    (as the archived dlGetTap does) for comparison.
+
+    gcc -std=gnu99 -O2 -D__CONSOLE__ -Ihdr bench/bench_eex_fir.c src/eex_fir.c -o bench_eex_fir
+    add -mavx2 -mfma to build the AVX2 kernels instead of SSE2.
+
+    COPYRIGHT NOTICE: (c) ee-quipment.com
+    All Rights Reserved
+
+ ******************************************************************************/
+
+
+#include  <stdint.h>
+#include  <stdio.h>
+#include  <time.h>
+#include  "eex_os.h"
+#include  "eex_fir.h"
+
+#define STATIC static
+
+#define BENCH_TAPS_MAX      256
+#define BENCH_NS_MIN        200000000   // run each measurement for at least 200 ms
+
+EEX_DELAY_LINE_NEW(dl_i16, int16_t, BENCH_TAPS_MAX);
+EEX_DELAY_LINE_NEW(dl_i32, int32_t, BENCH_TAPS_MAX);
+EEX_DELAY_LINE_NEW(dl_f32, float,   BENCH_TAPS_MAX);
+
+static int16_t  h_i16[BENCH_TAPS_MAX], ring_i16[BENCH_TAPS_MAX];
+static int32_t  h_i32[BENCH_TAPS_MAX];
+static float    h_f32[BENCH_TAPS_MAX];
+
+static volatile int64_t g_sink_i;      // keep results live
+static volatile float   g_sink_f;
+
+
+static uint64_t _nowNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t) ts.tv_sec * 1000000000u + (uint64_t) ts.tv_nsec);
+}
+
+// Delay lines are created with BENCH_TAPS_MAX taps, run with fewer by shrinking n_taps
+static void _setTaps(uint32_t n_taps) {
+    ((eex_dl_cb_t *) dl_i16)->n_taps = ((eex_dl_cb_t *) dl_i32)->n_taps = ((eex_dl_cb_t *) dl_f32)->n_taps = (uint16_t) n_taps;
+    ((eex_dl_cb_t *) dl_i16)->index  = ((eex_dl_cb_t *) dl_i32)->index  = ((eex_dl_cb_t *) dl_f32)->index  = 0;
+}
+
+// Ring buffer delay line with a modulo index per tap
+static int64_t _firModuloI16(uint32_t *p_index, uint32_t n_taps, int16_t sample) {
+    int64_t acc = 0;
+
+    *p_index = (*p_index == 0) ? n_taps - 1 : *p_index - 1;
+    ring_i16[*p_index] = sample;
+    for (uint32_t k=0; k<n_taps; ++k) { acc += (int32_t) h_i16[k] * ring_i16[(*p_index + k) % n_taps]; }
+    return (acc);
+}
+
+#define BENCH_RUN(label, n_taps, expr)                                                  \
+    do {                                                                                \
+        uint64_t t0 = _nowNs(), t1, n = 0;                                              \
+        do {                                                                            \
+            for (uint32_t j=0; j<1024; ++j, ++n) { expr; }                              \
+            t1 = _nowNs();                                                              \
+        } while ((t1 - t0) < BENCH_NS_MIN);                                             \
+        printf("%-12s %5u taps  %12.0f samples/s\n", label, (unsigned) (n_taps),       \
+               (double) n * 1e9 / (double) (t1 - t0));                                  \
+    } while(0)
+
+
+int main(void) {
+    static const uint32_t taps[] = { 8, 16, 31, 64, 128, 256 };
+    uint32_t ring_index = 0;
+
+    for (uint32_t i=0; i<BENCH_TAPS_MAX; ++i) {
+        h_i16[i] = (int16_t) (i * 37);  h_i32[i] = (int32_t) (i * 4099);  h_f32[i] = 1.0f / (float) (i + 1);
+    }
+
+#if (defined __AVX2__)
+    printf("eex_fir kernels: AVX2\n");
+#elif (defined __SSE2__)
+    printf("eex_fir kernels: SSE2\n");
+#else
+    printf("eex_fir kernels: generic C\n");
+#endif
+
+    for (uint32_t t=0; t<(sizeof(taps) / sizeof(taps[0])); ++t) {
+        _setTaps(taps[t]);
+        BENCH_RUN("modulo i16", taps[t], g_sink_i = _firModuloI16(&ring_index, taps[t], (int16_t) j));
+        BENCH_RUN("fir i16",    taps[t], g_sink_i = eexFirI16(dl_i16, h_i16, (int16_t) j));
+        BENCH_RUN("fir i32",    taps[t], g_sink_i = eexFirI32(dl_i32, h_i32, (int32_t) j));
+        BENCH_RUN("fir f32",    taps[t], g_sink_f = eexFirF32(dl_f32, h_f32, (float) j));
+    }
+    return (0);
+}
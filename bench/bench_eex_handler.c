@@ -0,0 +1,134 @@
+/*******************************************************************************
+
+    bench_eex_handler.c - Wake-to-run cost of a fast handler and a thread on the console build.
+
+    Times a post from an interrupt handler to a semaphore, through the
+    scheduler pass that runs the waiter, back to the interrupted thread. A
+    thread waiter is dispatched, resumed at its continuation, pends again and
+    takes a second scheduler pass to return to the interrupted thread. A fast
+    handler is called from the first pass and the pass returns directly.
+
+    On the target each dispatch is also an exception frame built by PendSV,
+    which the console build doesn't see, so the saving there is larger.
+
+    The platform functions are provided here so the kernel can be driven
+    without eexKernelStart.
+
+    gcc -std=gnu99 -O2 -D__CONSOLE__ -DNDEBUG -Ihdr bench/bench_eex_handler.c src/eex_os.c -o bench_eex_handler
+
+    COPYRIGHT NOTICE: (c) ee-quipment.com
+    All Rights Reserved
+
+ ******************************************************************************/
+
+
+#include  <stdint.h>
+#include  <stdio.h>
+#include  <time.h>
+#include  "eex_os.h"
+
+#define STATIC static
+
+#define BENCH_NS_MIN        200000000   // run each measurement for at least 200 ms
+#define BENCH_RUNNING_PRI   1           // the thread that is interrupted
+#define BENCH_THREAD_PRI    2
+#define BENCH_HANDLER_PRI   3
+
+EEX_SEMAPHORE_NEW(sema_thread, 1, 0);
+EEX_SEMAPHORE_NEW(sema_handler, 1, 0);
+
+static volatile uint32_t g_in_interrupt = 0;
+static volatile uint32_t g_n_run        = 0;
+volatile uint32_t        g_timer_ms     = 0;
+
+
+// Console platform, interrupt context is simulated with g_in_interrupt
+uint32_t eexCPUAtomic32CAS(uint32_t volatile *addr, uint32_t expected, uint32_t store) {
+    return (__sync_bool_compare_and_swap(addr, expected, store) ? 0 : 1);
+}
+uint32_t eexCPUAtomic64CAS(uint64_t volatile *addr, uint64_t expected, uint64_t store) {
+    return (__sync_bool_compare_and_swap(addr, expected, store) ? 0 : 1);
+}
+void *   eexCPUAtomicPtrCAS(void * volatile *addr, void * expected, void * store) {
+    return (__sync_bool_compare_and_swap(addr, expected, store) ? NULL : (void *) 1);
+}
+uint32_t eexCPUCLZ(uint32_t x)              { return (x ? __builtin_clz(x) : 32); }
+uint32_t eexInInterrupt()                   { return (g_in_interrupt); }
+void     eexSchedulerPend(void)             { }
+uint32_t eexKernelTime(uint32_t *us)        { if (us) { *us = 0; } return (g_timer_ms); }
+
+
+static uint64_t _nowNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t) ts.tv_sec * 1000000000u + (uint64_t) ts.tv_nsec);
+}
+
+static void thread_running(void * const argument) {
+    eexThreadEntry();
+}
+
+static void thread_sema_wait(void * const argument) {
+    static eex_status_t  rtn_status;
+
+    eexThreadEntry();
+    for (;;) {
+        eexPend(&rtn_status, NULL, eexWaitForever, sema_thread);
+        ++g_n_run;
+    }
+}
+
+static void handler_sema(void *argument, eex_status_t status, uint32_t val) {
+    ++g_n_run;
+}
+
+// interrupt posts, then the scheduler passes until the interrupted thread is returned to
+static void wakeThread(void) {
+    eex_status_t     rtn_status;
+    eex_thread_cb_t *tcb;
+
+    g_in_interrupt = 1;
+    eexPost(&rtn_status, 0, 0, sema_thread);
+    g_in_interrupt = 0;
+    tcb = eexScheduler(true);                   // dispatch the waiter
+    tcb->fn_thread(tcb->arg);                   // it runs and pends again
+    (void) eexScheduler(false);                 // return to the interrupted thread
+}
+
+static void wakeHandler(void) {
+    eex_status_t     rtn_status;
+
+    g_in_interrupt = 1;
+    eexPost(&rtn_status, 0, 0, sema_handler);
+    g_in_interrupt = 0;
+    (void) eexScheduler(true);                  // handler runs, return to the interrupted thread
+}
+
+#define BENCH_RUN(label, expr)                                                          \
+    do {                                                                                \
+        uint64_t t0 = _nowNs(), t1, n = 0;                                              \
+        g_n_run = 0;                                                                    \
+        do {                                                                            \
+            for (uint32_t j=0; j<1024; ++j, ++n) { expr; }                              \
+            t1 = _nowNs();                                                              \
+        } while ((t1 - t0) < BENCH_NS_MIN);                                             \
+        printf("%-12s %8.1f ns/wake  %s\n", label, (double) (t1 - t0) / (double) n,    \
+               (g_n_run == n) ? "" : "(waiter not run)");                               \
+    } while(0)
+
+
+int main(void) {
+    eex_thread_cb_t *tcb;
+
+    (void) eexThreadCreate(thread_sema_wait, NULL, BENCH_THREAD_PRI, NULL);
+    (void) eexHandlerCreate(handler_sema, NULL, BENCH_HANDLER_PRI, sema_handler, 0, NULL);
+    (void) eexThreadCreate(thread_running, NULL, BENCH_RUNNING_PRI, NULL);
+    for (int i=0; i<2; ++i) {                   // dispatch the waiting thread, then leave the lowest running
+        tcb = eexScheduler(false);
+        tcb->fn_thread(tcb->arg);
+    }
+
+    BENCH_RUN("thread",  wakeThread());
+    BENCH_RUN("handler", wakeHandler());
+    return (0);
+}
@@ -0,0 +1,120 @@
+/*******************************************************************************
+
+    bench_eex_notify.c - Interrupt to thread wake-up cost on the console build.
+
+    Times the interrupt side of a wake-up: a post from an interrupt handler
+    to a higher priority thread that is waiting, up to the point where the
+    scheduler is pended. Compares eexPostSignal, which goes through a signal
+    kernel object and its thread lists, with eexNotify to the thread's own
+    notification.
+
+    The platform functions are provided here so the kernel can be driven
+    without eexKernelStart. Both threads stay waiting for the whole run.
+
+    gcc -std=gnu99 -O2 -D__CONSOLE__ -DNDEBUG -Ihdr bench/bench_eex_notify.c src/eex_os.c -o bench_eex_notify
+
+    COPYRIGHT NOTICE: (c) ee-quipment.com
+    All Rights Reserved
+
+ ******************************************************************************/
+
+
+#include  <stdint.h>
+#include  <stdio.h>
+#include  <time.h>
+#include  "eex_os.h"
+
+#define STATIC static
+
+#define BENCH_NS_MIN        200000000   // run each measurement for at least 200 ms
+#define BENCH_RUNNING_PRI   1           // the thread that is interrupted
+#define BENCH_SIGNAL_PRI    2
+#define BENCH_NOTIFY_PRI    3
+
+EEX_SIGNAL_NEW(sig_bench);
+
+static volatile uint32_t g_in_interrupt = 0;
+static volatile uint32_t g_n_sched_pend = 0;
+volatile uint32_t        g_timer_ms     = 0;
+
+
+// Console platform, interrupt context is simulated with g_in_interrupt
+uint32_t eexCPUAtomic32CAS(uint32_t volatile *addr, uint32_t expected, uint32_t store) {
+    return (__sync_bool_compare_and_swap(addr, expected, store) ? 0 : 1);
+}
+uint32_t eexCPUAtomic64CAS(uint64_t volatile *addr, uint64_t expected, uint64_t store) {
+    return (__sync_bool_compare_and_swap(addr, expected, store) ? 0 : 1);
+}
+void *   eexCPUAtomicPtrCAS(void * volatile *addr, void * expected, void * store) {
+    return (__sync_bool_compare_and_swap(addr, expected, store) ? NULL : (void *) 1);
+}
+uint32_t eexCPUCLZ(uint32_t x)              { return (x ? __builtin_clz(x) : 32); }
+uint32_t eexInInterrupt()                   { return (g_in_interrupt); }
+void     eexSchedulerPend(void)             { ++g_n_sched_pend; }
+uint32_t eexKernelTime(uint32_t *us)        { if (us) { *us = 0; } return (g_timer_ms); }
+
+
+static uint64_t _nowNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t) ts.tv_sec * 1000000000u + (uint64_t) ts.tv_nsec);
+}
+
+static void thread_running(void * const argument) {
+    eexThreadEntry();
+}
+
+static void thread_signal_wait(void * const argument) {
+    static eex_status_t  rtn_status;
+
+    eexThreadEntry();
+    for (;;) { eexPendSignal(&rtn_status, NULL, eexWaitForever, 1, sig_bench); }
+}
+
+static void thread_notify_wait(void * const argument) {
+    static eex_status_t  rtn_status;
+
+    eexThreadEntry();
+    for (;;) { eexNotifyWait(&rtn_status, NULL, eexWaitForever, 0xffffffff); }
+}
+
+// interrupt handlers, never block
+static void isrPostSignal(void) {
+    eex_status_t  rtn_status;
+    eexPostSignal(&rtn_status, 1, sig_bench);
+}
+
+static void isrNotify(void) {
+    eex_status_t  rtn_status;
+    eexNotify(&rtn_status, BENCH_NOTIFY_PRI, EEX_NOTIFY_SET_BITS, 1);
+}
+
+#define BENCH_RUN(label, expr)                                                          \
+    do {                                                                                \
+        uint64_t t0 = _nowNs(), t1, n = 0;                                              \
+        g_n_sched_pend = 0;                                                             \
+        do {                                                                            \
+            for (uint32_t j=0; j<1024; ++j, ++n) { expr; }                              \
+            t1 = _nowNs();                                                              \
+        } while ((t1 - t0) < BENCH_NS_MIN);                                             \
+        printf("%-16s %8.1f ns/post  %s\n", label, (double) (t1 - t0) / (double) n,    \
+               (g_n_sched_pend == n) ? "" : "(thread not woken)");                      \
+    } while(0)
+
+
+int main(void) {
+    eex_thread_cb_t *tcb;
+
+    (void) eexThreadCreate(thread_signal_wait, NULL, BENCH_SIGNAL_PRI, NULL);
+    (void) eexThreadCreate(thread_notify_wait, NULL, BENCH_NOTIFY_PRI, NULL);
+    (void) eexThreadCreate(thread_running, NULL, BENCH_RUNNING_PRI, NULL);
+    for (int i=0; i<3; ++i) {                   // dispatch the waiting threads, then leave the lowest running
+        tcb = eexScheduler(false);
+        tcb->fn_thread(tcb->arg);
+    }
+
+    g_in_interrupt = 1;
+    BENCH_RUN("eexPostSignal", isrPostSignal());
+    BENCH_RUN("eexNotify",     isrNotify());
+    return (0);
+}
@@ -0,0 +1,119 @@
+/*******************************************************************************
+
+    bench_eex_sleep.c - Scheduler pass cost with sleeping threads on the console build.
+
+    Times a scheduler pass that re-dispatches a low priority ready thread while
+    n higher priority threads are blocked. The blocked threads are either
+    sleeping in eexDelay, which the scheduler skips until the earliest timeout
+    passes, or waiting on a semaphore, which it tries on every pass.
+
+    The platform functions are provided here so the kernel can be driven
+    without eexKernelStart. Threads that are not part of a measurement are
+    suspended.
+
+    gcc -std=gnu99 -O2 -D__CONSOLE__ -DNDEBUG -Ihdr bench/bench_eex_sleep.c src/eex_os.c -o bench_eex_sleep
+
+    COPYRIGHT NOTICE: (c) ee-quipment.com
+    All Rights Reserved
+
+ ******************************************************************************/
+
+
+#include  <stdint.h>
+#include  <stdio.h>
+#include  <time.h>
+#include  "eex_os.h"
+
+#define STATIC static
+
+#define BENCH_NS_MIN        200000000   // run each measurement for at least 200 ms
+#define BENCH_RUNNING_PRI   1           // the thread that is re-dispatched
+#define BENCH_N_BLOCKED     15          // of each kind
+#define BENCH_SLEEP_PRI     2           // sleeping threads are BENCH_SLEEP_PRI to BENCH_SLEEP_PRI + BENCH_N_BLOCKED - 1
+#define BENCH_SEMA_PRI      (BENCH_SLEEP_PRI + BENCH_N_BLOCKED)
+
+EEX_SEMAPHORE_NEW(sema_bench, 1, 0);
+
+volatile uint32_t        g_timer_ms = 0;
+
+
+// Console platform, always in thread mode
+uint32_t eexCPUAtomic32CAS(uint32_t volatile *addr, uint32_t expected, uint32_t store) {
+    return (__sync_bool_compare_and_swap(addr, expected, store) ? 0 : 1);
+}
+uint32_t eexCPUAtomic64CAS(uint64_t volatile *addr, uint64_t expected, uint64_t store) {
+    return (__sync_bool_compare_and_swap(addr, expected, store) ? 0 : 1);
+}
+void *   eexCPUAtomicPtrCAS(void * volatile *addr, void * expected, void * store) {
+    return (__sync_bool_compare_and_swap(addr, expected, store) ? NULL : (void *) 1);
+}
+uint32_t eexCPUCLZ(uint32_t x)              { return (x ? __builtin_clz(x) : 32); }
+uint32_t eexInInterrupt()                   { return (0); }
+void     eexSchedulerPend(void)             { }
+uint32_t eexKernelTime(uint32_t *us)        { if (us) { *us = 0; } return (g_timer_ms); }
+
+
+static uint64_t _nowNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t) ts.tv_sec * 1000000000u + (uint64_t) ts.tv_nsec);
+}
+
+static void thread_running(void * const argument) {
+    eexThreadEntry();
+}
+
+static void thread_sleep(void * const argument) {
+    eexThreadEntry();
+    for (;;) { eexDelay(eexWaitMax); }
+}
+
+static void thread_sema_wait(void * const argument) {
+    static eex_status_t  rtn_status;
+
+    eexThreadEntry();
+    for (;;) { eexPend(&rtn_status, NULL, eexWaitForever, sema_bench); }
+}
+
+// Resume the first n threads from first_pri, suspend the rest of both kinds
+static void _blocked(uint32_t first_pri, uint32_t n) {
+    for (uint32_t pri=BENCH_SLEEP_PRI; pri<(BENCH_SEMA_PRI + BENCH_N_BLOCKED); ++pri) {
+        if ((pri >= first_pri) && (pri < (first_pri + n))) { eexThreadResume(pri); }
+        else                                                { eexThreadSuspend(pri); }
+    }
+}
+
+#define BENCH_RUN(label, n_blocked, expr)                                               \
+    do {                                                                                \
+        uint64_t t0 = _nowNs(), t1, n = 0;                                              \
+        do {                                                                            \
+            for (uint32_t j=0; j<1024; ++j, ++n) { expr; }                              \
+            t1 = _nowNs();                                                              \
+        } while ((t1 - t0) < BENCH_NS_MIN);                                             \
+        printf("%-10s %3u blocked  %8.1f ns/pass\n", label, (unsigned) (n_blocked),     \
+               (double) (t1 - t0) / (double) n);                                        \
+    } while(0)
+
+
+int main(void) {
+    static const uint32_t n_blocked[] = { 0, 1, 2, 4, 8, 15 };
+    eex_thread_cb_t *tcb;
+
+    (void) eexThreadCreate(thread_running, NULL, BENCH_RUNNING_PRI, NULL);
+    for (uint32_t i=0; i<BENCH_N_BLOCKED; ++i) {
+        (void) eexThreadCreate(thread_sleep,     NULL, BENCH_SLEEP_PRI + i, NULL);
+        (void) eexThreadCreate(thread_sema_wait, NULL, BENCH_SEMA_PRI + i,  NULL);
+    }
+    for (uint32_t i=0; i<((2 * BENCH_N_BLOCKED) + 1); ++i) {    // dispatch the threads to block, then leave the lowest running
+        tcb = eexScheduler(false);
+        tcb->fn_thread(tcb->arg);
+    }
+
+    for (uint32_t t=0; t<(sizeof(n_blocked) / sizeof(n_blocked[0])); ++t) {
+        _blocked(BENCH_SLEEP_PRI, n_blocked[t]);
+        BENCH_RUN("sleeping",  n_blocked[t], (void) eexScheduler(false));
+        _blocked(BENCH_SEMA_PRI, n_blocked[t]);
+        BENCH_RUN("semaphore", n_blocked[t], (void) eexScheduler(false));
+    }
+    return (0);
+}
@@ -0,0 +1,158 @@
+/*******************************************************************************
+
+    bench_eex_workers.c - Worker pool job throughput on the console build.
+
+    Reports jobs per second for rounds of jobs posted from an interrupt
+    handler and run before returning to the interrupted thread. A round is
+    either one post to each of BENCH_N_TYPES threads, a thread per job type,
+    or BENCH_N_TYPES submits to a worker pool, run with several batch sizes.
+
+    The platform functions are provided here so the kernel can be driven
+    without eexKernelStart. The threads of the other measurement are
+    suspended.
+
+    gcc -std=gnu99 -O2 -D__CONSOLE__ -DNDEBUG -Ihdr bench/bench_eex_workers.c src/eex_os.c src/eex_work.c -o bench_eex_workers
+
+    COPYRIGHT NOTICE: (c) ee-quipment.com
+    All Rights Reserved
+
+ ******************************************************************************/
+
+
+#include  <stdint.h>
+#include  <stdio.h>
+#include  <time.h>
+#include  "eex_os.h"
+#include  "eex_work.h"
+
+#define STATIC static
+
+#define BENCH_NS_MIN        200000000   // run each measurement for at least 200 ms
+#define BENCH_RUNNING_PRI   1           // the thread that is interrupted
+#define BENCH_N_TYPES       8           // job types, and jobs per round
+#define BENCH_THREAD_PRI    2           // job threads are BENCH_THREAD_PRI to BENCH_THREAD_PRI + BENCH_N_TYPES - 1
+#define BENCH_WORKER_PRI    (BENCH_THREAD_PRI + BENCH_N_TYPES)
+#define BENCH_N_WORKERS     2
+
+EEX_WORKERS_NEW(bench_pool, 2, 16);
+
+static eex_sema_mutex_cb_t g_sema_storage[BENCH_N_TYPES];    // one per job thread
+
+static volatile uint32_t g_in_interrupt = 0;
+static volatile uint32_t g_n_run        = 0;
+volatile uint32_t        g_timer_ms     = 0;
+
+
+// Console platform, interrupt context is simulated with g_in_interrupt
+uint32_t eexCPUAtomic32CAS(uint32_t volatile *addr, uint32_t expected, uint32_t store) {
+    return (__sync_bool_compare_and_swap(addr, expected, store) ? 0 : 1);
+}
+uint32_t eexCPUAtomic64CAS(uint64_t volatile *addr, uint64_t expected, uint64_t store) {
+    return (__sync_bool_compare_and_swap(addr, expected, store) ? 0 : 1);
+}
+void *   eexCPUAtomicPtrCAS(void * volatile *addr, void * expected, void * store) {
+    return (__sync_bool_compare_and_swap(addr, expected, store) ? NULL : (void *) 1);
+}
+uint32_t eexCPUCLZ(uint32_t x)              { return (x ? __builtin_clz(x) : 32); }
+uint32_t eexInInterrupt()                   { return (g_in_interrupt); }
+void     eexSchedulerPend(void)             { }
+uint32_t eexKernelTime(uint32_t *us)        { if (us) { *us = 0; } return (g_timer_ms); }
+
+
+static uint64_t _nowNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t) ts.tv_sec * 1000000000u + (uint64_t) ts.tv_nsec);
+}
+
+static void job(void * const argument) {
+    ++g_n_run;
+}
+
+static void thread_running(void * const argument) {
+    eexThreadEntry();
+}
+
+// one thread per job type, argument is the type
+static void thread_job(void * const argument) {
+    eexThreadEntry();
+    for (;;) {
+        eexPend(NULL, NULL, eexWaitForever, &g_sema_storage[(uint32_t) (uintptr_t) argument]);
+        job(argument);
+    }
+}
+
+// run the scheduler and the threads it dispatches until it returns to the interrupted thread
+static void _runUntilIdle(void) {
+    eex_thread_cb_t *tcb;
+
+    tcb = eexScheduler(true);
+    while (tcb) {
+        tcb->fn_thread(tcb->arg);
+        tcb = eexScheduler(false);
+    }
+}
+
+static void roundThreads(void) {
+    eex_status_t  rtn_status;
+
+    g_in_interrupt = 1;
+    for (uint32_t i=0; i<BENCH_N_TYPES; ++i) { eexPost(&rtn_status, 0, 0, &g_sema_storage[i]); }
+    g_in_interrupt = 0;
+    _runUntilIdle();
+}
+
+static void roundWorkers(void) {
+    eex_status_t  rtn_status;
+
+    g_in_interrupt = 1;
+    for (uint32_t i=0; i<BENCH_N_TYPES; ++i) { eexWorkersSubmit(&rtn_status, bench_pool, i & 1, job, NULL); }
+    g_in_interrupt = 0;
+    _runUntilIdle();
+}
+
+// Resume the threads in [first, first + n), suspend the other job threads and workers
+static void _measuring(uint32_t first, uint32_t n) {
+    for (uint32_t pri=BENCH_THREAD_PRI; pri<(BENCH_WORKER_PRI + BENCH_N_WORKERS); ++pri) {
+        if ((pri >= first) && (pri < (first + n))) { eexThreadResume(pri); }
+        else                                       { eexThreadSuspend(pri); }
+    }
+}
+
+#define BENCH_RUN(label, batch, expr)                                                   \
+    do {                                                                                \
+        uint64_t t0 = _nowNs(), t1, n = 0;                                              \
+        g_n_run = 0;                                                                    \
+        do {                                                                            \
+            for (uint32_t j=0; j<1024; ++j, n+=BENCH_N_TYPES) { expr; }                 \
+            t1 = _nowNs();                                                              \
+        } while ((t1 - t0) < BENCH_NS_MIN);                                             \
+        printf("%-18s batch %2u  %12.0f jobs/s  %s\n", label, (unsigned) (batch),      \
+               (double) n * 1e9 / (double) (t1 - t0), (g_n_run == n) ? "" : "(jobs lost)"); \
+    } while(0)
+
+
+int main(void) {
+    static const uint32_t batch[] = { 1, 2, 4, 8 };
+    eex_thread_cb_t *tcb;
+
+    for (uint32_t i=0; i<BENCH_N_TYPES; ++i) {
+        g_sema_storage[i] = (eex_sema_mutex_cb_t) { { 'SEMA', 0, 0 }, { 0, 0 }, 1, 0 };
+        (void) eexThreadCreate(thread_job, (void *) (uintptr_t) i, BENCH_THREAD_PRI + i, NULL);
+    }
+    (void) eexWorkersCreate(bench_pool, BENCH_WORKER_PRI, BENCH_N_WORKERS, 1, NULL);
+    (void) eexThreadCreate(thread_running, NULL, BENCH_RUNNING_PRI, NULL);
+    for (uint32_t i=0; i<(BENCH_N_TYPES + BENCH_N_WORKERS + 1); ++i) {   // dispatch the waiters, then leave the lowest running
+        tcb = eexScheduler(false);
+        tcb->fn_thread(tcb->arg);
+    }
+
+    _measuring(BENCH_THREAD_PRI, BENCH_N_TYPES);
+    BENCH_RUN("thread per job", 1, roundThreads());
+    _measuring(BENCH_WORKER_PRI, BENCH_N_WORKERS);
+    for (uint32_t b=0; b<(sizeof(batch) / sizeof(batch[0])); ++b) {
+        ((eex_workers_cb_t *) bench_pool)->batch = batch[b];
+        BENCH_RUN("worker pool", batch[b], roundWorkers());
+    }
+    return (0);
+}
@@ -0,0 +1,115 @@
+/*******************************************************************************
+
+    eex_ao.h - Real time executive active objects.
+
+    COPYRIGHT NOTICE: (c) ee-quipment.com
+    All Rights Reserved
+
+ ******************************************************************************/
+
+
+#ifndef _eex_ao_H_
+#define _eex_ao_H_
+
+#include <stdint.h>
+#include "eex_os.h"
+
+
+// Static allocator for an active object and its event queue. n_events must be a power of 2.
+// 'name' must not be in quotes. i.e. EEX_AO_NEW(myObject, 8) not EEX_AO_NEW("myObject", 8)
+#define EEX_AO_NEW(name, n_events)
+
+// Static allocator for a pool of n_evts events of evt_size bytes each, including the
+// eex_ao_event_t header. n_evts must be a power of 2. i.e. EEX_AO_POOL_NEW(myPool, sizeof(my_event_t), 16)
+#define EEX_AO_POOL_NEW(name, evt_size, n_evts)
+
+
+// Every event starts with this header. An event taken from a pool is returned to it when the
+// last queue it was posted to has dispatched it. A static event (pool NULL) is never recycled.
+typedef struct {
+    uint32_t                  sig;       // event signal, what happened
+    void                    *pool;       // pool the event belongs to, NULL if static
+    volatile uint32_t        refs;       // queues the event is posted to and not yet dispatched
+} eex_ao_event_t;
+
+typedef void (*eex_ao_dispatch_fn_t) (void * const argument, eex_ao_event_t *event);
+
+typedef struct {
+    void * volatile           ptr;       // event
+    volatile uint32_t         seq;       // free for the lap starting at seq, holds its event at seq + 1
+} eex_ao_slot_t;
+
+typedef struct {
+    eex_ao_slot_t          *slots;       // ring of n slots
+    uint32_t                 mask;       // n - 1
+    volatile uint32_t        head;       // next event to take, consumers claim it with a CAS
+    volatile uint32_t        tail;       // next free slot, producers claim it with a CAS
+    uint32_t            n_dropped;       // events posted to a full queue
+} eex_ao_queue_t;
+
+typedef struct {
+    eex_ao_queue_t          queue;       // event queue
+    eex_ao_dispatch_fn_t dispatch;       // runs one event to completion
+    void                     *arg;       // dispatch function argument
+    uint32_t                  tid;       // active object thread
+} eex_ao_cb_t;
+
+typedef struct {
+    eex_ao_queue_t           free;       // recycled events
+    uint8_t                  *mem;       // event storage
+    uint32_t             evt_size;       // event size in bytes, a multiple of the pointer size
+    uint32_t               n_evts;       // number of events in the pool
+    volatile uint32_t       fresh;       // events taken from the never-allocated end of the pool
+} eex_ao_pool_t;
+
+
+/*
+ * An active object is an event-driven state machine with a thread of its
+ * own. Events are posted to its queue by pointer, and its thread dispatches
+ * them one at a time, each to completion before the next is taken. The
+ * object keeps its state in the structure passed to the dispatch function,
+ * nothing is kept in the thread.
+ *
+ * Events may be posted from threads, interrupt handlers and dispatch
+ * functions. A post never blocks. An object readied by a post from a
+ * dispatch function runs when that dispatch completes if it has a higher
+ * priority. An object readied by a post from an ordinary thread runs at
+ * that thread's next blocking call, follow the post with eexYield() to run
+ * it at once. If the queue is full the event is dropped, recycled if it has
+ * no other references, and eexStatusKOErr is returned.
+ *
+ * A posted event belongs to the queues it was posted to and must not be
+ * changed. A dispatch function may post the event it was given on to other
+ * objects, it is recycled after the last one dispatches it. eexAOPublish
+ * posts one event to several objects.
+ */
+
+eex_status_t  eexAOCreate(void *ao, eex_ao_dispatch_fn_t dispatch, void *argument, uint32_t priority, const char *name);
+eex_status_t  eexAOPost(void *ao, void *event);
+eex_status_t  eexAOPublish(void *event, void * const *aos, uint32_t n_aos);
+
+// Take an event from a pool and set its signal. Returns NULL if the pool is empty.
+// May be called from threads, interrupt handlers and dispatch functions.
+void *        eexAOEventNew(void *pool, uint32_t sig);
+
+
+
+#undef  EEX_AO_NEW
+#define EEX_AO_NEW(name, n_events)                                                              \
+_Static_assert(((n_events) > 1) && (((n_events) & ((n_events) - 1)) == 0), "n_events must be a power of 2"); \
+static eex_ao_slot_t name##_slots[n_events];                                                    \
+static eex_ao_cb_t name##_storage = { { name##_slots, (n_events) - 1, 0, 0, 0 }, NULL, NULL, 0 }; \
+STATIC void * const name = (void *) &name##_storage
+
+#undef  EEX_AO_POOL_NEW
+#define EEX_AO_POOL_NEW(name, evt_size, n_evts)                                                 \
+_Static_assert(((n_evts) > 1) && (((n_evts) & ((n_evts) - 1)) == 0), "n_evts must be a power of 2"); \
+_Static_assert((evt_size) >= sizeof(eex_ao_event_t), "evt_size must include the event header"); \
+static void *        name##_mem[(n_evts) * (((evt_size) + sizeof(void *) - 1) / sizeof(void *))]; \
+static eex_ao_slot_t name##_slots[n_evts];                                                      \
+static eex_ao_pool_t name##_storage = { { name##_slots, (n_evts) - 1, 0, 0, 0 }, (uint8_t *) name##_mem, \
+                                        (((evt_size) + sizeof(void *) - 1) / sizeof(void *)) * sizeof(void *), (n_evts), 0 }; \
+STATIC void * const name = (void *) &name##_storage
+
+
+#endif  /* _eex_ao_H_ */
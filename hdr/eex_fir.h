@@ -0,0 +1,81 @@
+/*******************************************************************************
+
+    eex_fir.h - Delay line and FIR filter kernels.
+
+    COPYRIGHT NOTICE: (c) ee-quipment.com
+    All Rights Reserved
+
+ ******************************************************************************/
+
+
+#ifndef _eex_fir_H_
+#define _eex_fir_H_
+
+#include <stdint.h>
+#include "eex_os.h"
+
+
+// Static allocator for a delay line.
+// 'name' must not be in quotes. i.e. EEX_DELAY_LINE_NEW(myDL, int16_t, 32) not EEX_DELAY_LINE_NEW("myDL", int16_t, 32)
+#define EEX_DELAY_LINE_NEW(name, type, n_taps)
+
+
+/*
+ * A delay line holds the most recent n_taps samples. New samples are added at
+ * tap zero and the oldest sample is at tap (n_taps - 1).
+ *
+ * The storage is mirrored: every sample is written twice, n_taps elements apart,
+ * so the newest n_taps samples are always contiguous in memory, starting with
+ * tap zero. The filter kernels read the taps as a plain array with no modulo
+ * indexing, at the cost of one extra store per sample and twice the memory.
+ *
+ * A delay line has a single writer. Readers in other contexts may see a window
+ * that is one sample old.
+ */
+typedef struct {
+    uint16_t                  n_taps;       // number of taps
+    uint16_t                   index;       // element index of tap zero, 0..n_taps-1
+    uint16_t               type_size;       // size of a sample in bytes
+    uint8_t                     *mem;       // 2 * n_taps samples
+} eex_dl_cb_t;
+
+void      eexDLUpdate(void *dl, const void *sample);    // insert sample at tap zero
+void *    eexDLGetTap(void *dl, uint32_t tap);          // return pointer to the sample at tap
+void *    eexDLTaps(void *dl);                          // return pointer to n_taps contiguous samples, tap zero first
+uint32_t  eexDLNTaps(void *dl);                         // return number of taps in delay line
+
+
+/*
+ * FIR filter kernels. Return sum(h[k] * x[k]) for k = 0..n-1.
+ *
+ * x is normally the tap array of a delay line, so h[0] multiplies the newest
+ * sample. Neither array needs to be aligned. Integer kernels accumulate in 64
+ * bits and return the unscaled sum; shift the result to the output format
+ * (i.e. >> 15 for Q15 coefficients).
+ *
+ * The SIMD paths are chosen at compile time: SSE2 or AVX2 on the console build,
+ * and the DSP extension on Cortex M4. On x86 the int16 kernel sums products in
+ * pairs in 32 bits, so a pair where both x and h are -32768 overflows.
+ * The float kernels sum in a different order than the generic C code, so the
+ * results may differ in the last bits.
+ */
+int64_t   eexFirDotI16(const int16_t *x, const int16_t *h, uint32_t n);
+int64_t   eexFirDotI32(const int32_t *x, const int32_t *h, uint32_t n);
+float     eexFirDotF32(const float   *x, const float   *h, uint32_t n);
+
+// Insert sample into the delay line and return the filter output. h has n_taps coefficients.
+int64_t   eexFirI16(void *dl, const int16_t *h, int16_t sample);
+int64_t   eexFirI32(void *dl, const int32_t *h, int32_t sample);
+float     eexFirF32(void *dl, const float   *h, float   sample);
+
+
+
+
+#undef  EEX_DELAY_LINE_NEW
+#define EEX_DELAY_LINE_NEW(name, type, n_taps)                                                  \
+static type        name##_mem[2 * (n_taps)];                                                    \
+static eex_dl_cb_t name##_storage = { n_taps, 0, sizeof(type), (uint8_t *) name##_mem };       \
+STATIC void * const name = (void *) &name##_storage
+
+
+#endif  /* _eex_fir_H_ */
@@ -49,6 +49,28 @@ extern "C" {
 #define EEX_CFG_TIMER_THREAD_PRIORITY       0       // Software timer(s) priority 1-32 (0 = no software timers)
 #endif
 
+// Cortex-M has no 64 bit CAS, with EEX_CFG_WIDE_COUNT 1 interrupts are disabled around
+// every semaphore, mutex, rwlock, latch and pool CAS, on the M3/M4 as well as the M0
+#ifndef EEX_CFG_WIDE_COUNT
+#define EEX_CFG_WIDE_COUNT                  0       // 1 = 32 bit semaphore and latch counts, uses a 64 bit CAS
+#endif
+
+#ifndef EEX_CFG_PARTITIONS
+#define EEX_CFG_PARTITIONS                  4       // time partitions 1 to n, partition 0 is the unpartitioned threads
+#endif
+
+#ifndef EEX_CFG_CRIT_LEVELS
+#define EEX_CFG_CRIT_LEVELS                 2       // thread criticality levels 0 to n-1 (1 = no mode switching)
+#endif
+
+#ifndef EEX_CFG_IDLE_JOBS
+#define EEX_CFG_IDLE_JOBS                   8       // background job queue size, a power of 2
+#endif
+
+#ifndef EEX_CFG_DEFER_THREAD_PRIORITY
+#define EEX_CFG_DEFER_THREAD_PRIORITY       0       // Deferred interrupt work priority 1-32 (0 = no deferred work thread)
+#endif
+
 /* System Configuration */
 #ifndef __CORTEX_M
 #define __CORTEX_M                          0       // Cortex M0
@@ -106,10 +128,14 @@ typedef enum  {
     eexStatusTimerListBusy      = 0x0101,     // timer list mutex is held
     eexStatusTimerNotFound      = 0x0102,     // timer not found in list
     eexStatusKOErr              = 0x0201,     // kernel object not available
-    eexStatusKOSemMutOverflow   = 0x0202,     // the count on a semaphore or mutex overflowed a 16 bit value
+    eexStatusKOSemMutOverflow   = 0x0202,     // the count on a semaphore or mutex overflowed a 16 bit value (32 bit if EEX_CFG_WIDE_COUNT)
+    eexStatusKOPoolPtrErr       = 0x0203,     // freed pointer is not an allocated block of the pool
+    eexStatusKOStreamFull       = 0x0204,     // stream buffer cannot hold the committed bytes
+    eexStatusKOObufPtrErr       = 0x0205,     // freed pointer is in the I/O buffer but is not an allocated block
     eexStatusThreadReady        = 0x0401,     // event released a pending thread, concat thread priority = 0x04pp
     eexStatusThreadBlocked      = 0x0801,     // thread pending on event
     eexStatusThreadTimeout      = 0x0802,     // thread timeout occurred.
+    eexStatusThreadAborted      = 0x0803,     // thread wait ended by eexThreadAbortWait
     eexStatusEventNotReady      = 0x1001,     // resource not ready, thread not queued
     eexStatusBlockErr           = 0x1002,     // interrupt handler and thread 0 cannot block
     eexStatusIRQNotCallable     = 0x2002,     // cannot be called from an interrupt handler
@@ -133,6 +159,17 @@ typedef void (*eex_thread_fn_t) (void *argument);
 // return     status code that indicates the execution status of the function.
 eex_status_t  eexThreadCreate(eex_thread_fn_t fn_thread, void *argument, uint32_t priority, const char *name);
 
+// Entry point of a fast handler. status and val are the result of its pend.
+typedef void (*eex_handler_fn_t) (void *argument, eex_status_t status, uint32_t val);
+
+// Create a fast handler, a run-to-completion reaction to a kernel object. It takes a priority like
+// a thread and waits on kobj forever. When the pend succeeds the scheduler calls fn to completion,
+// ordered with threads by priority, and the handler waits again. No thread frame is built and there
+// is no continuation, so fn is written like an interrupt handler: it may post but must not block.
+// kobj       semaphore, signal (not broadcast), pool or stream, whose pend consumes what it waits for
+// val        pend parameter, e.g. the signal bits or stream bytes to wait for
+eex_status_t  eexHandlerCreate(eex_handler_fn_t fn, void *argument, uint32_t priority, void *kobj, uint32_t val, const char *name);
+
 // Start the RTOS Kernel scheduler.
 // This function never returns.
 void          eexKernelStart(void);
@@ -145,6 +182,102 @@ uint32_t      eexKernelTime(uint32_t *us);
 // Return the thread ID of the current running thread. The thread ID is also the thread priority.
 uint32_t      eexThreadID(void);
 
+// Stop dispatching a thread until it is resumed. A ready or waiting thread is not run, and its
+// timeouts are not acted on until it is resumed. A running or interrupted thread is suspended
+// when it next blocks. May be called from a thread or an interrupt handler.
+void          eexThreadSuspend(uint32_t tid);
+
+// Resume a suspended thread. From an interrupt handler, a ready thread of higher priority than the
+// interrupted thread runs when the handler returns. From a thread it runs at the caller's next
+// blocking call, follow the resume with eexYield() to run it at once.
+void          eexThreadResume(uint32_t tid);
+
+// End the current wait of a thread with eexStatusThreadAborted, as if it had timed out.
+// If the thread is not waiting the abort is discarded by its next pend or post. From a thread the
+// wait is ended at the caller's next blocking call, as for eexThreadResume.
+void          eexThreadAbortWait(uint32_t tid);
+
+// Make a thread periodic. Releases are at kernel times phase_ms + n * period_ms, so threads with
+// different phases are staggered and the release times never drift. The first release is the
+// next one after the call. A period of 0 makes the thread non-periodic. phase_ms < period_ms.
+void          eexThreadPeriodSet(uint32_t tid, uint32_t period_ms, uint32_t phase_ms);
+
+// Total number of releases a periodic thread has missed because it was still running.
+uint32_t      eexThreadPeriodMissed(uint32_t tid);
+
+// Limit a thread to budget_us of cpu time in every period_ms. When the budget is used up
+// the thread is not dispatched until it is replenished at the next period boundary.
+// A thread can't be stopped while it runs, the budget is checked when it blocks or yields
+// and an overrun is repaid from the next period. A budget of 0 removes the limit.
+void          eexThreadBudgetSet(uint32_t tid, uint32_t budget_us, uint32_t period_ms);
+
+// Set the criticality level of a thread, 0 (the default) to EEX_CFG_CRIT_LEVELS-1. A thread with
+// a level above 0 and a nonzero budget_us is monitored: if one of its jobs, the cpu time between
+// blocking points, overruns budget_us the kernel switches to the thread's level as its mode and
+// threads of a lower level are not dispatched. The kernel returns to mode 0 when it would idle.
+void          eexThreadCriticalitySet(uint32_t tid, uint32_t level, uint32_t budget_us);
+
+// Set the preemption threshold of a thread, from its priority (the default) to EEX_CFG_THREADS_MAX.
+// Once a thread is dispatched only threads with a priority above its threshold can preempt it,
+// until it blocks. Threads that never preempt each other can't be on the stack together.
+void          eexThreadThresholdSet(uint32_t tid, uint32_t threshold);
+
+// Time partitions. A major frame schedule gives each partition windows of cpu time, and in its
+// windows a partition schedules its threads by priority as usual. A window of partition 0 runs only
+// the unpartitioned threads. Threads can't be stopped mid-run on every port, so a window switch
+// that happens late is charged to the outgoing partition as an overrun.
+typedef struct {
+    uint32_t      partition;        // partition that runs in the window, 0 for the unpartitioned threads only
+    uint32_t      duration_ms;      // window length
+} eex_partition_window_t;
+
+typedef struct {
+    uint32_t      budget_ms;        // window time per major frame
+    uint32_t      n_windows;        // windows started
+    uint32_t      n_skipped;        // windows that had passed before the switch to them
+    uint32_t      n_overrun;        // windows that ended late
+    uint32_t      overrun_ms;       // total time the windows ended late
+} eex_partition_stats_t;
+
+// Put a thread in a time partition, 1 to EEX_CFG_PARTITIONS. A partitioned thread is only dispatched
+// in its partition's windows of the schedule. Partition 0 (the default) threads run in every window.
+void          eexThreadPartitionSet(uint32_t tid, uint32_t partition);
+
+// Start a major frame schedule of n_windows windows, repeated for as long as the kernel runs. The
+// first window starts now. The windows are not copied and must stay valid. NULL or 0 windows stops
+// partitioning, and every thread may be dispatched. Called from a thread, the schedule takes
+// effect at the caller's next blocking call.
+void          eexPartitionSchedule(const eex_partition_window_t *windows, uint32_t n_windows);
+
+// Copy a partition's window time per major frame and its overruns to *stats.
+void          eexPartitionStats(uint32_t partition, eex_partition_stats_t *stats);
+
+// Time-triggered table. Each entry releases a thread at offset_ms into the hyperperiod, and the
+// table repeats every hyperperiod_ms from the call. Entries are sorted by offset, offsets are less
+// than the hyperperiod and a thread may have several entries. Released threads are dispatched by
+// priority, and threads that don't wait on the table run in the slack. NULL or 0 entries stops it.
+typedef struct {
+    uint32_t      offset_ms;        // release time from the start of the hyperperiod
+    uint32_t      tid;              // thread released, waiting in eexTableWait
+} eex_table_release_t;
+
+typedef struct {
+    uint32_t      n_releases;       // releases of the thread
+    uint32_t      n_missed;         // releases dropped because the previous release hadn't been taken
+    uint32_t      jitter_last_us;   // dispatch time after the release time, last release
+    uint32_t      jitter_max_us;    // largest jitter
+} eex_table_stats_t;
+
+void          eexTableSchedule(const eex_table_release_t *table, uint32_t n_releases, uint32_t hyperperiod_ms);
+
+// Copy a thread's time-triggered release counts and jitter to *stats.
+void          eexTableStats(uint32_t tid, eex_table_stats_t *stats);
+
+// return     the current criticality mode
+// n_switch   if not NULL, the number of switches to a higher mode since the kernel started
+// n_restore  if not NULL, the number of returns to mode 0
+uint32_t      eexKernelMode(uint32_t *n_switch, uint32_t *n_restore);
+
 // Called when there are no ready threads to dispatch.
 // sleep_for_ms milliseconds until next thread timeout
 //              or negative if a thread has already timed out
@@ -152,15 +285,58 @@ uint32_t      eexThreadID(void);
 // return       milliseconds spent in function if it stops the CPU clock (Systick source), return 0 otherwise
 uint32_t      eexIdleHook(int32_t sleep_for_ms);
 
+// Background jobs run in idle time. When no thread can run the scheduler runs the oldest job to
+// completion if wcet_us fits before the next thread timeout, then searches again, so a thread
+// readied by the job or an interrupt is dispatched before the next job. A job that doesn't fit
+// waits for a longer idle period. Jobs may be submitted from threads and interrupt handlers and
+// must not block. Returns eexStatusKOErr if the queue (EEX_CFG_IDLE_JOBS) is full.
+typedef void (*eex_job_fn_t) (void * const argument);
+
+eex_status_t  eexIdleJobSubmit(eex_job_fn_t fn, void *argument, uint32_t wcet_us);
+
+// Deferred interrupt work. An interrupt handler hands the rest of its work to the deferred work
+// thread (EEX_CFG_DEFER_THREAD_PRIORITY) by pushing an item allocated with EEX_DEFER_NEW onto a
+// lock-free list. The thread runs the item's function in the order items were deferred. An item
+// that is already queued is not pushed again and false is returned, its function hasn't started
+// and will see the new interrupt's work. An item must only be deferred from one interrupt priority.
+bool          eexDefer(void *item);
+
 
 // Function-like macros. These are redefined as macros below.
 void  eexThreadEntry(void);               // must be the first statment in every thread.
+void  eexThreadExit(uint32_t exit_code, bool free_slot);   // finish the calling thread, it is never dispatched again
+void  eexThreadJoin(eex_status_t *p_rtn_status, uint32_t *p_rtn_val, uint32_t timeout, uint32_t tid);
 
 void  eexPend(eex_status_t *p_rtn_status, uint32_t *p_rtn_val, uint32_t timeout, void *kobj);
 void  eexPost(eex_status_t *p_rtn_status, uint32_t val,        uint32_t timeout, void *kobj);
 
 void  eexPendSignal(eex_status_t *p_rtn_status, uint32_t *p_rtn_val, uint32_t timeout, uint32_t signal_mask, void *kobj);
 void  eexPostSignal(eex_status_t *p_rtn_status, uint32_t  signal,    void *kobj);
+void  eexSignalClear(void *kobj, uint32_t signal_mask);   // clear bits of a broadcast signal, may be called from interrupt handlers
+
+void  eexPendStream(eex_status_t *p_rtn_status, uint32_t *p_rtn_val, uint32_t timeout, uint32_t n_bytes, void *kobj);
+void  eexPendObuf(eex_status_t *p_rtn_status, uint32_t *p_rtn_val, uint32_t timeout, uint32_t n_bytes, void *kobj);
+
+void  eexCondWait(eex_status_t *p_rtn_status, uint32_t timeout, void *cond, void *mutex);
+void  eexCondSignal(eex_status_t *p_rtn_status, void *cond);     // wake the highest priority waiter
+void  eexCondBroadcast(eex_status_t *p_rtn_status, void *cond);  // wake all waiters
+
+void  eexRWLockRead(eex_status_t *p_rtn_status, uint32_t timeout, void *rwlock);
+void  eexRWLockReadRelease(eex_status_t *p_rtn_status, void *rwlock);
+void  eexRWLockWrite(eex_status_t *p_rtn_status, uint32_t timeout, void *rwlock);
+void  eexRWLockWriteRelease(eex_status_t *p_rtn_status, void *rwlock);
+
+void  eexBarrierWait(eex_status_t *p_rtn_status, uint32_t timeout, void *barrier);
+
+void  eexNotify(eex_status_t *p_rtn_status, uint32_t tid, uint32_t action, uint32_t value);
+void  eexNotifyWait(eex_status_t *p_rtn_status, uint32_t *p_rtn_val, uint32_t timeout, uint32_t clear_mask);
+
+void  eexLatchWait(eex_status_t *p_rtn_status, uint32_t timeout, void *latch);
+void  eexLatchCountDown(eex_status_t *p_rtn_status, uint32_t n, void *latch);
+
+void  eexThreadPeriodWait(eex_status_t *p_rtn_status, uint32_t *p_rtn_missed);  // wait for the next release of a periodic thread
+void  eexTableWait(eex_status_t *p_rtn_status, uint32_t *p_rtn_jitter_us);      // wait for the next release in the time-triggered table
+void  eexYield(void);                     // run the scheduler, the thread continues when it is the highest priority ready thread
 
 void  eexDelay(uint32_t delay_ms);        // max delay is eexWaitMax
 void  eexDelayUntil(uint32_t kernel_ms);  // max kernel_ms is eexWaitMax from current time. rollover is allowed.
@@ -168,9 +344,85 @@ void  eexDelayUntil(uint32_t kernel_ms);  // max kernel_ms is eexWaitMax from cu
 
 // Static allocators for synchronization primitives. More completely defined in implementation section below.
 // name must not be in quotes. i.e. EEX_MUTEX_NEW(myMutex) not EEX_MUTEX_NEW("myMutex")
+// A broadcast signal is not cleared by a pend, every waiter whose mask matches is released.
+// Its bits stay set until they are cleared with eexSignalClear, a clear after the post doesn't
+// hold back the waiters it released.
+// A pool is pended to allocate a block, the block address is returned in *p_rtn_val.
+// The block is freed by posting its address back to the pool, a block that isn't allocated is not freed.
 #define EEX_SEMAPHORE_NEW(name, maxval, ival)
 #define EEX_MUTEX_NEW(name)
 #define EEX_SIGNAL_NEW(name)
+#define EEX_SIGNAL_BROADCAST_NEW(name)
+#define EEX_POOL_NEW(name, blk_size, n_blks)
+#define EEX_STREAM_NEW(name, size, trigger)
+#define EEX_OBUF_NEW(name, size)
+#define EEX_COND_NEW(name)
+#define EEX_RWLOCK_NEW(name)
+#define EEX_BARRIER_NEW(name, parties)
+#define EEX_LATCH_NEW(name, count)
+#define EEX_DEFER_NEW(name, fn, argument)
+
+// Stream buffer access. A single producer and a single consumer move bytes with these
+// non-blocking functions. Spans are contiguous runs suitable for DMA or memcpy.
+// The producer commits bytes written into a span, and wakes the consumer, by posting
+// the byte count to the stream (eexPost). eexStreamWrite commits but does not wake,
+// follow it with eexPost(p_rtn_status, 0, 0, stream).
+// The consumer pends until at least n_bytes are available (0 = the trigger level), the
+// number of bytes available is returned in *p_rtn_val.
+uint8_t *     eexStreamWriteSpan(void *stream, uint32_t *p_len);                   // contiguous free space, *p_len set to its length
+uint32_t      eexStreamWrite(void *stream, const void *src, uint32_t n);          // returns number of bytes copied in
+const uint8_t * eexStreamReadSpan(void *stream, uint32_t *p_len);                 // contiguous data, *p_len set to its length
+void          eexStreamReadRelease(void *stream, uint32_t n);                     // discard n bytes after reading a span
+uint32_t      eexStreamRead(void *stream, void *dst, uint32_t n);                 // returns number of bytes copied out
+void          eexStreamTriggerSet(void *stream, uint32_t trigger);                // default wake-up level of eexPendStream
+
+// Ordered I/O buffer. A single producer pends for n_bytes of contiguous memory, the block
+// address is returned in *p_rtn_val. Blocks are freed from any context, including interrupt
+// handlers, by posting their address to the buffer. Blocks should be freed in the order they
+// were allocated, memory is not reclaimed until the oldest allocated block is freed. Posting
+// an address that is not in the buffer is ignored and returns eexStatusOK.
+typedef struct {
+    uint32_t      free;             // bytes currently free
+    uint32_t      min_free;         // low watermark of free bytes
+    uint32_t      n_failed;         // allocations that returned without a block (non-blocking or timed out)
+} eex_obuf_stats_t;
+
+void          eexObufStats(void *obuf, eex_obuf_stats_t *p_stats);
+
+// Condition variable. eexCondWait must be called holding mutex. It releases the mutex and
+// blocks until the condition is signaled, then re-acquires the mutex before returning.
+// If the wait times out (eexStatusThreadTimeout, or eexStatusEventNotReady if timeout is 0)
+// it returns WITHOUT the mutex. As with any condition variable, recheck the condition after waking.
+// Signal and broadcast do not need the mutex and may be called from interrupt handlers.
+
+// Reader-writer lock. Any number of readers, or one writer, may hold the lock. Writers are
+// preferred: once a writer is waiting, new readers wait until it has acquired and released
+// the lock. Uncontended read acquire and release is a single CAS and does not run the scheduler.
+// Readers may acquire (timeout 0) and release from interrupt handlers, writers must be threads.
+
+// Barrier. Each of the parties threads waits until all of them have arrived, the last arrival
+// releases them all. A wait that times out withdraws the thread's arrival. A wait with a
+// timeout of 0 succeeds only for the last arrival, otherwise it returns eexStatusEventNotReady
+// without arriving. Barriers may only be used by threads.
+
+// Thread notification. Every thread has a 32 bit notification value that is updated by
+// eexNotify, from a thread or an interrupt handler, and a pending flag that is set by every
+// notify. eexNotifyWait waits for the calling thread's pending flag, returns the value in
+// *p_rtn_val and clears the bits set in clear_mask. No kernel object is needed.
+//   EEX_NOTIFY_NO_VALUE    wake only, the value is unchanged
+//   EEX_NOTIFY_SET_BITS    OR value into the notification value
+//   EEX_NOTIFY_INCREMENT   add one to the notification value, value is ignored
+//   EEX_NOTIFY_OVERWRITE   replace the notification value
+
+// Thread completion. A thread calls eexThreadExit to finish, it is removed from all thread
+// lists and is never dispatched again. Every thread that is, or later, waiting in eexThreadJoin
+// for it is released with the exit code in *p_rtn_val. If free_slot is true the thread's
+// priority may be reused by eexThreadCreate, which also resets the completion, so joiners
+// should be released before a slot is reused. Exit and join may only be called by threads.
+
+// Countdown latch. Waiters block until the count reaches zero, then all are released and the
+// latch stays open until it is reset. Counting down may be done from interrupt handlers.
+void          eexLatchReset(void *latch, uint32_t count);
 
 /*****************************************************************************/
 
@@ -197,16 +449,28 @@ typedef volatile eex_bm_t  eex_thread_list_t;
 
 
 // Event types
-typedef uint32_t     eex_kobj_desc_t;       // one of 'NONE', 'DLAY', 'MAIL', 'MESG', 'MUTX', 'POOL', 'SEMA', 'SIGL', 'TIMR'
+typedef uint32_t     eex_kobj_desc_t;       // one of 'NONE', 'BARR', 'COND', 'DEFR', 'DLAY', 'JOIN', 'LTCH', 'MAIL', 'MESG', 'MUTX', 'NTFY', 'OBUF', 'PERD', 'POOL', 'RWLK', 'SEMA', 'SIGL', 'STRM', 'TIMR', 'TTRG', 'YILD'
+
+// Tag + data in a 32 bit atomic structure to enable lock-free synchronization.
+// With EEX_CFG_WIDE_COUNT the tag and data are 32 bits each and the structure is
+// updated with a 64 bit CAS, which is emulated on cores without one.
+#if (EEX_CFG_WIDE_COUNT == 1)
+typedef uint32_t     eex_count_t;
+typedef uint64_t     eex_tagged_word_t;
+#define EEX_COUNT_MAX   0xffffffffu
+#else
+typedef uint16_t     eex_count_t;
+typedef uint32_t     eex_tagged_word_t;
+#define EEX_COUNT_MAX   0xffffu
+#endif
 
-// Tag + data in a 32 bit atomic structure to enable lock-free synchronization
 typedef volatile union {
     struct {
-        uint16_t                 tag;       // unique tag to avoid ABA problem
-        uint16_t                data;       // array index or item count
+        eex_count_t              tag;       // unique tag to avoid ABA problem
+        eex_count_t             data;       // array index or item count
     };
-    uint32_t                      td;       // tagged data
-} eex_tagged_data_t;
+    eex_tagged_word_t             td;       // tagged data
+} __attribute__ ((aligned (sizeof(eex_tagged_word_t)))) eex_tagged_data_t;
 
 typedef volatile struct {
     eex_kobj_desc_t             type;       // one of 'SEMA', 'MUTX', etc...
@@ -215,19 +479,86 @@ typedef volatile struct {
 } eex_kobj_cb_t;
 
 extern eex_kobj_cb_t       delay_kobj;      // delay control block for all threads to share
+extern eex_kobj_cb_t       period_kobj;     // periodic release control block for all threads to share
+extern eex_kobj_cb_t       table_kobj;      // time-triggered table release control block for all threads to share
+extern eex_kobj_cb_t       yield_kobj;      // yield control block for all threads to share
+extern eex_kobj_cb_t       defer_kobj;      // the deferred work thread waits on it for deferred items
 
 typedef volatile struct {
     eex_kobj_cb_t                 cb;       // control block
     uint32_t                  signal;       // signal bits
+    uint32_t                  manual;       // nonzero if a pend doesn't clear the signal bits (broadcast)
+    eex_thread_list_t       released;       // broadcast waiters released by a post, not yet run
 } eex_signal_cb_t;
 
 typedef volatile struct {
     eex_kobj_cb_t                 cb;       // control block
     eex_tagged_data_t          count;       // semaphore or mutex count
-    uint16_t                 max_val;       // semaphore maximum count, 1 if mutex
+    eex_count_t              max_val;       // semaphore maximum count, 1 if mutex
     uint16_t                owner_id;       // thread ID that holds the mutex, 0 if free
 } eex_sema_mutex_cb_t;
 
+typedef volatile struct {
+    eex_kobj_cb_t                 cb;       // control block
+    eex_tagged_data_t           free;       // head of the free block list, block number 1..n_blks or 0 if empty
+    uint32_t                   fresh;       // number of blocks taken from the never-allocated end of the pool
+    uint16_t                blk_size;       // block size in bytes, a multiple of 4
+    uint16_t                  n_blks;       // number of blocks in the pool
+    uint32_t                   *link;       // free list links, link[n] is the block following block n
+    uint8_t                     *mem;       // block storage
+} eex_pool_cb_t;
+
+typedef volatile struct {
+    eex_kobj_cb_t                 cb;       // control block
+    uint32_t                    head;       // free running count of bytes written
+    uint32_t                    tail;       // free running count of bytes read
+    uint16_t                    size;       // buffer size in bytes, a power of 2
+    uint16_t                 trigger;       // bytes available before a pend with n_bytes == 0 succeeds
+    uint8_t                     *buf;       // byte storage
+} eex_stream_cb_t;
+
+// Ordered buffer ring indices in a 32 bit atomic structure. Indices are in words.
+typedef volatile union {
+    struct {
+        uint16_t                tail;       // oldest allocated block
+        uint16_t                head;       // next block to allocate, tail == head if empty
+    };
+    uint32_t                      ht;       // both indices
+} eex_obuf_index_t;
+
+typedef volatile struct {
+    eex_kobj_cb_t                 cb;       // control block
+    eex_obuf_index_t             idx;       // ring indices
+    uint16_t                 n_words;       // ring size in 32 bit words
+    uint16_t                min_free;       // low watermark of free words
+    uint32_t                n_failed;       // allocations that returned without a block
+    uint32_t                    *buf;       // word storage, each block is preceded by a one word header
+} eex_obuf_cb_t;
+
+typedef volatile struct {
+    eex_kobj_cb_t                 cb;       // control block
+    eex_thread_list_t       signaled;       // waiting threads that have been signaled
+} eex_cond_cb_t;
+
+typedef volatile struct {
+    eex_kobj_cb_t                 cb;       // control block
+    eex_tagged_data_t          count;       // reader count, writer held and writer waiting flags
+    eex_thread_list_t        writers;       // threads whose pend is for writing, AND with cb.pend for waiting writers
+    uint16_t               writer_id;       // thread ID that holds the write lock, 0 if none
+} eex_rwlock_cb_t;
+
+typedef volatile struct {
+    eex_kobj_cb_t                 cb;       // control block
+    eex_thread_list_t        arrived;       // threads waiting for the rest of the parties
+    eex_thread_list_t       released;       // threads released by the last arrival, not yet run
+    uint16_t                 parties;       // number of threads that synchronize
+} eex_barrier_cb_t;
+
+typedef volatile struct {
+    eex_kobj_cb_t                 cb;       // control block
+    eex_tagged_data_t          count;       // remaining count, open at zero
+} eex_latch_cb_t;
+
 typedef volatile uint32_t eex_signal_t;
 
 typedef enum { EEX_EVENT_NO_ACTION=0, EEX_EVENT_PEND, EEX_EVENT_POST } eex_event_action_t;
@@ -241,6 +572,47 @@ typedef struct eex_thread_event_t {
     eex_kobj_cb_t              *kobj;       // event object
 } eex_thread_event_t;
 
+typedef volatile struct {
+    eex_kobj_cb_t                 cb;       // control block, the thread lists are not used
+    uint32_t                   value;       // notification value
+    uint32_t                 pending;       // nonzero if notified since the last wait
+} eex_notify_cb_t;
+
+typedef volatile struct {
+    eex_kobj_cb_t                 cb;       // control block, joiners are on the pend list
+    uint32_t                    done;       // nonzero once the thread has exited
+    uint32_t               exit_code;       // returned to joiners
+    uint32_t               free_slot;       // thread slot is released when the thread leaves the cpu
+} eex_join_cb_t;
+
+typedef struct {
+    uint32_t                    next;       // kernel time of the next release
+    uint32_t                  period;       // release period in ms, 0 if not periodic
+    uint32_t                n_missed;       // releases skipped because the thread overran
+} eex_thread_period_t;
+
+typedef struct {
+    uint32_t               budget_us;       // cpu time allowed per period
+    uint32_t               period_ms;       // replenishment period
+    int32_t             remaining_us;       // budget left in this period, negative after an overrun
+    uint32_t                 next_ms;       // kernel time of the next replenishment
+} eex_thread_budget_t;
+
+typedef struct {
+    uint32_t                   level;       // criticality level, threads below the kernel mode are not dispatched
+    uint32_t               budget_us;       // optimistic cpu time per job, an overrun raises the kernel mode
+    uint32_t                  job_us;       // cpu time used by the current job
+} eex_thread_crit_t;
+
+// Fast handler binding
+typedef struct {
+    eex_handler_fn_t              fn;       // handler function
+    eex_kobj_cb_t              *kobj;       // kernel object the handler waits on
+    uint32_t                     val;       // pend parameter
+    eex_status_t              status;       // result of the last pend
+    uint32_t                 rtn_val;       // value returned by the last pend
+} eex_handler_t;
+
 // Thread Control Block
 typedef struct eex_thread_cb_t {
     eex_thread_fn_t        fn_thread;       // start address of thread function
@@ -248,20 +620,50 @@ typedef struct eex_thread_cb_t {
     const char                 *name;       // thread name
     void                  *resume_pc;       // saved pc for continuation
     eex_thread_event_t         event;       // event thread is waiting on
+    eex_notify_cb_t           notify;       // direct to thread notification
+    eex_join_cb_t               join;       // completion, posted when the thread exits
+    eex_thread_period_t       period;       // periodic release
+    eex_thread_budget_t       budget;       // execution budget
+    eex_thread_crit_t           crit;       // criticality
+    uint32_t           t_dispatch_us;       // kernel time in us the thread was last dispatched, if it is charged
+    uint32_t               threshold;       // preemption threshold, only higher priorities preempt the dispatched thread
+    eex_table_stats_t          table;       // time-triggered releases
+    uint32_t        table_release_us;       // kernel time in us of the pending time-triggered release
+    eex_handler_t            handler;       // fast handler, if the slot is one
 } eex_thread_cb_t;
 
 typedef enum { EEX_THREAD_READY, EEX_THREAD_WAITING, EEX_THREAD_INTERRUPTED } eex_thread_list_selector_t;
 
+// Background job queue slot
+typedef struct {
+    eex_job_fn_t                  fn;       // job function
+    void                        *arg;       // job function argument
+    uint32_t                 wcet_us;       // worst case run time
+    volatile uint32_t            seq;       // free for the lap starting at seq, holds its job at seq + 1
+} eex_idle_job_t;
+
+// Deferred work item, pushed by an interrupt handler and run by the deferred work thread
+typedef struct eex_defer_t {
+    struct eex_defer_t * volatile next;     // next item on the deferred list
+    eex_job_fn_t                  fn;       // deferred work function
+    void                        *arg;       // deferred work function argument
+    volatile uint32_t         queued;       // nonzero from eexDefer until the function is started
+} eex_defer_t;
+
 
 // Function prototypes. These are implemented as functions, not macros
 uint32_t          eexInInterrupt();         // returns exception number if in handler mode, or 0 if in thread mode
 eex_thread_cb_t * eexScheduler(bool from_interrupt);
 void              eexSchedulerPend(void);
+bool              eexRWLockReadFast(void *rwlock, bool acquire, eex_status_t *p_rtn_status);
 bool              eexPendPost(void *func_yield_pt, eex_status_t *p_rtn_status, uint32_t *p_rtn_val, uint32_t timeout, uint32_t val, eex_kobj_cb_t *p_kobj, eex_event_action_t action);
 eex_thread_id_t   eexThreadTimeout(void);   // Returns the thread ID of the highest priority waiting task to time out
+bool              eexPartitionSwitchDue(void);  // Returns true if the current partition window has ended
+bool              eexTableReleaseDue(void);     // Returns true if a time-triggered table release is due
 int32_t           eexTimeDiff(uint32_t time, uint32_t ref);
 eex_thread_cb_t * eexThreadTCB(eex_thread_id_t tid);
 uint32_t          eexCPUAtomic32CAS(uint32_t volatile *addr, uint32_t expected, uint32_t store);
+uint32_t          eexCPUAtomic64CAS(uint64_t volatile *addr, uint64_t expected, uint64_t store);
 void *            eexCPUAtomicPtrCAS(void * volatile *addr, void * expected, void * store);
 uint32_t          eexCPUCLZ(uint32_t x);
 
@@ -278,6 +680,54 @@ uint32_t          eexCPUCLZ(uint32_t x);
 #define eexPendSignal(p_rtn_status, p_rtn_val, timeout, signal_mask, p_kobj)  EEX_PEND_POST(p_rtn_status, p_rtn_val, timeout, signal_mask, p_kobj, EEX_EVENT_PEND)
 #define eexPostSignal(p_rtn_status, signal, p_kobj)                           eexPost(p_rtn_status, signal, 0, p_kobj)
 
+#define eexPendStream(p_rtn_status, p_rtn_val, timeout, n_bytes, p_kobj)      EEX_PEND_POST(p_rtn_status, p_rtn_val, timeout, n_bytes, p_kobj, EEX_EVENT_PEND)
+#define eexPendObuf(p_rtn_status, p_rtn_val, timeout, n_bytes, p_kobj)        EEX_PEND_POST(p_rtn_status, p_rtn_val, timeout, n_bytes, p_kobj, EEX_EVENT_PEND)
+
+#define EEX_COND_SIGNAL_ONE     1           // cond post values
+#define EEX_COND_SIGNAL_ALL     2
+#define eexCondWait(p_rtn_status, timeout, p_cond, p_mutex)                   EEX_PEND_POST(p_rtn_status, 0, timeout, (uint32_t) (uintptr_t) (p_mutex), p_cond, EEX_EVENT_PEND)
+#define eexCondSignal(p_rtn_status, p_cond)                                   eexPost(p_rtn_status, EEX_COND_SIGNAL_ONE, 0, p_cond)
+#define eexCondBroadcast(p_rtn_status, p_cond)                                eexPost(p_rtn_status, EEX_COND_SIGNAL_ALL, 0, p_cond)
+
+#define EEX_RWLOCK_READ         1           // rwlock pend and post values
+#define EEX_RWLOCK_WRITE        2
+#define eexRWLockRead(p_rtn_status, timeout, p_rwl)                                                     \
+    do { if (!eexRWLockReadFast(p_rwl, true, p_rtn_status))                                             \
+         { EEX_PEND_POST(p_rtn_status, 0, timeout, EEX_RWLOCK_READ, p_rwl, EEX_EVENT_PEND); } } while(0)
+#define eexRWLockReadRelease(p_rtn_status, p_rwl)                                                       \
+    do { if (!eexRWLockReadFast(p_rwl, false, p_rtn_status))                                            \
+         { EEX_PEND_POST(p_rtn_status, 0, 0, EEX_RWLOCK_READ, p_rwl, EEX_EVENT_POST); } } while(0)
+#define eexRWLockWrite(p_rtn_status, timeout, p_rwl)                          EEX_PEND_POST(p_rtn_status, 0, timeout, EEX_RWLOCK_WRITE, p_rwl, EEX_EVENT_PEND)
+#define eexRWLockWriteRelease(p_rtn_status, p_rwl)                            EEX_PEND_POST(p_rtn_status, 0, 0, EEX_RWLOCK_WRITE, p_rwl, EEX_EVENT_POST)
+
+#define eexBarrierWait(p_rtn_status, timeout, p_barrier)                      EEX_PEND_POST(p_rtn_status, 0, timeout, 0, p_barrier, EEX_EVENT_PEND)
+
+#define EEX_NOTIFY_NO_VALUE     0           // notify actions
+#define EEX_NOTIFY_SET_BITS     1
+#define EEX_NOTIFY_INCREMENT    2
+#define EEX_NOTIFY_OVERWRITE    3
+// a post has no return value, the notify action is passed in place of p_rtn_val
+#define eexNotify(p_rtn_status, tid, action, value)                           EEX_PEND_POST(p_rtn_status, (uint32_t *) (uintptr_t) (action), 0, value, &(eexThreadTCB(tid)->notify), EEX_EVENT_POST)
+#define eexNotifyWait(p_rtn_status, p_rtn_val, timeout, clear_mask)           EEX_PEND_POST(p_rtn_status, p_rtn_val, timeout, clear_mask, &(eexThreadTCB(eexThreadID())->notify), EEX_EVENT_PEND)
+
+// the exit post passes free_slot in place of p_rtn_val, the thread function returns whether or not the post blocked
+#define eexThreadExit(exit_code, free_slot)                                                     \
+    do {                                                                                        \
+        EEX_PEND_POST(NULL, (uint32_t *) (uintptr_t) (free_slot), 0, exit_code, &(eexThreadTCB(eexThreadID())->join), EEX_EVENT_POST);  \
+        EEX_PROFILE_EXIT;                                                                       \
+        return;                                                                                 \
+    } while(0)
+#define eexThreadJoin(p_rtn_status, p_rtn_val, timeout, tid)                  EEX_PEND_POST(p_rtn_status, p_rtn_val, timeout, 0, &(eexThreadTCB(tid)->join), EEX_EVENT_PEND)
+
+#define eexLatchWait(p_rtn_status, timeout, p_latch)                          eexPend(p_rtn_status, 0, timeout, p_latch)
+#define eexLatchCountDown(p_rtn_status, n, p_latch)                           eexPost(p_rtn_status, n, 0, p_latch)
+
+// the release time is taken from the thread's period, the timeout only marks the pend as blocking
+#define eexThreadPeriodWait(p_rtn_status, p_rtn_missed)                       eexPend(p_rtn_status, p_rtn_missed, eexWaitForever, (&period_kobj))
+#define eexTableWait(p_rtn_status, p_rtn_jitter_us)                           eexPend(p_rtn_status, p_rtn_jitter_us, eexWaitForever, (&table_kobj))
+
+#define eexYield()                                                            eexPend(0, 0, 0, (&yield_kobj))
+
 #define eexDelay(delay_ms)                                                    eexPend(0, 0, (delay_ms), (&delay_kobj))
 #define eexDelayUntil(kernel_ms)                                              eexDelay((kernel_ms) - eexKernelTime(NULL))
 
@@ -333,7 +783,63 @@ STATIC void * const name = (void *) &name##_storage
 
 #undef  EEX_SIGNAL_NEW
 #define EEX_SIGNAL_NEW(name)                                                                     \
-static eex_signal_cb_t name##_storage = { { 'SIGL', 0, 0 }, 0};                                  \
+static eex_signal_cb_t name##_storage = { { 'SIGL', 0, 0 }, 0, 0, 0 };                            \
+STATIC void * const name = (void *) &name##_storage
+
+#undef  EEX_SIGNAL_BROADCAST_NEW
+#define EEX_SIGNAL_BROADCAST_NEW(name)                                                          \
+static eex_signal_cb_t name##_storage = { { 'SIGL', 0, 0 }, 0, 1, 0 };                            \
+STATIC void * const name = (void *) &name##_storage
+
+#undef  EEX_POOL_NEW
+#define EEX_POOL_NEW(name, blk_size, n_blks)                                                    \
+_Static_assert(((n_blks) > 0) && ((n_blks) < 0xffff), "Pool must have 1 to 65534 blocks.");     \
+static uint32_t      name##_mem[(n_blks) * (((blk_size) + 3) / 4)];                             \
+static uint32_t      name##_link[(n_blks) + 1];                                                 \
+static eex_pool_cb_t name##_storage = { { 'POOL', 0, 0 }, { 0, 0 }, 0, ((blk_size) + 3) & ~3,   \
+                                        n_blks, name##_link, (uint8_t *) name##_mem };          \
+STATIC void * const name = (void *) &name##_storage
+
+#undef  EEX_STREAM_NEW
+#define EEX_STREAM_NEW(name, size, trigger)                                                     \
+_Static_assert((size) && !((size) & ((size) - 1)) && ((size) <= 32768), "Stream size must be a power of 2."); \
+static uint8_t         name##_buf[size];                                                        \
+static eex_stream_cb_t name##_storage = { { 'STRM', 0, 0 }, 0, 0, size, trigger, name##_buf };  \
+STATIC void * const name = (void *) &name##_storage
+
+#undef  EEX_OBUF_NEW
+#define EEX_OBUF_NEW(name, size)                                                                \
+_Static_assert((((size) + 3) / 4) < 65536, "I/O buffer size must be less than 256K bytes.");   \
+static uint32_t      name##_buf[((size) + 3) / 4];                                              \
+static eex_obuf_cb_t name##_storage = { { 'OBUF', 0, 0 }, { { 0, 0 } }, ((size) + 3) / 4,      \
+                                        ((size) + 3) / 4 - 1, 0, name##_buf };                  \
+STATIC void * const name = (void *) &name##_storage
+
+#undef  EEX_COND_NEW
+#define EEX_COND_NEW(name)                                                                      \
+static eex_cond_cb_t name##_storage = { { 'COND', 0, 0 }, 0 };                                  \
+STATIC void * const name = (void *) &name##_storage
+
+#undef  EEX_RWLOCK_NEW
+#define EEX_RWLOCK_NEW(name)                                                                    \
+static eex_rwlock_cb_t name##_storage = { { 'RWLK', 0, 0 }, { 0, 0 }, 0, 0 };                   \
+STATIC void * const name = (void *) &name##_storage
+
+#undef  EEX_BARRIER_NEW
+#define EEX_BARRIER_NEW(name, parties)                                                          \
+_Static_assert(((parties) > 0) && ((parties) <= 32), "Barrier parties must be 1 to 32.");       \
+static eex_barrier_cb_t name##_storage = { { 'BARR', 0, 0 }, 0, 0, parties };                   \
+STATIC void * const name = (void *) &name##_storage
+
+#undef  EEX_LATCH_NEW
+#define EEX_LATCH_NEW(name, count)                                                              \
+_Static_assert((count) <= EEX_COUNT_MAX, "Latch count exceeds EEX_COUNT_MAX.");                 \
+static eex_latch_cb_t name##_storage = { { 'LTCH', 0, 0 }, { 0, count } };                      \
+STATIC void * const name = (void *) &name##_storage
+
+#undef  EEX_DEFER_NEW
+#define EEX_DEFER_NEW(name, fn, argument)                                                       \
+static eex_defer_t name##_storage = { NULL, fn, argument, 0 };                                  \
 STATIC void * const name = (void *) &name##_storage
 
 
@@ -0,0 +1,149 @@
+/*******************************************************************************
+
+    eex_work.h - Real time executive work servers.
+
+    COPYRIGHT NOTICE: (c) ee-quipment.com
+    All Rights Reserved
+
+ ******************************************************************************/
+
+
+#ifndef _eex_work_H_
+#define _eex_work_H_
+
+#include <stdint.h>
+#include "eex_os.h"
+
+
+// Static allocator for a server and its job queue. n_jobs must be a power of 2.
+// 'name' must not be in quotes. i.e. EEX_SERVER_NEW(myServer, 16) not EEX_SERVER_NEW("myServer", 16)
+#define EEX_SERVER_NEW(name, n_jobs)
+
+// Static allocator for a worker pool with n_levels job priorities, each with a queue of n_jobs.
+// n_jobs must be a power of 2. i.e. EEX_WORKERS_NEW(myPool, 3, 16)
+#define EEX_WORKERS_NEW(name, n_levels, n_jobs)
+
+
+typedef struct {
+    eex_job_fn_t               fn;       // job function
+    void                     *arg;       // job function argument
+    volatile uint32_t         seq;       // queue position the slot is ready for
+} eex_job_t;
+
+typedef struct {
+    eex_job_t               *jobs;       // job queue
+    uint32_t                 mask;       // n_jobs - 1
+    volatile uint32_t        head;       // next job to run, only the server moves it
+    volatile uint32_t        tail;       // next free slot, producers claim it with a CAS
+    uint32_t                  tid;       // server thread
+    uint32_t            n_dropped;       // jobs that were submitted to a full queue
+} eex_server_cb_t;
+
+typedef struct {
+    eex_job_t               *jobs;       // job queue
+    uint32_t                 mask;       // n_jobs - 1
+    volatile uint32_t        head;       // next job to run, workers claim it with a CAS
+    volatile uint32_t        tail;       // next free slot, producers claim it with a CAS
+    uint32_t            n_dropped;       // jobs that were submitted to a full queue
+} eex_job_queue_t;
+
+typedef struct {
+    eex_job_t               *jobs;       // n_levels * n_jobs slots, divided among the queues
+    eex_job_queue_t       *queues;       // one queue per job priority, 0 is the lowest
+    uint32_t             n_levels;       // number of job priorities
+    uint32_t                 mask;       // n_jobs - 1
+    eex_sema_mutex_cb_t     *sema;       // posted when a job is queued, idle workers pend on it
+    uint32_t                batch;       // most jobs a worker runs per dispatch
+} eex_workers_cb_t;
+
+
+/*
+ * A server is a thread that runs aperiodic jobs from a queue. It is given a
+ * high priority so jobs are serviced quickly, and an execution budget so that
+ * a burst of jobs can't starve lower priority threads. The server runs jobs
+ * until the budget for the period is used up, then waits for it to be
+ * replenished. The budget is checked between jobs, so a job should be short
+ * compared to the budget, and a job that overruns it is repaid from the next
+ * period. A budget of 0 makes the server an unlimited worker thread.
+ *
+ * Jobs may be submitted from threads and interrupt handlers. Jobs are run in
+ * the order they were submitted. If the queue is full the job is dropped and
+ * eexStatusKOErr is returned.
+ */
+
+eex_status_t  eexServerCreate(void *server, uint32_t priority, uint32_t budget_us, uint32_t period_ms, const char *name);
+
+// Function-like macro, redefined as a macro below.
+void          eexServerSubmit(eex_status_t *p_rtn_status, void *server, eex_job_fn_t fn, void *argument);
+
+
+/*
+ * A worker pool runs many kinds of short jobs on a fixed set of threads, so
+ * a job type doesn't need a thread and a priority of its own. Each job
+ * priority (level) has a queue, and workers always take the oldest job of
+ * the highest level that has one. The workers are n_workers threads at
+ * priorities priority to priority + n_workers - 1. An idle worker pends on
+ * the pool's semaphore.
+ *
+ * A worker runs up to batch jobs per dispatch and then yields, so the
+ * scheduler pass is shared by the batch. A larger batch gives more jobs per
+ * second but holds off the threads the yield would let in (threads of the
+ * same threshold group, or the other workers) for longer.
+ *
+ * Jobs may be submitted from threads and interrupt handlers. If the level's
+ * queue is full the job is dropped and eexStatusKOErr is returned.
+ */
+
+eex_status_t  eexWorkersCreate(void *workers, uint32_t priority, uint32_t n_workers, uint32_t batch, const char *name);
+
+// Function-like macro, redefined as a macro below.
+void          eexWorkersSubmit(eex_status_t *p_rtn_status, void *workers, uint32_t level, eex_job_fn_t fn, void *argument);
+
+
+
+// Not part of the API
+eex_status_t  _eexServerPut(eex_server_cb_t *server, eex_job_fn_t fn, void *argument);
+eex_status_t  _eexWorkersPut(eex_workers_cb_t *workers, uint32_t level, eex_job_fn_t fn, void *argument);
+
+#undef  eexServerSubmit
+#define eexServerSubmit(p_rtn_status, server, fn, argument)                                     \
+    do {                                                                                        \
+        if (_eexServerPut((eex_server_cb_t *) (server), (fn), (argument)) == eexStatusOK) {     \
+            eexNotify(p_rtn_status, ((eex_server_cb_t *) (server))->tid, EEX_NOTIFY_NO_VALUE, 0); \
+        }                                                                                       \
+        else if ((p_rtn_status) != NULL) { *(eex_status_t *) (p_rtn_status) = eexStatusKOErr; } \
+    } while(0)
+
+// The semaphore only wakes a worker, which then runs jobs until the queues are empty,
+// so it is posted only when no wake-up is already pending.
+#undef  eexWorkersSubmit
+#define eexWorkersSubmit(p_rtn_status, workers, level, fn, argument)                            \
+    do {                                                                                        \
+        if (_eexWorkersPut((eex_workers_cb_t *) (workers), (level), (fn), (argument)) != eexStatusOK) { \
+            if ((p_rtn_status) != NULL) { *(eex_status_t *) (p_rtn_status) = eexStatusKOErr; }  \
+        }                                                                                       \
+        else if (((eex_workers_cb_t *) (workers))->sema->count.data == 0) {                     \
+            eexPost(p_rtn_status, 0, 0, ((eex_workers_cb_t *) (workers))->sema);                \
+        }                                                                                       \
+        else if ((p_rtn_status) != NULL) { *(eex_status_t *) (p_rtn_status) = eexStatusOK; }    \
+    } while(0)
+
+#undef  EEX_SERVER_NEW
+#define EEX_SERVER_NEW(name, n_jobs)                                                            \
+_Static_assert(((n_jobs) > 1) && (((n_jobs) & ((n_jobs) - 1)) == 0), "n_jobs must be a power of 2"); \
+static eex_job_t name##_jobs[n_jobs];                                                           \
+static eex_server_cb_t name##_storage = { name##_jobs, (n_jobs) - 1, 0, 0, 0, 0 };             \
+STATIC void * const name = (void *) &name##_storage
+
+#undef  EEX_WORKERS_NEW
+#define EEX_WORKERS_NEW(name, n_levels, n_jobs)                                                 \
+_Static_assert(((n_jobs) > 1) && (((n_jobs) & ((n_jobs) - 1)) == 0), "n_jobs must be a power of 2"); \
+_Static_assert(((n_levels) > 0) && (((n_levels) * (n_jobs)) <= EEX_COUNT_MAX), "too many jobs");  \
+static eex_job_t name##_jobs[(n_levels) * (n_jobs)];                                            \
+static eex_job_queue_t name##_queues[n_levels];                                                 \
+static eex_sema_mutex_cb_t name##_sema = { { 'SEMA', 0, 0 }, { 0, 0 }, (n_levels) * (n_jobs), 0 }; \
+static eex_workers_cb_t name##_storage = { name##_jobs, name##_queues, (n_levels), (n_jobs) - 1, &name##_sema, 1 }; \
+STATIC void * const name = (void *) &name##_storage
+
+
+#endif  /* _eex_work_H_ */
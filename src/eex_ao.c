@@ -0,0 +1,204 @@
+/*******************************************************************************
+
+    eex_ao.c - Real time executive active objects.
+
+    COPYRIGHT NOTICE: (c) ee-quipment.com
+    All Rights Reserved
+
+ ******************************************************************************/
+
+
+#include  <stdint.h>
+#include  <stddef.h>
+#include  "eex_os.h"
+#include  "eex_ao.h"
+
+#pragma GCC diagnostic ignored "-Wmultichar"    // Don't complain about e.g. 'MUTX'
+
+#ifdef UNIT_TEST
+#define STATIC
+#else
+#define STATIC static
+#endif
+
+/*******************************************************************************
+ *
+ *  An event queue is a bounded ring of event pointers, with the sequence of
+ *  a slot counted in laps of the ring so that an all zero queue is empty. A
+ *  producer at position pos claims the slot when its sequence is the lap
+ *  pos & ~mask, by a CAS on the tail, then stores the pointer and publishes
+ *  it by incrementing the sequence. A consumer claims a published slot by a
+ *  CAS on the head and frees it for the next lap. Events are never copied.
+ *
+ *  An object's queue has one consumer, its thread, but a pool's free list
+ *  is the same ring with many, since events are taken by threads and
+ *  interrupt handlers alike. A pool starts with an empty free list and
+ *  hands out never-allocated events until they run out.
+ *
+ *  The object's thread waits on its notification. A post notifies it only
+ *  if no notification is pending, the thread clears the pending flag before
+ *  it looks at the queue and then dispatches until the queue is empty.
+ *
+ *  A post doesn't use eexNotify, which returns from the calling function to
+ *  block and so can only be used in a thread function. When a post readies
+ *  a higher priority thread the caller is recorded, and an object's thread
+ *  yields after the dispatch that made the post.
+ *
+ ******************************************************************************/
+
+
+STATIC volatile uint32_t  g_ao_yield_tid = 0;   // thread that readied a higher priority thread in a post
+
+STATIC bool             _eexAOQueuePut(eex_ao_queue_t *queue, void *ptr);
+STATIC void *           _eexAOQueueGet(eex_ao_queue_t *queue);
+STATIC uint32_t         _eexAOEventRefs(eex_ao_event_t *event, int32_t delta);
+STATIC void             _eexAOEventRelease(eex_ao_event_t *event);
+STATIC void             _eexAOThread(void * const argument);
+
+
+eex_status_t eexAOCreate(void *ao, eex_ao_dispatch_fn_t dispatch, void *argument, uint32_t priority, const char *name) {
+    eex_ao_cb_t *p_ao = (eex_ao_cb_t *) ao;
+
+    assert (p_ao && p_ao->queue.slots && dispatch);
+    p_ao->dispatch = dispatch;
+    p_ao->arg      = argument;
+    p_ao->tid      = priority;
+    return (eexThreadCreate(_eexAOThread, p_ao, priority, name));
+}
+
+eex_status_t eexAOPost(void *ao, void *event) {
+    eex_ao_cb_t     *p_ao    = (eex_ao_cb_t *) ao;
+    eex_ao_event_t  *p_event = (eex_ao_event_t *) event;
+    eex_notify_cb_t *notify;
+
+    assert (p_ao && p_ao->dispatch && p_event);
+    if (p_event->pool) { (void) _eexAOEventRefs(p_event, 1); }
+    if (!_eexAOQueuePut(&(p_ao->queue), p_event)) {
+        _eexAOEventRelease(p_event);
+        return (eexStatusKOErr);
+    }
+
+    notify = &(eexThreadTCB(p_ao->tid)->notify);
+    if (!notify->pending) {
+        if (eexPendPost(NULL, NULL, NULL, 0, 0, (eex_kobj_cb_t *) notify, EEX_EVENT_POST) && !eexInInterrupt()) {
+            g_ao_yield_tid = eexThreadID();
+        }
+    }
+    return (eexStatusOK);
+}
+
+// The publisher holds a reference until every post is made, so an object that dispatches
+// the event before it is posted to the next one doesn't recycle it.
+eex_status_t eexAOPublish(void *event, void * const *aos, uint32_t n_aos) {
+    eex_ao_event_t  *p_event = (eex_ao_event_t *) event;
+    eex_status_t     status  = eexStatusOK;
+
+    assert (p_event && aos);
+    if (p_event->pool) { (void) _eexAOEventRefs(p_event, 1); }
+    for (uint32_t i=0; i<n_aos; ++i) {
+        if (eexAOPost(aos[i], p_event) != eexStatusOK) { status = eexStatusKOErr; }
+    }
+    _eexAOEventRelease(p_event);
+    return (status);
+}
+
+void * eexAOEventNew(void *pool, uint32_t sig) {
+    eex_ao_pool_t   *p_pool = (eex_ao_pool_t *) pool;
+    eex_ao_event_t  *event;
+    uint32_t         fresh;
+
+    assert (p_pool && p_pool->mem);
+    event = (eex_ao_event_t *) _eexAOQueueGet(&(p_pool->free));
+    if (event == NULL) {                                                    // nothing recycled, take a never-allocated event
+        do {
+            fresh = p_pool->fresh;
+            if (fresh >= p_pool->n_evts) { return (NULL); }                 // pool exhausted
+        } while (eexCPUAtomic32CAS(&(p_pool->fresh), fresh, fresh + 1));
+        event = (eex_ao_event_t *) &(p_pool->mem[fresh * p_pool->evt_size]);
+    }
+    event->sig  = sig;
+    event->pool = p_pool;
+    event->refs = 0;
+    return (event);
+}
+
+
+STATIC bool _eexAOQueuePut(eex_ao_queue_t *queue, void *ptr) {
+    eex_ao_slot_t   *slot;
+    uint32_t         pos, lap;
+    int32_t          diff;
+
+    for (;;) {
+        pos  = queue->tail;
+        lap  = pos & ~queue->mask;
+        slot = &(queue->slots[pos & queue->mask]);
+        diff = (int32_t) (slot->seq - lap);
+        if (diff < 0) {                                                     // queue is full
+            ++queue->n_dropped;
+            return (false);
+        }
+        if ((diff == 0) && !eexCPUAtomic32CAS(&(queue->tail), pos, pos + 1)) { break; }
+        // another producer claimed the position first, try the next one
+    }
+    slot->ptr = ptr;
+    slot->seq = lap + 1;                                                    // publish
+    return (true);
+}
+
+STATIC void * _eexAOQueueGet(eex_ao_queue_t *queue) {
+    eex_ao_slot_t   *slot;
+    void            *ptr;
+    uint32_t         pos, lap;
+    int32_t          diff;
+
+    for (;;) {
+        pos  = queue->head;
+        lap  = pos & ~queue->mask;
+        slot = &(queue->slots[pos & queue->mask]);
+        diff = (int32_t) (slot->seq - (lap + 1));
+        if (diff < 0) { return (NULL); }                                   // empty, or next event not published yet
+        if ((diff == 0) && !eexCPUAtomic32CAS(&(queue->head), pos, pos + 1)) { break; }
+        // another consumer took the event first, try the next one
+    }
+    ptr = slot->ptr;
+    slot->seq = lap + queue->mask + 1;                                      // free for the producer one lap later
+    return (ptr);
+}
+
+// Returns the new reference count
+STATIC uint32_t _eexAOEventRefs(eex_ao_event_t *event, int32_t delta) {
+    uint32_t    refs;
+
+    do { refs = event->refs; }
+    while (eexCPUAtomic32CAS(&(event->refs), refs, refs + (uint32_t) delta));
+    return (refs + (uint32_t) delta);
+}
+
+// Drop a reference, the last one returns a pool event to its free list
+STATIC void _eexAOEventRelease(eex_ao_event_t *event) {
+    if (event->pool == NULL) { return; }
+    if (_eexAOEventRefs(event, -1) == 0) {
+        (void) _eexAOQueuePut(&(((eex_ao_pool_t *) event->pool)->free), event);   // can't be full, it holds every event
+    }
+}
+
+// Objects share one thread function. The event isn't kept across the yield, the queue is
+// looked at again after it.
+STATIC void _eexAOThread(void * const argument) {
+    eex_ao_cb_t     *ao = (eex_ao_cb_t *) argument;
+    eex_ao_event_t  *event;
+
+    eexThreadEntry();
+
+    for (;;) {
+        eexNotifyWait(NULL, NULL, eexWaitForever, 0);
+        while ((event = (eex_ao_event_t *) _eexAOQueueGet(&(ao->queue))) != NULL) {
+            ao->dispatch(ao->arg, event);
+            _eexAOEventRelease(event);
+            if (g_ao_yield_tid == eexThreadID()) {                          // the dispatch readied a higher priority thread
+                g_ao_yield_tid = 0;
+                eexYield();
+            }
+        }
+    }
+}
@@ -0,0 +1,239 @@
+/*******************************************************************************
+
+    eex_fir.c - Delay line and FIR filter kernels.
+
+    COPYRIGHT NOTICE: (c) ee-quipment.com
+    All Rights Reserved
+
+ ******************************************************************************/
+
+
+#include  <stdint.h>
+#include  <string.h>
+#include  "eex_os.h"
+#include  "eex_fir.h"
+
+#if (defined __AVX2__) || (defined __SSE2__)
+#include  <immintrin.h>
+#elif (defined __ARM_FEATURE_DSP)
+#include  <arm_acle.h>
+#endif
+
+#ifdef UNIT_TEST
+#define STATIC
+#else
+#define STATIC static
+#endif
+
+
+/*******************************************************************************
+
+    Generic C kernels. Always compiled, they handle the SIMD remainders and
+    are the reference for the unit tests.
+
+ ******************************************************************************/
+
+STATIC int64_t _eexFirDotI16C(const int16_t *x, const int16_t *h, uint32_t n) {
+    int64_t acc = 0;
+
+    for (uint32_t i=0; i<n; ++i) { acc += (int32_t) x[i] * h[i]; }
+    return (acc);
+}
+
+STATIC int64_t _eexFirDotI32C(const int32_t *x, const int32_t *h, uint32_t n) {
+    int64_t acc = 0;
+
+    for (uint32_t i=0; i<n; ++i) { acc += (int64_t) x[i] * h[i]; }
+    return (acc);
+}
+
+STATIC float _eexFirDotF32C(const float *x, const float *h, uint32_t n) {
+    float acc = 0.0f;
+
+    for (uint32_t i=0; i<n; ++i) { acc += x[i] * h[i]; }
+    return (acc);
+}
+
+
+/*******************************************************************************
+
+    SIMD kernels. Each processes whole vectors and finishes the remainder
+    with the generic kernel.
+
+ ******************************************************************************/
+
+int64_t eexFirDotI16(const int16_t *x, const int16_t *h, uint32_t n) {
+    uint32_t i = 0;
+    int64_t  acc = 0;
+
+#if (defined __AVX2__)
+    __m256i  acc64 = _mm256_setzero_si256();
+    __m256i  prod;
+    for (; (i + 16) <= n; i += 16) {       // 16 products, summed in pairs to 8 x int32, widened to 4 x int64
+        prod  = _mm256_madd_epi16(_mm256_loadu_si256((const __m256i *) &x[i]), _mm256_loadu_si256((const __m256i *) &h[i]));
+        acc64 = _mm256_add_epi64(acc64, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(prod)));
+        acc64 = _mm256_add_epi64(acc64, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(prod, 1)));
+    }
+    int64_t lane[4];
+    _mm256_storeu_si256((__m256i *) lane, acc64);
+    acc = lane[0] + lane[1] + lane[2] + lane[3];
+
+#elif (defined __SSE2__)
+    __m128i  acc64 = _mm_setzero_si128();
+    __m128i  prod, sign;
+    for (; (i + 8) <= n; i += 8) {         // 8 products, summed in pairs to 4 x int32, widened to 2 x int64
+        prod  = _mm_madd_epi16(_mm_loadu_si128((const __m128i *) &x[i]), _mm_loadu_si128((const __m128i *) &h[i]));
+        sign  = _mm_srai_epi32(prod, 31);
+        acc64 = _mm_add_epi64(acc64, _mm_unpacklo_epi32(prod, sign));
+        acc64 = _mm_add_epi64(acc64, _mm_unpackhi_epi32(prod, sign));
+    }
+    int64_t lane[2];
+    _mm_storeu_si128((__m128i *) lane, acc64);
+    acc = lane[0] + lane[1];
+
+#elif (defined __ARM_FEATURE_DSP)
+    int16x2_t xx, hh;
+    for (; (i + 2) <= n; i += 2) {         // dual 16 bit multiply accumulate into 64 bits
+        (void) memcpy(&xx, &x[i], sizeof(xx));
+        (void) memcpy(&hh, &h[i], sizeof(hh));
+        acc = __smlald(xx, hh, acc);
+    }
+#endif
+
+    return (acc + _eexFirDotI16C(&x[i], &h[i], n - i));
+}
+
+int64_t eexFirDotI32(const int32_t *x, const int32_t *h, uint32_t n) {
+    uint32_t i = 0;
+    int64_t  acc = 0;
+
+#if (defined __AVX2__)
+    __m256i  acc64 = _mm256_setzero_si256();
+    __m256i  xx, hh;
+    for (; (i + 8) <= n; i += 8) {         // signed 32x32->64 multiply of the even lanes, then the odd lanes
+        xx    = _mm256_loadu_si256((const __m256i *) &x[i]);
+        hh    = _mm256_loadu_si256((const __m256i *) &h[i]);
+        acc64 = _mm256_add_epi64(acc64, _mm256_mul_epi32(xx, hh));
+        acc64 = _mm256_add_epi64(acc64, _mm256_mul_epi32(_mm256_srli_epi64(xx, 32), _mm256_srli_epi64(hh, 32)));
+    }
+    int64_t lane[4];
+    _mm256_storeu_si256((__m256i *) lane, acc64);
+    acc = lane[0] + lane[1] + lane[2] + lane[3];
+#endif
+    // SSE2 has no signed 32x32->64 multiply, and on M4 the compiler emits SMLAL for the generic kernel
+
+    return (acc + _eexFirDotI32C(&x[i], &h[i], n - i));
+}
+
+float eexFirDotF32(const float *x, const float *h, uint32_t n) {
+    uint32_t i = 0;
+    float    acc = 0.0f;
+
+#if (defined __AVX2__)
+    __m256   acc8 = _mm256_setzero_ps();
+    for (; (i + 8) <= n; i += 8) {
+#if (defined __FMA__)
+        acc8 = _mm256_fmadd_ps(_mm256_loadu_ps(&x[i]), _mm256_loadu_ps(&h[i]), acc8);
+#else
+        acc8 = _mm256_add_ps(acc8, _mm256_mul_ps(_mm256_loadu_ps(&x[i]), _mm256_loadu_ps(&h[i])));
+#endif
+    }
+    float lane[8];
+    _mm256_storeu_ps(lane, acc8);
+    acc = ((lane[0] + lane[1]) + (lane[2] + lane[3])) + ((lane[4] + lane[5]) + (lane[6] + lane[7]));
+
+#elif (defined __SSE2__)
+    __m128   acc4 = _mm_setzero_ps();
+    for (; (i + 4) <= n; i += 4) {
+        acc4 = _mm_add_ps(acc4, _mm_mul_ps(_mm_loadu_ps(&x[i]), _mm_loadu_ps(&h[i])));
+    }
+    float lane[4];
+    _mm_storeu_ps(lane, acc4);
+    acc = (lane[0] + lane[1]) + (lane[2] + lane[3]);
+#endif
+    // the M4 FPU is scalar, the generic kernel compiles to VFMA
+
+    return (acc + _eexFirDotF32C(&x[i], &h[i], n - i));
+}
+
+
+/*******************************************************************************
+
+    Delay line
+
+    The tap zero index moves down one element per sample. The new sample is
+    written at the new index and again n_taps elements above it, so elements
+    index..index+n_taps-1 are always the current taps in order.
+
+ ******************************************************************************/
+
+// Move tap zero down one element and return a pointer to the low copy of the new sample.
+STATIC uint8_t * _eexDLAdvance(eex_dl_cb_t *dl) {
+    assert (dl && (dl->n_taps > 0));
+    assert (dl->index < dl->n_taps);
+
+    dl->index = (dl->index == 0) ? (uint16_t) (dl->n_taps - 1) : (uint16_t) (dl->index - 1);
+    return (&(dl->mem[(uint32_t) dl->index * dl->type_size]));
+}
+
+void eexDLUpdate(void *dl, const void *sample) {
+    eex_dl_cb_t *p_dl = (eex_dl_cb_t *) dl;
+    uint8_t     *p_new;
+
+    p_new = _eexDLAdvance(p_dl);
+    (void) memcpy(p_new, sample, p_dl->type_size);
+    (void) memcpy(p_new + ((uint32_t) p_dl->n_taps * p_dl->type_size), sample, p_dl->type_size);
+}
+
+void * eexDLGetTap(void *dl, uint32_t tap) {
+    eex_dl_cb_t *p_dl = (eex_dl_cb_t *) dl;
+
+    assert (p_dl && (tap < p_dl->n_taps));
+    return (&(p_dl->mem[((uint32_t) p_dl->index + tap) * p_dl->type_size]));
+}
+
+void * eexDLTaps(void *dl) {
+    return (eexDLGetTap(dl, 0));
+}
+
+uint32_t eexDLNTaps(void *dl) {
+    assert (dl);
+    return (((eex_dl_cb_t *) dl)->n_taps);
+}
+
+
+/*******************************************************************************
+
+    Filters
+
+ ******************************************************************************/
+
+int64_t eexFirI16(void *dl, const int16_t *h, int16_t sample) {
+    eex_dl_cb_t *p_dl = (eex_dl_cb_t *) dl;
+    int16_t     *p_new;
+
+    assert (p_dl && (p_dl->type_size == sizeof(int16_t)));
+    p_new = (int16_t *) _eexDLAdvance(p_dl);
+    p_new[0] = p_new[p_dl->n_taps] = sample;
+    return (eexFirDotI16(p_new, h, p_dl->n_taps));
+}
+
+int64_t eexFirI32(void *dl, const int32_t *h, int32_t sample) {
+    eex_dl_cb_t *p_dl = (eex_dl_cb_t *) dl;
+    int32_t     *p_new;
+
+    assert (p_dl && (p_dl->type_size == sizeof(int32_t)));
+    p_new = (int32_t *) _eexDLAdvance(p_dl);
+    p_new[0] = p_new[p_dl->n_taps] = sample;
+    return (eexFirDotI32(p_new, h, p_dl->n_taps));
+}
+
+float eexFirF32(void *dl, const float *h, float sample) {
+    eex_dl_cb_t *p_dl = (eex_dl_cb_t *) dl;
+    float       *p_new;
+
+    assert (p_dl && (p_dl->type_size == sizeof(float)));
+    p_new = (float *) _eexDLAdvance(p_dl);
+    p_new[0] = p_new[p_dl->n_taps] = sample;
+    return (eexFirDotF32(p_new, h, p_dl->n_taps));
+}
@@ -29,29 +29,82 @@
 // helper macros
 #define EEX_TIMEOUT_EXPIRED(timeout)  ((timeout) && (timeout != (uint32_t) eexWaitForever) && (eexTimeDiff(timeout, eexKernelTime(NULL)) <= 0))
 
+// CAS of an eex_tagged_data_t, 64 bits wide if EEX_CFG_WIDE_COUNT
+#if (EEX_CFG_WIDE_COUNT == 1)
+#define EEX_TAGGED_CAS(p_td, expected, store)   eexCPUAtomic64CAS((p_td), (expected), (store))
+#else
+#define EEX_TAGGED_CAS(p_td, expected, store)   eexCPUAtomic32CAS((p_td), (expected), (store))
+#endif
+
+#define EEX_POOL_BLK_ALLOCATED        0xffffffff                // link[n] of a block that is allocated
+#define EEX_POOL_BLK_FREEING          0xfffffffe                // link[n] of a block being pushed onto the free list
+
+// Ordered buffer block header. The low half is the block length in words, including the header.
+#define EEX_OBUF_FREED                0x80000000
+#define EEX_OBUF_WORDS(n_bytes)       ((((n_bytes) + 3) / 4) + 1)               // block words including the header
+#define EEX_OBUF_HT(head, tail)       (((uint32_t) (head) << 16) | (tail))     // eex_obuf_index_t.ht
+
+// Condition variable wait value is the mutex address, the low bit is set once the mutex has been released
+#define EEX_COND_MUTEX_RELEASED       0x00000001
+
+// Reader-writer lock count fields
+#define EEX_RWLOCK_WRITER_HELD        0x8000
+#define EEX_RWLOCK_WRITER_WAITING     0x4000
+#define EEX_RWLOCK_READERS            0x3fff
+
+// Barrier wait value flag, set once the thread has arrived
+#define EEX_BARRIER_ARRIVED           0x00000001
+
 /*******************************************************************************
 
     Private Functions
 
  ******************************************************************************/
-STATIC eex_tagged_data_t    _eexNewTaggedData(uint16_t data);
+STATIC eex_tagged_data_t    _eexNewTaggedData(eex_count_t data);
 STATIC bool                 _eexInScheduler(void);
 STATIC void                 _eexBMSet(eex_bm_t * const a, uint32_t const bit);
 STATIC void                 _eexBMClr(eex_bm_t * const a, uint32_t const bit);
 STATIC uint32_t             _eexBMState(eex_bm_t const * const a, uint32_t const bit);
 STATIC uint32_t             _eexBMFF1(const eex_bm_t a);
+STATIC uint32_t             _eexBMCount(const eex_bm_t a);
 STATIC eex_thread_list_t *  _eexThreadListGet(eex_thread_list_selector_t which_list);
 STATIC void                 _eexThreadListAdd(eex_thread_list_t *list, eex_thread_id_t tid);
 STATIC void                 _eexThreadListDel(eex_thread_list_t *list, eex_thread_id_t tid);
 STATIC bool                 _eexThreadListContains(const eex_thread_list_t *list, eex_thread_id_t tid);
 STATIC eex_thread_id_t      _eexThreadListHPT(eex_thread_list_t list, eex_thread_list_t mask);
+STATIC eex_thread_id_t      _eexThreadThreshold(eex_thread_id_t tid);
 STATIC void                 _eexThreadIDSet(eex_thread_id_t tid);
+STATIC uint32_t             _eexKernelTimeUs(void);
+STATIC void                 _eexThreadCharge(eex_thread_id_t tid, bool f_job_done);
+STATIC void                 _eexBudgetReplenish(void);
+STATIC void                 _eexSleepAdd(eex_thread_id_t tid);
+STATIC void                 _eexSleepWake(void);
+STATIC void                 _eexPartitionSwitch(void);
+STATIC void                 _eexTableRelease(void);
+STATIC bool                 _eexIdleJobRun(int32_t ms_next);
+STATIC void                 _eexHandlerArm(eex_thread_id_t tid);
+STATIC void                 _eexHandlerRun(eex_thread_id_t tid);
+STATIC void                 _eexHandlerThread(void *argument);
 int32_t                     _eexThreadTimeoutNext(void);
 STATIC void                 _eexEventInit(void *yield_pt, eex_status_t *p_rtn_status, uint32_t *p_rtn_val, uint32_t timeout, uint32_t val, eex_kobj_cb_t *p_kobj, eex_event_action_t action);
 STATIC void                 _eexEventRemove(eex_thread_id_t tid, eex_thread_event_t *event, eex_status_t status);
 STATIC eex_thread_id_t      _eexEventTry(eex_thread_id_t evt_thread_priority, eex_thread_event_t *event);
 STATIC bool                 _eexSemaMutexTry(const eex_thread_event_t *event);
-STATIC bool                 _eexSignalTry(const eex_thread_event_t *event);
+STATIC bool                 _eexSignalTry(eex_thread_id_t tid, const eex_thread_event_t *event);
+STATIC void                 _eexSignalRelease(eex_signal_cb_t *p_signal_cb, eex_signal_t signal);
+STATIC bool                 _eexPoolTry(const eex_thread_event_t *event);
+STATIC bool                 _eexStreamTry(const eex_thread_event_t *event);
+STATIC uint32_t             _eexStreamNeed(const eex_stream_cb_t *stream, uint32_t n_bytes);
+STATIC bool                 _eexObufTry(const eex_thread_event_t *event);
+STATIC uint32_t             _eexObufPlace(const eex_obuf_cb_t *obuf, uint32_t ht, uint32_t n_words, uint32_t *p_start);
+STATIC bool                 _eexCondTry(eex_thread_id_t tid, eex_thread_event_t *event);
+STATIC bool                 _eexRWLockTry(eex_thread_id_t tid, const eex_thread_event_t *event);
+STATIC bool                 _eexBarrierTry(eex_thread_id_t tid, eex_thread_event_t *event);
+STATIC bool                 _eexLatchTry(const eex_thread_event_t *event);
+STATIC bool                 _eexNotifyTry(eex_thread_id_t tid, const eex_thread_event_t *event);
+STATIC bool                 _eexJoinTry(eex_thread_id_t tid, const eex_thread_event_t *event);
+STATIC bool                 _eexTableTry(eex_thread_id_t tid, const eex_thread_event_t *event);
+STATIC eex_thread_id_t      _eexThreadKobjOwner(const eex_kobj_cb_t *p_kobj);
 
 /*******************************************************************************
 
@@ -66,6 +119,51 @@ STATIC eex_thread_cb_t g_thread_tcb[EEX_CFG_THREADS_MAX+1] = { 0 };
 STATIC          eex_thread_list_t   g_thread_ready_list       = EEX_EMPTY_THREAD_LIST;
 STATIC          eex_thread_list_t   g_thread_waiting_list     = EEX_EMPTY_THREAD_LIST;
 STATIC          eex_thread_list_t   g_thread_interrupted_list = EEX_EMPTY_THREAD_LIST;
+STATIC          eex_thread_list_t   g_thread_preempted_list   = EEX_EMPTY_THREAD_LIST;  // blocked by its own post above the threshold, job not finished
+STATIC          eex_thread_list_t   g_thread_suspended_list   = EEX_EMPTY_THREAD_LIST;  // not dispatched while ready or waiting
+STATIC          eex_thread_list_t   g_thread_abort_list       = EEX_EMPTY_THREAD_LIST;  // waits to abort on the next try
+STATIC          eex_thread_list_t   g_thread_budget_list      = EEX_EMPTY_THREAD_LIST;  // threads with an execution budget
+STATIC          eex_thread_list_t   g_thread_exhausted_list   = EEX_EMPTY_THREAD_LIST;  // budget used up, not dispatched until replenished
+STATIC          eex_thread_list_t   g_thread_crit_list        = EEX_EMPTY_THREAD_LIST;  // threads whose jobs can raise the criticality mode
+STATIC          eex_thread_list_t   g_thread_sleep_list       = EEX_EMPTY_THREAD_LIST;  // delayed waiting threads, not tried before g_sleep_next
+STATIC          uint32_t            g_sleep_next              = 0;                      // earliest timeout in the sleep list
+STATIC          eex_thread_list_t   g_thread_handler_list     = EEX_EMPTY_THREAD_LIST;  // fast handlers, run by the scheduler instead of dispatched
+
+// Time partitions. g_partition_mask holds the partitioned threads outside the current window's partition.
+STATIC          eex_thread_list_t   g_partition_threads[EEX_CFG_PARTITIONS+1] = { 0 };  // threads of each partition, 0 is unused
+STATIC          eex_thread_list_t   g_thread_partitioned_list = EEX_EMPTY_THREAD_LIST;  // threads in any partition
+STATIC          eex_thread_list_t   g_partition_mask          = EEX_EMPTY_THREAD_LIST;
+STATIC const    eex_partition_window_t *g_partition_windows   = NULL;
+STATIC          uint32_t            g_partition_n_windows     = 0;                      // 0 if partitioning is stopped
+STATIC          uint32_t            g_partition_window        = 0;                      // index of the current window
+STATIC          uint32_t            g_partition_window_end    = 0;                      // kernel time the current window ends
+STATIC          eex_partition_stats_t g_partition_stats[EEX_CFG_PARTITIONS+1];
+
+// Time-triggered table. Threads waiting on the table are masked out of the search until released.
+STATIC          eex_thread_list_t   g_thread_table_wait_list  = EEX_EMPTY_THREAD_LIST;  // threads waiting in eexTableWait
+STATIC          eex_thread_list_t   g_table_released_list     = EEX_EMPTY_THREAD_LIST;  // released, not yet dispatched
+STATIC const    eex_table_release_t *g_table                  = NULL;
+STATIC          uint32_t            g_table_n_releases        = 0;                      // 0 if the table is stopped
+STATIC          uint32_t            g_table_hyperperiod       = 0;
+STATIC          uint32_t            g_table_index             = 0;                      // next release
+STATIC          uint32_t            g_table_frame_ms          = 0;                      // kernel time the current hyperperiod started
+STATIC          uint32_t            g_table_next_ms           = 0;                      // kernel time of the next release
+
+// Background jobs, a ring of EEX_CFG_IDLE_JOBS slots. Free running positions, the slot is pos & mask.
+_Static_assert((EEX_CFG_IDLE_JOBS > 1) && !(EEX_CFG_IDLE_JOBS & (EEX_CFG_IDLE_JOBS - 1)), "EEX_CFG_IDLE_JOBS must be a power of 2.");
+STATIC          eex_idle_job_t      g_idle_job[EEX_CFG_IDLE_JOBS];
+STATIC volatile uint32_t            g_idle_head               = 0;                      // next job to run, only the scheduler moves it
+STATIC volatile uint32_t            g_idle_tail               = 0;                      // next free slot, producers claim it with a CAS
+STATIC          uint32_t            g_idle_n_dropped          = 0;                      // jobs submitted to a full queue
+
+// Deferred interrupt work, items pushed by interrupt handlers, newest first
+STATIC          eex_defer_t * volatile g_defer_head           = NULL;
+
+// Criticality mode. g_crit_mask[mode] holds the threads with a level below mode, which are not dispatched.
+STATIC          eex_thread_list_t   g_crit_mask[EEX_CFG_CRIT_LEVELS] = { 0 };
+STATIC          uint32_t            g_crit_mode      = 0;
+STATIC          uint32_t            g_crit_n_switch  = 0;
+STATIC          uint32_t            g_crit_n_restore = 0;
 
 // currently running thread
 STATIC volatile eex_thread_id_t     g_thread_running = 0;
@@ -73,6 +171,18 @@ STATIC volatile eex_thread_id_t     g_thread_running = 0;
 // delay control block for all threads to share
 eex_kobj_cb_t   delay_kobj  = { 'DLAY', 0, 0 };
 
+// periodic release control block for all threads to share
+eex_kobj_cb_t   period_kobj = { 'PERD', 0, 0 };
+
+// time-triggered table release control block for all threads to share
+eex_kobj_cb_t   table_kobj  = { 'TTRG', 0, 0 };
+
+// yield control block for all threads to share
+eex_kobj_cb_t   yield_kobj  = { 'YILD', 0, 0 };
+
+// deferred work control block, the deferred work thread is its only waiter
+eex_kobj_cb_t   defer_kobj  = { 'DEFR', 0, 0 };
+
 // system timer declared in eex_arm.c
 extern volatile uint32_t g_timer_ms;
 
@@ -85,8 +195,8 @@ extern volatile uint32_t g_timer_ms;
 
 // Return a tagged data structure with a unique (rarely repeating) tag.
 // note: It is unlikely, yet possible, to have an undetected tag collision.
-STATIC eex_tagged_data_t  _eexNewTaggedData(uint16_t data) {
-    static uint16_t   tag = 0;
+STATIC eex_tagged_data_t  _eexNewTaggedData(eex_count_t data) {
+    static eex_count_t tag = 0;
     eex_tagged_data_t td;
 
     ++tag;
@@ -134,8 +244,8 @@ int32_t _eexThreadTimeoutNext(void) {
     eex_thread_list_t  *waiting_list = _eexThreadListGet(EEX_THREAD_WAITING);
     eex_thread_id_t     tid;
     eex_thread_cb_t    *tcb;
-    uint32_t            now, ms_remaining;
-    int32_t             ms_until_next_timeout = eexWaitMax;
+    uint32_t            now;
+    int32_t             ms_remaining, ms_until_next_timeout = eexWaitMax;
     bool                f_timeout_pending = false;
 
     now = eexKernelTime(NULL);
@@ -150,7 +260,27 @@ int32_t _eexThreadTimeoutNext(void) {
             }
         }
     }
-    if (ms_until_next_timeout == 0)   { ms_until_next_timeout = -1; } // neg value means thread timed out
+    // an exhausted thread is ready to run again when its budget is replenished
+    for (tid=1; tid<=EEX_CFG_THREADS_MAX; ++tid) {
+        if (_eexThreadListContains(&g_thread_exhausted_list, tid)) {
+            ms_remaining = eexTimeDiff(eexThreadTCB(tid)->budget.next_ms, now);
+            if (ms_remaining < ms_until_next_timeout) { ms_until_next_timeout = ms_remaining; }
+            f_timeout_pending = true;
+        }
+    }
+    // the next partition window may have threads to run
+    if (g_partition_n_windows) {
+        ms_remaining = eexTimeDiff(g_partition_window_end, now);
+        if (ms_remaining < ms_until_next_timeout) { ms_until_next_timeout = ms_remaining; }
+        f_timeout_pending = true;
+    }
+    // the next time-triggered release
+    if (g_table_n_releases) {
+        ms_remaining = eexTimeDiff(g_table_next_ms, now);
+        if (ms_remaining < ms_until_next_timeout) { ms_until_next_timeout = ms_remaining; }
+        f_timeout_pending = true;
+    }
+    if (ms_until_next_timeout <= 0)   { ms_until_next_timeout = -1; } // neg value means thread timed out, or is overdue
     if (!f_timeout_pending)           { ms_until_next_timeout = 0; }  // 0 means no timeouts pending
     return (ms_until_next_timeout);
 }
@@ -171,6 +301,14 @@ eex_thread_id_t eexThreadTimeout(void) {
     return (tid);
 }
 
+bool eexPartitionSwitchDue(void) {
+    return ((g_partition_n_windows) && (eexTimeDiff(g_partition_window_end, eexKernelTime(NULL)) <= 0));
+}
+
+bool eexTableReleaseDue(void) {
+    return ((g_table_n_releases) && (eexTimeDiff(g_table_next_ms, eexKernelTime(NULL)) <= 0));
+}
+
 
 /*******************************************************************************
 
@@ -230,6 +368,13 @@ STATIC uint32_t  _eexBMFF1(const eex_bm_t a) {
     return (32 - clz);
 }
 
+STATIC uint32_t  _eexBMCount(const eex_bm_t a) {
+    uint32_t bm = a, n = 0;
+
+    for (; bm; ++n) { bm &= bm - 1; }   // clear the lowest set bit
+    return (n);
+}
+
 STATIC eex_thread_list_t * _eexThreadListGet(eex_thread_list_selector_t which_list) {
     if (which_list == EEX_THREAD_READY)       { return (&g_thread_ready_list);       }
     if (which_list == EEX_THREAD_WAITING)     { return (&g_thread_waiting_list);     }
@@ -254,6 +399,12 @@ STATIC eex_thread_id_t _eexThreadListHPT(eex_thread_list_t list, eex_thread_list
     return ((eex_thread_id_t) _eexBMFF1((~mask) & list));
 }
 
+// highest priority that can't preempt tid once it is dispatched, never below its own priority
+STATIC eex_thread_id_t _eexThreadThreshold(eex_thread_id_t tid) {
+    eex_thread_id_t threshold = eexThreadTCB(tid)->threshold;
+    return ((threshold > tid) ? threshold : tid);
+}
+
 
 /*******************************************************************************
 
@@ -283,10 +434,11 @@ STATIC eex_thread_id_t _eexThreadListHPT(eex_thread_list_t list, eex_thread_list
 
     When the scheduler tries an event and the result is successful the
     associated thread will be dispatched. If the result of trying the
-    event also frees a higher priority task, the scheduler will be pended
-    which will cause a pendSV interrupt immediately after the thread is
-    dispatched. The dispatched thread will be put on the interrupted list
-    and the scheduler will run again.
+    event also frees a higher priority task, the thread is moved to the
+    ready list instead, the waiting mask is reset and the search starts
+    over in the same pass. The wake chain is followed until the HPT can
+    be dispatched, rather than dispatching each thread in the chain only
+    to have it preempted.
 
     If a thread is blocked waiting on a mutex, then the mutex is being held
     by a lower priority thread. The thread holding the mutex must have been
@@ -318,15 +470,52 @@ eex_thread_cb_t * eexScheduler(bool from_interrupt) {
     eex_thread_id_t     running_tid      = eexThreadID();
     eex_thread_event_t *event            = &(eexThreadTCB(running_tid)->event);
     uint32_t            old_ms, ms_asleep;
+    int32_t             ms_next;
 
     EEX_PROFILE_SCHED_ENTER(running_tid, from_interrupt);
 
+    // charge the running thread's cpu time and replenish budgets at their period boundaries
+    // a job ends when the thread blocks, it continues across preemptions and yields
+    if (g_thread_budget_list | g_thread_crit_list) {
+        _eexThreadCharge(running_tid, !from_interrupt && (event->action != EEX_EVENT_NO_ACTION) && (!event->kobj || (event->kobj->type != 'YILD')));
+        if (g_thread_budget_list) { _eexBudgetReplenish(); }
+    }
+
     // threads are interrupted
     //   or block after a successful pend or post but also free up a higher priority thread
     //   or block due to a resource not being available
+    //   or have exited and leave all lists
     if (from_interrupt)                             { _eexThreadListAdd(interrupted_list, running_tid); }
+    else if (eexThreadTCB(running_tid)->join.done) {
+        _eexThreadListDel(&g_thread_suspended_list, running_tid);
+        _eexThreadListDel(&g_thread_abort_list, running_tid);
+        _eexThreadListDel(&g_thread_budget_list, running_tid);
+        _eexThreadListDel(&g_thread_exhausted_list, running_tid);
+        _eexThreadListDel(&g_thread_crit_list, running_tid);
+        _eexThreadListDel(&g_thread_preempted_list, running_tid);
+        if (eexThreadTCB(running_tid)->join.free_slot) { eexThreadTCB(running_tid)->fn_thread = NULL; }
+    }
     else if (event->action == EEX_EVENT_NO_ACTION)  { _eexThreadListAdd(ready_list, running_tid); }
-    else                                            { _eexThreadListAdd(waiting_list, running_tid); }
+    else {
+        _eexThreadListAdd(waiting_list, running_tid);
+        if (!(event->kobj) || (event->kobj->type != 'YILD')) { _eexThreadListDel(&g_thread_preempted_list, running_tid); }
+        if ((event->kobj) && ((event->kobj->type == 'DLAY') || (event->kobj->type == 'PERD'))) { _eexSleepAdd(running_tid); }
+        if ((event->kobj) && (event->kobj->type == 'TTRG'))  { _eexThreadListAdd(&g_thread_table_wait_list, running_tid); }
+    }
+
+    // sleeping threads whose timeouts have passed are tried again, the partition window
+    // and time-triggered releases are brought up to date
+    if (g_thread_sleep_list)   { _eexSleepWake(); }
+    if (g_partition_n_windows) { _eexPartitionSwitch(); }
+    if (g_table_n_releases)    { _eexTableRelease(); }
+
+    // ready and waiting threads at or below the preemption threshold of the highest priority
+    // unfinished thread can't preempt it. It is above the thresholds of the unfinished threads below it.
+    // A thread is unfinished while interrupted, or while ready after its own post released a thread
+    // above its threshold, until it is dispatched again.
+    eex_thread_list_t unfinished     = *interrupted_list | (g_thread_preempted_list & ~(g_thread_suspended_list | g_thread_exhausted_list | g_partition_mask | g_crit_mask[g_crit_mode]));
+    eex_thread_id_t   threshold      = _eexThreadThreshold(_eexThreadListHPT(unfinished, EEX_EMPTY_THREAD_LIST));
+    eex_thread_list_t threshold_mask = ((threshold < 32) ? (((eex_thread_list_t) 1 << threshold) - 1) : ~EEX_EMPTY_THREAD_LIST) & ~unfinished;
 
     eex_thread_list_t thread_waiting_mask = EEX_EMPTY_THREAD_LIST;
     eex_thread_id_t   ready_thread, unblock_thread;
@@ -340,7 +529,14 @@ eex_thread_cb_t * eexScheduler(bool from_interrupt) {
             hoisted_thread = 0;
         }
         else {
-            ready_thread = _eexThreadListHPT((*ready_list | *interrupted_list | *waiting_list), thread_waiting_mask);
+            // a suspended or exhausted thread that was interrupted is on the stack and must still be returned to
+            // ready and waiting threads below the criticality mode are masked out until the kernel would idle,
+            // as are partitioned threads outside the current window. Interrupted ones are returned to.
+            // sleeping threads can only time out and table threads can only be released, they are masked out
+            // unless their wait is aborted
+            ready_thread = _eexThreadListHPT((((*ready_list | *waiting_list) & ~(g_thread_suspended_list | g_thread_exhausted_list | g_partition_mask | g_crit_mask[g_crit_mode])) | *interrupted_list),
+                                             thread_waiting_mask | threshold_mask |
+                                             ((g_thread_sleep_list | (g_thread_table_wait_list & ~g_table_released_list)) & ~g_thread_abort_list));
         }
         ready_tcb = eexThreadTCB(ready_thread);
         event     = &(ready_tcb->event);
@@ -361,11 +557,22 @@ eex_thread_cb_t * eexScheduler(bool from_interrupt) {
         // thread waiting on event, dispatch it if event can be satified or it timed out
         else if (_eexThreadListContains(waiting_list, ready_thread)) {
             unblock_thread = _eexEventTry(ready_thread, event);
-            if (unblock_thread) {
+            if (unblock_thread && _eexThreadListContains(&g_thread_handler_list, ready_thread)) {
+                // a fast handler runs here to completion and waits again, it is never dispatched.
+                // The search starts over in case it readied a thread.
+                _eexHandlerRun(ready_thread);
+                thread_waiting_mask = EEX_EMPTY_THREAD_LIST;
+            }
+            else if (unblock_thread > ready_thread) {                // potentially unblocked a higher priority thread
+                // follow the wake chain in this pass rather than dispatching the thread only
+                // to have it preempted. Its event is complete so it is ready, and the search
+                // starts over so waiting threads already passed over are tried again.
+                _eexThreadListDel(waiting_list, ready_thread);
+                _eexThreadListAdd(ready_list, ready_thread);
+                thread_waiting_mask = EEX_EMPTY_THREAD_LIST;
+            }
+            else if (unblock_thread) {
                 _eexThreadListDel(waiting_list, ready_thread);  // thread unblocked, dispatch it
-                if (unblock_thread > ready_thread) {            // potentially unblocked a higher priority thread
-                    eexSchedulerPend();                         // rerun scheduler to try hpt
-                }
                 break;
             }
             else {
@@ -379,7 +586,7 @@ eex_thread_cb_t * eexScheduler(bool from_interrupt) {
                     eex_thread_id_t mutex_owner = ((eex_sema_mutex_cb_t *) (event->kobj))->owner_id;
                     if (mutex_owner < ready_thread) {   // priority inversion
                         // try mutex_owner next instead of waiting for its turn
-                        if (_eexThreadListContains(waiting_list, mutex_owner)) {
+                        if (_eexThreadListContains(waiting_list, mutex_owner) && !_eexThreadListContains(&g_thread_suspended_list, mutex_owner)) {
                             _eexThreadListAdd(&thread_waiting_mask, mutex_owner);
                             hoisted_thread = mutex_owner;
                         }
@@ -390,19 +597,39 @@ eex_thread_cb_t * eexScheduler(bool from_interrupt) {
             }
         }
 
+        // nothing of the current criticality can run, return to mode 0 and search the masked threads
+        else if (g_crit_mode) {
+            g_crit_mode = 0;
+            ++g_crit_n_restore;
+        }
+
         // no thread is ready, waiting, or interrupted
         else {
+            ms_next = _eexThreadTimeoutNext();
+            // run one background job if it fits before the next timeout, otherwise
             // call idle hook to sleep until next timeout or interrupt
-            ms_asleep = eexIdleHook(_eexThreadTimeoutNext());
-            // adjust ms timer for time spent in idle hook
-            do { old_ms = g_timer_ms; }
-            while (eexCPUAtomic32CAS(&g_timer_ms, old_ms, old_ms + ms_asleep));
+            if (!_eexIdleJobRun(ms_next)) {
+                ms_asleep = eexIdleHook(ms_next);
+                // adjust ms timer for time spent in idle hook
+                do { old_ms = g_timer_ms; }
+                while (eexCPUAtomic32CAS(&g_timer_ms, old_ms, old_ms + ms_asleep));
+            }
 
             // reset waiting thread mask and run scheduler again
             //EEX_PROFILE_SCHED_IDLE;   // tell profiler system is idling if no idle thread dispatch
             thread_waiting_mask = EEX_EMPTY_THREAD_LIST;
+            if (g_thread_budget_list) { _eexBudgetReplenish(); }
+            if (g_thread_sleep_list)  { _eexSleepWake(); }
+            if (g_partition_n_windows) { _eexPartitionSwitch(); }
+            if (g_table_n_releases)    { _eexTableRelease(); }
         }
     }
+    _eexThreadListDel(&g_thread_sleep_list, ready_thread);     // in case its sleep was aborted
+    _eexThreadListDel(&g_thread_table_wait_list, ready_thread);
+    _eexThreadListDel(&g_thread_preempted_list, ready_thread);
+    if (g_thread_budget_list | g_thread_crit_list) {
+        eexThreadTCB(ready_thread)->t_dispatch_us = _eexKernelTimeUs();
+    }
     _eexThreadIDSet(ready_thread);
     EEX_PROFILE_SCHED_EXIT(ready_thread);
     return (ready_tcb);
@@ -418,6 +645,328 @@ STATIC bool _eexInScheduler(void) {
 }
 
 
+/*******************************************************************************
+
+    Time partitions
+
+    The schedule is a list of windows repeated as a major frame. The current
+    window's partition threads and the unpartitioned threads are searched by
+    priority as usual, every other ready or waiting partitioned thread is
+    masked out of the search by g_partition_mask. A window switch replaces
+    the mask. Threads of the outgoing partition that were interrupted are on
+    the stack and are returned to, the incoming partition's threads below
+    them run when they block. The tick handler pends the scheduler when
+    a window ends, a switch found late by the scheduler is an overrun of the
+    outgoing partition.
+
+******************************************************************************/
+
+STATIC void _eexPartitionSwitch(void) {
+    eex_partition_stats_t *stats;
+    uint32_t               now = eexKernelTime(NULL);
+    int32_t                late_ms;
+
+    late_ms = eexTimeDiff(now, g_partition_window_end);
+    if (late_ms < 0) { return; }
+    if (late_ms > 0) {
+        stats = &g_partition_stats[g_partition_windows[g_partition_window].partition];
+        ++stats->n_overrun;
+        stats->overrun_ms += (uint32_t) late_ms;
+    }
+
+    // next window that hasn't already ended
+    for (;;) {
+        g_partition_window = (g_partition_window + 1) % g_partition_n_windows;
+        g_partition_window_end += g_partition_windows[g_partition_window].duration_ms;
+        stats = &g_partition_stats[g_partition_windows[g_partition_window].partition];
+        if (eexTimeDiff(g_partition_window_end, now) > 0) { break; }
+        ++stats->n_skipped;
+    }
+    ++stats->n_windows;
+    g_partition_mask = g_thread_partitioned_list & ~g_partition_threads[g_partition_windows[g_partition_window].partition];
+}
+
+
+/*******************************************************************************
+
+    Time-triggered table
+
+    The table is walked by the scheduler only, when the tick handler finds a
+    release due and pends it, so the walk is never interrupted by another
+    walk. A release marks the thread released and records the release time.
+    A thread waiting on the table is masked out of the search until it is
+    released, then its wait succeeds and the time from the release to the
+    dispatch is its jitter. Table waits have no timeout, so they cost
+    nothing in the timeout processing.
+
+******************************************************************************/
+
+STATIC void _eexTableRelease(void) {
+    const eex_table_release_t *release;
+    eex_thread_cb_t           *tcb;
+    uint32_t                   now = eexKernelTime(NULL);
+
+    while (eexTimeDiff(g_table_next_ms, now) <= 0) {
+        release = &g_table[g_table_index];
+        tcb     = eexThreadTCB(release->tid);
+        if (_eexThreadListContains(&g_table_released_list, release->tid)) { ++tcb->table.n_missed; }  // previous release not taken
+        else {
+            ++tcb->table.n_releases;
+            tcb->table_release_us = g_table_next_ms * 1000u;
+            _eexThreadListAdd(&g_table_released_list, release->tid);
+        }
+        if (++g_table_index == g_table_n_releases) {
+            g_table_index     = 0;
+            g_table_frame_ms += g_table_hyperperiod;
+        }
+        g_table_next_ms = g_table_frame_ms + g_table[g_table_index].offset_ms;
+    }
+}
+
+
+/*******************************************************************************
+
+    Fast handlers
+
+    A handler occupies a thread slot and stays in the waiting list, pending
+    on its kernel object forever, so posts find it in the object's pend list
+    and the scheduler tries it in priority order like any waiting thread.
+    When its pend succeeds the scheduler calls the handler function instead
+    of dispatching, which saves building a thread frame on the way in, the
+    resume_pc continuation, and a second scheduler pass when the thread
+    blocks again. The pend is then re-armed from the binding, since the
+    event is cleared when it completes.
+
+    The handler runs in the scheduler's context, so like the idle hook it
+    may post but must not block.
+
+******************************************************************************/
+
+STATIC void _eexHandlerArm(eex_thread_id_t tid) {
+    eex_thread_cb_t    *tcb   = eexThreadTCB(tid);
+    eex_thread_event_t *event = &(tcb->event);
+
+    event->kobj    = tcb->handler.kobj;
+    event->action  = EEX_EVENT_PEND;
+    event->rslt    = &(tcb->handler.status);
+    event->p_val   = &(tcb->handler.rtn_val);
+    event->val     = tcb->handler.val;
+    event->timeout = (uint32_t) eexWaitForever;
+    _eexThreadListAdd(&(tcb->handler.kobj->pend), tid);
+}
+
+STATIC void _eexHandlerRun(eex_thread_id_t tid) {
+    eex_thread_cb_t *tcb = eexThreadTCB(tid);
+
+    tcb->handler.fn(tcb->arg, tcb->handler.status, tcb->handler.rtn_val);
+    _eexHandlerArm(tid);
+}
+
+// Occupies a handler's thread slot, a handler is never dispatched
+STATIC void _eexHandlerThread(void *argument) {
+    (void) argument;
+    assert (0);
+}
+
+
+/*******************************************************************************
+
+    Background jobs
+
+    The queue is a bounded ring like a work server's, with the sequence of a
+    slot counted in laps of the ring so that an all zero queue is empty. A
+    producer at position pos claims the slot when its sequence is the lap
+    pos & ~mask, by a CAS on the tail, then fills it and publishes it by
+    incrementing the sequence. The scheduler is the only consumer, it frees
+    the slot for the next lap.
+
+    Jobs are run from the scheduler's idle branch, one per search, so a
+    thread readied by a job or an interrupt is dispatched before the next job
+    starts. A job is only started if its worst case run time ends before the
+    next thread timeout, and a job that doesn't fit stays at the head of the
+    queue until the idle period is long enough.
+
+******************************************************************************/
+
+STATIC bool _eexIdleJobRun(int32_t ms_next) {
+    eex_idle_job_t  *slot;
+    eex_job_fn_t     fn;
+    void            *arg;
+    uint32_t         pos, lap, us;
+
+    pos  = g_idle_head;
+    lap  = pos & ~(uint32_t) (EEX_CFG_IDLE_JOBS - 1);
+    slot = &g_idle_job[pos & (EEX_CFG_IDLE_JOBS - 1)];
+    if (slot->seq != (lap + 1)) { return (false); }                        // empty, or next job not published yet
+    if (ms_next < 0)            { return (false); }                        // a thread has timed out
+    if (ms_next > 0) {                                                      // compared in ms, a long idle time can't overflow
+        (void) eexKernelTime(&us);
+        if (((slot->wcet_us / 1000u) + (((slot->wcet_us % 1000u) + us + 999u) / 1000u)) > (uint32_t) ms_next) { return (false); }
+    }
+    fn  = slot->fn;
+    arg = slot->arg;
+    slot->seq   = lap + EEX_CFG_IDLE_JOBS;                                  // free for the producer one lap later
+    g_idle_head = pos + 1;
+    fn(arg);
+    return (true);
+}
+
+
+/*******************************************************************************
+
+    Deferred interrupt work
+
+    An interrupt handler pushes an item onto the deferred list with a CAS on
+    the head, a single atomic operation unless another interrupt pushed in
+    between. There is no event to initialize and no kernel object to try,
+    the scheduler is pended only by the push that finds the list empty and
+    only if the deferred work thread would preempt the interrupted thread.
+    The thread waits on defer_kobj, which is ready when the list isn't empty.
+
+    The thread takes the whole list with a second CAS, so a batch is every
+    item deferred since the last one was taken. The list is newest first and
+    is reversed to run the items in the order they were deferred. An item is
+    marked free before its function is called so that an interrupt during
+    the function defers it again rather than losing the work.
+
+    The queued flag is set without an atomic operation, so an item must only
+    be deferred from one interrupt priority, which can't interrupt itself.
+
+******************************************************************************/
+
+void _eexDeferThread(void * const argument) {
+    eex_defer_t  *item, *prev, *next;
+
+    (void) argument;
+    eexThreadEntry();
+    for (;;) {
+        eexPend(NULL, NULL, eexWaitForever, &defer_kobj);
+        do { item = g_defer_head; }
+        while (eexCPUAtomicPtrCAS((void * volatile *) &g_defer_head, item, NULL));
+        for (prev = NULL; item; item = next) { next = item->next;  item->next = prev;  prev = item; }
+        for (item = prev; item; item = next) {
+            next = item->next;
+            item->queued = 0;
+            item->fn(item->arg);
+        }
+    }
+}
+
+
+/*******************************************************************************
+
+    Sleeping threads
+
+    A thread in eexDelay or eexThreadPeriodWait can only be released by its
+    timeout (or an abort), so trying its event on every scheduler pass is
+    wasted work. Such threads are kept in a sleep list that masks them out
+    of the search, and the scheduler only walks the list once the earliest
+    timeout in it has passed. The threads stay in the waiting list, so the
+    idle hook still sees their timeouts.
+
+******************************************************************************/
+
+STATIC void _eexSleepAdd(eex_thread_id_t tid) {
+    uint32_t timeout = eexThreadTCB(tid)->event.timeout;
+
+    if ((timeout == 0) || (timeout == (uint32_t) eexWaitForever)) { return; }   // tried as a normal wait
+    if (!g_thread_sleep_list || (eexTimeDiff(timeout, g_sleep_next) < 0)) { g_sleep_next = timeout; }
+    _eexThreadListAdd(&g_thread_sleep_list, tid);
+}
+
+// Remove the threads that have timed out from the sleep list and find the next timeout.
+STATIC void _eexSleepWake(void) {
+    eex_thread_id_t    tid;
+    eex_thread_list_t  mask = EEX_EMPTY_THREAD_LIST;
+    uint32_t           now  = eexKernelTime(NULL);
+    uint32_t           timeout, next = 0;
+    bool               f_next = false;
+
+    if (eexTimeDiff(g_sleep_next, now) > 0) { return; }
+    while ((tid = _eexThreadListHPT(g_thread_sleep_list, mask))) {
+        _eexThreadListAdd(&mask, tid);
+        timeout = eexThreadTCB(tid)->event.timeout;
+        if (eexTimeDiff(timeout, now) <= 0)                 { _eexThreadListDel(&g_thread_sleep_list, tid); }
+        else if (!f_next || (eexTimeDiff(timeout, next) < 0)) { next = timeout;  f_next = true; }
+    }
+    g_sleep_next = next;
+}
+
+
+/*******************************************************************************
+
+    Execution budgets
+
+    A thread with a budget may run for budget_us in each period_ms. The
+    running thread is charged when it leaves the cpu, so time spent
+    interrupted or preempted is not charged. When the budget is used up the
+    thread is masked out of the scheduler, as if it were suspended, until the
+    next period boundary. Threads can't be stopped mid-run, so an overrun is
+    carried into the next period and the budget is enforced at the thread's
+    blocking points.
+
+    Criticality
+
+    A job of a monitored thread is the cpu time it uses between blocking
+    points. If a job overruns the thread's optimistic budget the kernel mode
+    is raised to the thread's level, and the scheduler masks out every thread
+    of a lower level with the single bitmap g_crit_mask[mode]. Lower level
+    threads that were interrupted are on the stack and are still returned
+    to, only ready and waiting ones are masked. The mode returns to 0 when
+    no thread of the current criticality can run, before the scheduler
+    would idle.
+
+******************************************************************************/
+
+STATIC uint32_t _eexKernelTimeUs(void) {
+    uint32_t ms, us;
+
+    ms = eexKernelTime(&us);
+    return ((ms * 1000u) + us);
+}
+
+// Charge the cpu time since tid was dispatched to its budget and to its current job.
+STATIC void _eexThreadCharge(eex_thread_id_t tid, bool f_job_done) {
+    eex_thread_cb_t   *tcb     = eexThreadTCB(tid);
+    eex_thread_list_t  charged = g_thread_budget_list | g_thread_crit_list;
+    uint32_t           elapsed_us;
+
+    if (!_eexThreadListContains(&charged, tid)) { return; }
+    elapsed_us = _eexKernelTimeUs() - tcb->t_dispatch_us;
+
+    if (_eexThreadListContains(&g_thread_budget_list, tid)) {
+        tcb->budget.remaining_us -= (int32_t) elapsed_us;
+        if (tcb->budget.remaining_us <= 0) { _eexThreadListAdd(&g_thread_exhausted_list, tid); }
+    }
+
+    if (_eexThreadListContains(&g_thread_crit_list, tid)) {
+        tcb->crit.job_us += elapsed_us;
+        if ((tcb->crit.job_us > tcb->crit.budget_us) && (tcb->crit.level > g_crit_mode)) {
+            g_crit_mode = tcb->crit.level;      // lower levels are masked out of the next search
+            ++g_crit_n_switch;
+        }
+        if (f_job_done) { tcb->crit.job_us = 0; }
+    }
+}
+
+STATIC void _eexBudgetReplenish(void) {
+    eex_thread_budget_t *budget;
+    eex_thread_id_t      tid;
+    eex_thread_list_t    mask = EEX_EMPTY_THREAD_LIST;
+    uint32_t             now  = eexKernelTime(NULL);
+
+    while ((tid = _eexThreadListHPT(g_thread_budget_list, mask))) {
+        _eexThreadListAdd(&mask, tid);
+        budget = &(eexThreadTCB(tid)->budget);
+        if (eexTimeDiff(budget->next_ms, now) > 0) { continue; }
+        if (budget->remaining_us > 0) { budget->remaining_us = 0; }       // unused budget isn't kept, an overrun is repaid
+        budget->remaining_us += (int32_t) budget->budget_us;
+        do { budget->next_ms += budget->period_ms; } while (eexTimeDiff(budget->next_ms, now) <= 0);
+        if (budget->remaining_us > 0) { _eexThreadListDel(&g_thread_exhausted_list, tid); }
+    }
+}
+
+
 /*******************************************************************************
 
     Events
@@ -437,6 +986,67 @@ STATIC bool _eexInScheduler(void) {
         A signal is a 32 bit non-zero value. This value is OR'd with any
         currently set bits in the signal value. The signal will be cleared to zero
         whenever it is read by a PEND operation.
+        A broadcast (manual reset) signal is not cleared by a PEND operation, so
+        every thread on the pend list whose mask matches succeeds when it is tried.
+        A POST also moves the matching waiters to the released list, as a barrier
+        does, so they succeed even if the bits are cleared with eexSignalClear
+        before they are tried. All of them run in one scheduler pass.
+
+        Pool:
+        A pool of fixed size blocks. A PEND operation allocates a block and returns
+        its address, blocking while the pool is empty. A POST operation frees the
+        block whose address is the post value. Free blocks are kept on a lock-free
+        singly linked list with a tagged head, so allocation and free are O(1).
+
+        Stream:
+        A single-producer/single-consumer byte ring. A PEND operation waits until at
+        least val bytes (or the trigger level if val is 0) are available and returns
+        the number of bytes available. A POST operation commits val bytes that the
+        producer has already written into the ring and wakes the consumer if enough
+        bytes are now available. The bytes themselves are moved with the non-blocking
+        eexStream functions, below.
+
+        Ordered I/O Buffer:
+        A ring that allocates variable sized, contiguous blocks to a single producer.
+        A PEND operation allocates val bytes, blocking while they don't fit, and
+        returns the block address. A POST operation frees the block at address val.
+        Freed blocks are reclaimed in allocation order, so a free wakes the producer
+        only if the oldest block was freed and the pending request now fits.
+
+        Condition Variable:
+        A PEND operation (wait) passes the mutex address in val. The first try
+        releases the mutex, the thread is already on the condition's pend list so
+        a signal can't be missed. A POST operation marks the highest priority
+        waiter (signal) or every waiter (broadcast) as signaled. When a signaled
+        waiter is tried its event is converted into a pend on the mutex and tried
+        again, so the mutex is re-acquired through the normal MUTX path, including
+        priority hoisting, and waiters run in priority order.
+
+        Reader-Writer Lock:
+        val selects read or write for both PEND (acquire) and POST (release).
+        The reader count and the writer held and writer waiting flags share one
+        tagged word, so every state change is a single CAS. A writer that can't
+        acquire sets the waiting flag, which blocks new readers until the waiting
+        writers have run. A release wakes the highest priority waiting writer if
+        there is one, otherwise the highest priority waiting reader.
+
+        Barrier:
+        A PEND operation arrives at the barrier by adding the thread to the arrived
+        list. The last arrival moves the whole arrived list to the released list in
+        one step and continues, each released thread succeeds when it is next tried.
+        A timed out thread is removed from the arrived list. POST is not used.
+
+        Latch:
+        A PEND operation succeeds when the count is zero, so every waiter is
+        released by the POST that counts down to zero. A POST operation decrements
+        the count by val, stopping at zero.
+
+        Notify:
+        The kernel object is embedded in the thread control block and has only one
+        waiter, the owning thread, so its thread lists are not used. A PEND operation
+        succeeds if the thread has been notified and clears the bits in val. A POST
+        operation applies an action to the notification value and wakes the owner
+        if it is waiting. The action is passed in the event p_val field.
 
     eexEventInit is the eventual target of a pend or post macro and configures the
     event fields in a thread or dummys up an event for an interrupt, then tries
@@ -464,7 +1074,7 @@ STATIC bool _eexInScheduler(void) {
     Return tid > evt_thread_priority, the event access was successful and
       unblocked a higher priority thread as well.
     interrupt: pend the scheduler
-    scheduler: pend the scheduler (re-run scheduler after dispatching evt_thread_priority)
+    scheduler: make evt_thread_priority ready and search again in the same pass (wake chain)
     thread:    block
 
  ******************************************************************************/
@@ -508,8 +1118,16 @@ bool eexPendPost(void *func_yield_pt, eex_status_t *p_rtn_status, uint32_t *p_rt
     // pend/post from interrupt, event access was successful and unblocked a thread
     if (f_in_interrupt && (unblock_tid > running_tid)) { eexSchedulerPend(); }
 
-    // pend/post from thread, event access was unsuccessful or was successful and unblocked a thread
-    if (!f_in_interrupt && ((unblock_tid == 0) || (unblock_tid > running_tid))) { f_block = true; }
+    // pend/post from thread, event access was unsuccessful or was successful and unblocked a thread above the threshold
+    if (!f_in_interrupt && ((unblock_tid == 0) || (unblock_tid > _eexThreadThreshold(running_tid)))) { f_block = true; }
+
+    // a thread preempted by the thread it released keeps its threshold until it is dispatched again
+    if (!f_in_interrupt && unblock_tid && (unblock_tid > _eexThreadThreshold(running_tid)) && (p_kobj->type != 'YILD')) {
+        _eexThreadListAdd(&g_thread_preempted_list, running_tid);
+    }
+
+    // a yield always runs the scheduler, the thread is dispatched again when it is the highest priority ready thread
+    if (!f_in_interrupt && (p_kobj->type == 'YILD')) { f_block = true; }
 
     return (f_block);
 }
@@ -533,8 +1151,12 @@ STATIC void _eexEventInit(void *func_yield_pt, eex_status_t *p_rtn_status, uint3
     event->val     = val;
 
     // prospectively add to the kernel object waiting list, won't be acted on unless thread is waiting
-    if (action == EEX_EVENT_PEND) { _eexThreadListAdd(&(p_kobj->pend), tid); }
-    if (action == EEX_EVENT_POST) { _eexThreadListAdd(&(p_kobj->post), tid); }
+    // a notification's only waiter is its owner, it has no lists
+    if ((action == EEX_EVENT_PEND) && (p_kobj->type != 'NTFY')) { _eexThreadListAdd(&(p_kobj->pend), tid); }
+    if ((action == EEX_EVENT_POST) && (p_kobj->type != 'NTFY')) { _eexThreadListAdd(&(p_kobj->post), tid); }
+
+    // an abort requested before this wait started was for an earlier wait
+    _eexThreadListDel(&g_thread_abort_list, tid);
 
     // timeout handling
     // Normal timeout - add the current time to timeout to get the clock time for the timeout
@@ -551,6 +1173,26 @@ STATIC void _eexEventInit(void *func_yield_pt, eex_status_t *p_rtn_status, uint3
         if (event->timeout == 0)              { event->timeout = 1; }             // don't allow it to expire on 0
         if (event->timeout == eexWaitForever) { event->timeout = 1; }             // or expire on eexWaitForever
     }
+
+    // Periodic release - the timeout is the thread's next release time, absolute so it doesn't drift
+    //                    a release that passed a whole period or more ago is skipped and counted as missed
+    if (p_kobj->type == 'PERD') {
+        uint32_t  missed = 0;
+        int32_t   late;
+
+        assert (tcb->period.period);
+        late = eexTimeDiff(eexKernelTime(NULL), tcb->period.next);
+        if (late >= (int32_t) tcb->period.period) {
+            missed = (uint32_t) late / tcb->period.period;
+            tcb->period.next     += missed * tcb->period.period;
+            tcb->period.n_missed += missed;
+        }
+        event->timeout = tcb->period.next;
+        if (event->timeout == 0)              { event->timeout = 1; }
+        if (event->timeout == eexWaitForever) { event->timeout = 1; }
+        tcb->period.next += tcb->period.period;
+        if (p_rtn_val != NULL) { *p_rtn_val = missed; }
+    }
 }
 
 // Remove an event from a thread and clean up after a timeout or event completion.
@@ -559,8 +1201,8 @@ STATIC void _eexEventRemove(eex_thread_id_t tid, eex_thread_event_t *event, eex_
     assert (event);
     assert (event->kobj);
 
-    // clean up event wait lists except for interrupt events
-    if (!eexInInterrupt() || _eexInScheduler()) { // scheduler doesn't count as an interrupt, it trying thread events by proxy
+    // clean up event wait lists except for interrupt events and notifications
+    if ((!eexInInterrupt() || _eexInScheduler()) && (event->kobj->type != 'NTFY')) { // scheduler doesn't count as an interrupt, it trying thread events by proxy
         _eexThreadListDel(&(event->kobj->pend), tid);
         _eexThreadListDel(&(event->kobj->post), tid);
     }
@@ -573,7 +1215,7 @@ STATIC eex_thread_id_t _eexEventTry(eex_thread_id_t evt_thread_priority, eex_thr
     eex_kobj_cb_t    *p_kobj;
     eex_thread_id_t   hpt;
     uint32_t          unblock;
-    bool              f_pend, f_post, try_rslt;
+    bool              f_pend, f_post, try_rslt, aborted;
 
     assert(event);
     assert(event->kobj);
@@ -583,9 +1225,18 @@ STATIC eex_thread_id_t _eexEventTry(eex_thread_id_t evt_thread_priority, eex_thr
     f_post = (event->action == EEX_EVENT_POST);
     assert(f_pend || f_post);
 
+    // test for an aborted wait, interrupt events are never aborted
+    aborted = (!eexInInterrupt() || _eexInScheduler()) && _eexThreadListContains(&g_thread_abort_list, evt_thread_priority);
+
     // test for timeout
-    if (EEX_TIMEOUT_EXPIRED(event->timeout)) {
-        _eexEventRemove(evt_thread_priority, event, eexStatusThreadTimeout);
+    if (aborted || EEX_TIMEOUT_EXPIRED(event->timeout)) {
+        if ((p_kobj->type == 'OBUF') && f_pend) { ((eex_obuf_cb_t *) p_kobj)->n_failed++; }
+        if ((p_kobj->type == 'BARR') && f_pend) { _eexThreadListDel(&(((eex_barrier_cb_t *) p_kobj)->arrived), evt_thread_priority); }
+        if ((p_kobj->type == 'SIGL') && f_pend) { _eexThreadListDel(&(((eex_signal_cb_t *) p_kobj)->released), evt_thread_priority); }
+        if (aborted) { _eexThreadListDel(&g_thread_abort_list, evt_thread_priority); }
+        if (aborted)                        { _eexEventRemove(evt_thread_priority, event, eexStatusThreadAborted); }
+        else if (p_kobj->type == 'PERD')    { _eexEventRemove(evt_thread_priority, event, eexStatusOK); }     // released
+        else                                { _eexEventRemove(evt_thread_priority, event, eexStatusThreadTimeout); }
         return (evt_thread_priority);
     }
 
@@ -619,7 +1270,7 @@ STATIC eex_thread_id_t _eexEventTry(eex_thread_id_t evt_thread_priority, eex_thr
             break;
 
         case 'SIGL':
-            try_rslt = _eexSignalTry(event);
+            try_rslt = _eexSignalTry(evt_thread_priority, event);
             unblock = evt_thread_priority;              // assume success or non-blocking failure
             if (event->action == EEX_EVENT_PEND) {
                 if (try_rslt) {                         // signal has bit(s) set that we are pending on
@@ -642,41 +1293,281 @@ STATIC eex_thread_id_t _eexEventTry(eex_thread_id_t evt_thread_priority, eex_thr
             }
             break;
 
-        case 'DLAY':
-            unblock = 0;  // timeout hasn't expired, block
+        case 'POOL':
+            try_rslt = _eexPoolTry(event);
+            unblock = evt_thread_priority;              // assume success or non-blocking failure
+            if (event->action == EEX_EVENT_PEND) {      // allocate a block
+                if (try_rslt) {                         // block allocated, address returned in *p_val
+                    assert (!(p_kobj->post));           // threads should never block on a post, so none should be waiting
+                    _eexEventRemove(evt_thread_priority, event, eexStatusOK);
+                }
+                else {                                  // pool empty
+                    if ((event->timeout) == 0)  { _eexEventRemove(evt_thread_priority, event, eexStatusEventNotReady); }  // non-blocking
+                    else                        { unblock = 0; }                                                          // blocking
+                }
+            }
+            else /* EEX_EVENT_POST */ {                 // free a block
+                if (!try_rslt) {                        // not a block from this pool, nothing freed
+                    _eexEventRemove(evt_thread_priority, event, eexStatusKOPoolPtrErr);
+                    break;
+                }
+                _eexEventRemove(evt_thread_priority, event, eexStatusOK);
+                // test if freeing unblocked a waiting higher priority thread
+                hpt = _eexThreadListHPT(p_kobj->pend, EEX_EMPTY_THREAD_LIST);
+                if (hpt > evt_thread_priority) {
+                    unblock = hpt;
+                }
+            }
             break;
 
-        default:
-            assert (0);
-    }
-    return (unblock);
-}
+        case 'STRM':
+            try_rslt = _eexStreamTry(event);
+            unblock = evt_thread_priority;              // assume success or non-blocking failure
+            if (event->action == EEX_EVENT_PEND) {      // wait for data
+                if (try_rslt) {                         // enough bytes available, count returned in *p_val
+                    _eexEventRemove(evt_thread_priority, event, eexStatusOK);
+                }
+                else {                                  // not enough bytes yet
+                    if ((event->timeout) == 0)  { _eexEventRemove(evt_thread_priority, event, eexStatusEventNotReady); }  // non-blocking
+                    else                        { unblock = 0; }                                                          // blocking
+                }
+            }
+            else /* EEX_EVENT_POST */ {                 // commit written bytes
+                _eexEventRemove(evt_thread_priority, event, (try_rslt) ? eexStatusOK : eexStatusKOStreamFull);
+                // test if the consumer is a waiting higher priority thread and now has enough bytes
+                hpt = _eexThreadListHPT(p_kobj->pend, EEX_EMPTY_THREAD_LIST);
+                if ((hpt > evt_thread_priority) &&
+                    ((((eex_stream_cb_t *) p_kobj)->head - ((eex_stream_cb_t *) p_kobj)->tail) >=
+                      _eexStreamNeed((eex_stream_cb_t *) p_kobj, eexThreadTCB(hpt)->event.val))) {
+                    unblock = hpt;
+                }
+            }
+            break;
 
-// Attempt to increment, decrement, or get the current semaphore or mutex value.
-// Return true if successful, false if the resource is not available. Set the event return value to the count value.
-STATIC bool _eexSemaMutexTry(const eex_thread_event_t *event) {
-    eex_sema_mutex_cb_t *sema;
-    eex_tagged_data_t    old_cnt, new_cnt;
-    uint32_t            *rtn_val;
-    bool                 f_pend, f_post;
+        case 'OBUF':
+            try_rslt = _eexObufTry(event);
+            unblock = evt_thread_priority;              // assume success or non-blocking failure
+            if (event->action == EEX_EVENT_PEND) {      // allocate a block
+                if (try_rslt) {                         // block allocated, address returned in *p_val
+                    _eexEventRemove(evt_thread_priority, event, eexStatusOK);
+                }
+                else {                                  // doesn't fit
+                    if ((event->timeout) == 0)  { ((eex_obuf_cb_t *) p_kobj)->n_failed++;
+                                                  _eexEventRemove(evt_thread_priority, event, eexStatusEventNotReady); }  // non-blocking
+                    else                        { unblock = 0; }                                                          // blocking
+                }
+            }
+            else /* EEX_EVENT_POST */ {                 // free a block
+                _eexEventRemove(evt_thread_priority, event, (try_rslt) ? eexStatusOK : eexStatusKOObufPtrErr);
+                // test if the producer is a waiting higher priority thread and its request now fits
+                hpt = _eexThreadListHPT(p_kobj->pend, EEX_EMPTY_THREAD_LIST);
+                if ((hpt > evt_thread_priority) &&
+                    _eexObufPlace((eex_obuf_cb_t *) p_kobj, ((eex_obuf_cb_t *) p_kobj)->idx.ht,
+                                  EEX_OBUF_WORDS(eexThreadTCB(hpt)->event.val), NULL)) {
+                    unblock = hpt;
+                }
+            }
+            break;
 
-    assert (event);
-    assert (event->kobj);
+        case 'COND':
+            try_rslt = _eexCondTry(evt_thread_priority, event);
+            unblock = evt_thread_priority;              // assume success or non-blocking failure
+            if (event->action == EEX_EVENT_PEND) {      // wait
+                if (try_rslt) {                         // signaled, event now pends on the mutex
+                    unblock = _eexEventTry(evt_thread_priority, event);
+                }
+                else {                                  // not signaled
+                    if ((event->timeout) == 0)  { _eexEventRemove(evt_thread_priority, event, eexStatusEventNotReady); }  // non-blocking
+                    else                        { unblock = 0; }                                                          // blocking
+                }
+            }
+            else /* EEX_EVENT_POST */ {                 // signal or broadcast
+                _eexEventRemove(evt_thread_priority, event, eexStatusOK);
+                // test if signaling unblocked a waiting higher priority thread
+                hpt = _eexThreadListHPT(((eex_cond_cb_t *) p_kobj)->signaled, EEX_EMPTY_THREAD_LIST);
+                if (hpt > evt_thread_priority) {
+                    unblock = hpt;
+                }
+            }
+            break;
 
-    sema    = (eex_sema_mutex_cb_t *) event->kobj;
-    rtn_val = event->p_val;
-    f_pend  = (event->action == EEX_EVENT_PEND);
-    f_post  = (event->action == EEX_EVENT_POST);
-    assert(f_pend || f_post);
+        case 'RWLK':
+            try_rslt = _eexRWLockTry(evt_thread_priority, event);
+            unblock = evt_thread_priority;              // assume success or non-blocking failure
+            if (event->action == EEX_EVENT_PEND) {      // acquire
+                if (try_rslt) {
+                    assert (!(p_kobj->post));           // threads should never block on a post, so none should be waiting
+                    _eexEventRemove(evt_thread_priority, event, eexStatusOK);
+                }
+                else {                                  // held by a writer, or by readers with a writer waiting
+                    if ((event->timeout) == 0)  { _eexEventRemove(evt_thread_priority, event, eexStatusEventNotReady); }  // non-blocking
+                    else                        { unblock = 0; }                                                          // blocking
+                }
+            }
+            else /* EEX_EVENT_POST */ {                 // release
+                if (!try_rslt) { assert(0); }           // should never fail
+                _eexEventRemove(evt_thread_priority, event, eexStatusOK);
+                // if the lock is free, test if a waiting writer, or reader if no writers, has a higher priority
+                if (!(((eex_rwlock_cb_t *) p_kobj)->count.data & (EEX_RWLOCK_WRITER_HELD | EEX_RWLOCK_READERS))) {
+                    hpt = _eexThreadListHPT(p_kobj->pend & ((eex_rwlock_cb_t *) p_kobj)->writers, EEX_EMPTY_THREAD_LIST);
+                    if (hpt == 0) { hpt = _eexThreadListHPT(p_kobj->pend, EEX_EMPTY_THREAD_LIST); }
+                    if (hpt > evt_thread_priority) {
+                        unblock = hpt;
+                    }
+                }
+            }
+            break;
 
-    do {
-        old_cnt.td = sema->count.td;
-        if (rtn_val) { *rtn_val = (uint32_t) old_cnt.data; }
-        if (f_pend && (old_cnt.data == 0))                                          { return (false); }   // semaphore/mutex not available
-        if (f_post && (sema->cb.type == 'SEMA') && (old_cnt.data == sema->max_val)) { return (false); }   // semaphores all taken
-        new_cnt = _eexNewTaggedData((uint16_t) (old_cnt.data + (f_post ? 1 : -1)));
-        if (rtn_val) { *rtn_val = (uint32_t) new_cnt.data; }
-    } while(eexCPUAtomic32CAS(&(sema->count.td), old_cnt.td, new_cnt.td));
+        case 'BARR':
+            assert (event->action == EEX_EVENT_PEND);   // there is no post to a barrier
+            try_rslt = _eexBarrierTry(evt_thread_priority, event);
+            unblock = evt_thread_priority;              // assume success or non-blocking failure
+            if (try_rslt) {                             // released, or the last arrival
+                _eexEventRemove(evt_thread_priority, event, eexStatusOK);
+                // test if the last arrival released a waiting higher priority thread
+                hpt = _eexThreadListHPT(((eex_barrier_cb_t *) p_kobj)->released, EEX_EMPTY_THREAD_LIST);
+                if (hpt > evt_thread_priority) {
+                    unblock = hpt;
+                }
+            }
+            else {                                      // waiting for the rest of the parties
+                if ((event->timeout) == 0)  { _eexEventRemove(evt_thread_priority, event, eexStatusEventNotReady); }  // non-blocking
+                else                        { unblock = 0; }                                                          // blocking
+            }
+            break;
+
+        case 'LTCH':
+            try_rslt = _eexLatchTry(event);
+            unblock = evt_thread_priority;              // assume success or non-blocking failure
+            if (event->action == EEX_EVENT_PEND) {      // wait for the count to reach zero
+                if (try_rslt) {
+                    _eexEventRemove(evt_thread_priority, event, eexStatusOK);
+                }
+                else {                                  // count is not zero
+                    if ((event->timeout) == 0)  { _eexEventRemove(evt_thread_priority, event, eexStatusEventNotReady); }  // non-blocking
+                    else                        { unblock = 0; }                                                          // blocking
+                }
+            }
+            else /* EEX_EVENT_POST */ {                 // count down
+                _eexEventRemove(evt_thread_priority, event, eexStatusOK);
+                // test if the latch opened and releases a waiting higher priority thread
+                hpt = _eexThreadListHPT(p_kobj->pend, EEX_EMPTY_THREAD_LIST);
+                if (try_rslt && (hpt > evt_thread_priority)) {
+                    unblock = hpt;
+                }
+            }
+            break;
+
+        case 'JOIN':
+            try_rslt = _eexJoinTry(evt_thread_priority, event);
+            unblock = evt_thread_priority;              // assume success or non-blocking failure
+            if (event->action == EEX_EVENT_PEND) {      // wait for the thread to exit
+                if (try_rslt) {                         // exited, exit code returned in *p_val
+                    _eexEventRemove(evt_thread_priority, event, eexStatusOK);
+                }
+                else {                                  // still running
+                    if ((event->timeout) == 0)  { _eexEventRemove(evt_thread_priority, event, eexStatusEventNotReady); }  // non-blocking
+                    else                        { unblock = 0; }                                                          // blocking
+                }
+            }
+            else /* EEX_EVENT_POST */ {                 // exit
+                _eexEventRemove(evt_thread_priority, event, eexStatusOK);
+                // test if a higher priority joiner was released
+                hpt = _eexThreadListHPT(p_kobj->pend, EEX_EMPTY_THREAD_LIST);
+                if (hpt > evt_thread_priority) {
+                    unblock = hpt;
+                }
+            }
+            break;
+
+        case 'NTFY':
+            try_rslt = _eexNotifyTry(evt_thread_priority, event);
+            unblock = evt_thread_priority;              // assume success or non-blocking failure
+            if (event->action == EEX_EVENT_PEND) {      // wait for a notification
+                if (try_rslt) {                         // notified, value returned in *p_val
+                    _eexEventRemove(evt_thread_priority, event, eexStatusOK);
+                }
+                else {                                  // not notified
+                    if ((event->timeout) == 0)  { _eexEventRemove(evt_thread_priority, event, eexStatusEventNotReady); }  // non-blocking
+                    else                        { unblock = 0; }                                                          // blocking
+                }
+            }
+            else /* EEX_EVENT_POST */ {                 // notify
+                _eexEventRemove(evt_thread_priority, event, eexStatusOK);
+                // test if the owner is a waiting higher priority thread
+                hpt = _eexThreadKobjOwner(p_kobj);
+                if ((hpt > evt_thread_priority) && (eexThreadTCB(hpt)->event.kobj == p_kobj)) {
+                    unblock = hpt;
+                }
+            }
+            break;
+
+        case 'YILD':
+            _eexEventRemove(evt_thread_priority, event, eexStatusOK);
+            unblock = evt_thread_priority;              // never waits, eexPendPost blocks the thread
+            break;
+
+        case 'TTRG':
+            assert (event->action == EEX_EVENT_PEND);   // threads are released by the table, there is no post
+            try_rslt = _eexTableTry(evt_thread_priority, event);
+            unblock = evt_thread_priority;              // assume success or non-blocking failure
+            if (try_rslt) {                             // released, jitter returned in *p_val
+                _eexEventRemove(evt_thread_priority, event, eexStatusOK);
+            }
+            else {                                      // not released yet
+                if ((event->timeout) == 0)  { _eexEventRemove(evt_thread_priority, event, eexStatusEventNotReady); }  // non-blocking
+                else                        { unblock = 0; }                                                          // blocking
+            }
+            break;
+
+        case 'DEFR':
+            assert (event->action == EEX_EVENT_PEND);   // items are pushed by eexDefer, there is no post
+            unblock = evt_thread_priority;              // assume success or non-blocking failure
+            if (g_defer_head != NULL) {                 // the thread takes the items itself
+                _eexEventRemove(evt_thread_priority, event, eexStatusOK);
+            }
+            else {
+                if ((event->timeout) == 0)  { _eexEventRemove(evt_thread_priority, event, eexStatusEventNotReady); }  // non-blocking
+                else                        { unblock = 0; }                                                          // blocking
+            }
+            break;
+
+        case 'DLAY':
+        case 'PERD':
+            unblock = 0;  // timeout hasn't expired, block
+            break;
+
+        default:
+            assert (0);
+    }
+    return (unblock);
+}
+
+// Attempt to increment, decrement, or get the current semaphore or mutex value.
+// Return true if successful, false if the resource is not available. Set the event return value to the count value.
+STATIC bool _eexSemaMutexTry(const eex_thread_event_t *event) {
+    eex_sema_mutex_cb_t *sema;
+    eex_tagged_data_t    old_cnt, new_cnt;
+    uint32_t            *rtn_val;
+    bool                 f_pend, f_post;
+
+    assert (event);
+    assert (event->kobj);
+
+    sema    = (eex_sema_mutex_cb_t *) event->kobj;
+    rtn_val = event->p_val;
+    f_pend  = (event->action == EEX_EVENT_PEND);
+    f_post  = (event->action == EEX_EVENT_POST);
+    assert(f_pend || f_post);
+
+    do {
+        old_cnt.td = sema->count.td;
+        if (rtn_val) { *rtn_val = (uint32_t) old_cnt.data; }
+        if (f_pend && (old_cnt.data == 0))                                          { return (false); }   // semaphore/mutex not available
+        if (f_post && (sema->cb.type == 'SEMA') && (old_cnt.data == sema->max_val)) { return (false); }   // semaphores all taken
+        new_cnt = _eexNewTaggedData((eex_count_t) (old_cnt.data + (f_post ? 1 : -1)));
+        if (rtn_val) { *rtn_val = (uint32_t) new_cnt.data; }
+    } while(EEX_TAGGED_CAS(&(sema->count.td), old_cnt.td, new_cnt.td));
 
     assert (sema->count.data <= sema->max_val);                               // semaphore/mutex overflow
     assert (!((sema->cb.type == 'MUTX') && f_post && (old_cnt.data == 1)));   // recursive mutexes are NOT supported
@@ -685,9 +1576,9 @@ STATIC bool _eexSemaMutexTry(const eex_thread_event_t *event) {
 }
 
 // Set or read signal bits.
-// Return true if any mask bits match their associated signal bits.
-// Set the event return value to the bits that match, and clear those bits in signal.
-STATIC bool _eexSignalTry(const eex_thread_event_t *event) {
+// Return true if any mask bits match their associated signal bits, or a broadcast post released the thread.
+// Set the event return value to the bits that match, and clear those bits in signal unless it is a broadcast signal.
+STATIC bool _eexSignalTry(eex_thread_id_t tid, const eex_thread_event_t *event) {
     eex_signal_cb_t    *p_signal_cb;
     eex_signal_t       *p_signal, signal, new_signal, set_bits;
     bool                f_pend, f_post;
@@ -704,14 +1595,659 @@ STATIC bool _eexSignalTry(const eex_thread_event_t *event) {
     do {
         signal   = *p_signal;
         set_bits = signal & event->val;                     // val is mask if pend
-        if (f_pend) { new_signal = signal & ~set_bits; }    // clear signaled bits
+        if (f_pend) { new_signal = (p_signal_cb->manual) ? signal : (signal & ~set_bits); }  // clear signaled bits
         else        { new_signal = signal | event->val; }   // add new bits to signal is post
     } while(eexCPUAtomic32CAS(p_signal, signal, new_signal));
 
+    // a broadcast post releases the waiters that match it now, an interrupt's pend never takes
+    // the release of the thread it interrupted
+    if (p_signal_cb->manual && f_post) { _eexSignalRelease(p_signal_cb, new_signal); }
+    if (p_signal_cb->manual && f_pend && (!eexInInterrupt() || _eexInScheduler()) && _eexThreadListContains(&(p_signal_cb->released), tid)) {
+        _eexThreadListDel(&(p_signal_cb->released), tid);
+        if (!set_bits) { set_bits = event->val; }           // cleared since, val was narrowed to the bits that released it
+    }
+
     if (event->p_val) { *(event->p_val) = set_bits; }       // n/a if post
     return((f_post) ? true : (bool) set_bits);              // post always succeeds
 }
 
+// Release the threads waiting on a broadcast signal whose masks match signal. A released thread's
+// mask is narrowed to the bits that released it, which are returned when it is tried.
+STATIC void _eexSignalRelease(eex_signal_cb_t *p_signal_cb, eex_signal_t signal) {
+    eex_thread_list_t   waiters = p_signal_cb->cb.pend & ~p_signal_cb->released;
+    eex_thread_event_t *event;
+    eex_thread_id_t     tid;
+
+    while (waiters) {
+        tid   = _eexThreadListHPT(waiters, EEX_EMPTY_THREAD_LIST);
+        _eexThreadListDel(&waiters, tid);
+        event = &(eexThreadTCB(tid)->event);
+        if ((event->kobj == &(p_signal_cb->cb)) && (event->action == EEX_EVENT_PEND) && (event->val & signal)) {
+            event->val &= signal;
+            _eexThreadListAdd(&(p_signal_cb->released), tid);
+        }
+    }
+}
+
+// Allocate or free a pool block.
+// A pend pops the free list, or if it is empty takes the next never-allocated block.
+// Set the event return value to the block address, or 0 if the pool is empty.
+// A post pushes the block addressed by the event value onto the free list. An allocated
+// block's link is EEX_POOL_BLK_ALLOCATED and the post claims it with a CAS before the
+// push, so of two frees of a block, even racing ones, only the first succeeds.
+// Return false if the pool is empty (pend) or the address is not an allocated pool block (post).
+STATIC bool _eexPoolTry(const eex_thread_event_t *event) {
+    eex_pool_cb_t      *pool;
+    eex_tagged_data_t   old_free, new_free;
+    uint32_t            fresh, blk, offset;
+    bool                f_pend, f_post;
+
+    assert (event);
+    assert (event->kobj);
+
+    pool   = (eex_pool_cb_t *) event->kobj;
+    f_pend = (event->action == EEX_EVENT_PEND);
+    f_post = (event->action == EEX_EVENT_POST);
+    assert(f_pend || f_post);
+
+    if (f_pend) {
+        for (;;) {
+            old_free.td = pool->free.td;
+            if (old_free.data != 0) {                           // pop the head of the free list
+                new_free = _eexNewTaggedData(pool->link[old_free.data]);
+                if (EEX_TAGGED_CAS(&(pool->free.td), old_free.td, new_free.td)) { continue; }
+                blk = old_free.data;
+                break;
+            }
+            fresh = pool->fresh;
+            if (fresh < pool->n_blks) {                         // free list empty, take a never-allocated block
+                if (eexCPUAtomic32CAS(&(pool->fresh), fresh, fresh + 1)) { continue; }
+                blk = fresh + 1;
+                break;
+            }
+            if (pool->free.data == 0) {                         // pool exhausted
+                if (event->p_val) { *(event->p_val) = 0; }
+                return (false);
+            }
+        }
+        pool->link[blk] = EEX_POOL_BLK_ALLOCATED;
+        if (event->p_val) { *(event->p_val) = (uint32_t) (uintptr_t) &(pool->mem[(blk - 1) * pool->blk_size]); }
+        return (true);
+    }
+
+    // post - validate the address, then push the block onto the free list
+    offset = event->val - (uint32_t) (uintptr_t) pool->mem;
+    if ((offset % pool->blk_size) || (offset >= ((uint32_t) pool->n_blks * pool->blk_size))) { return (false); }
+    blk = (offset / pool->blk_size) + 1;
+    if (blk > pool->fresh) { return (false); }  // never allocated
+    if (eexCPUAtomic32CAS(&(pool->link[blk]), EEX_POOL_BLK_ALLOCATED, EEX_POOL_BLK_FREEING)) { return (false); }  // already free or being freed
+
+    do {
+        old_free.td     = pool->free.td;
+        pool->link[blk] = old_free.data;
+        new_free        = _eexNewTaggedData((eex_count_t) blk);
+    } while(EEX_TAGGED_CAS(&(pool->free.td), old_free.td, new_free.td));
+
+    return (true);
+}
+
+
+// Number of bytes a consumer pending for n_bytes waits for. Never more than the ring holds.
+STATIC uint32_t _eexStreamNeed(const eex_stream_cb_t *stream, uint32_t n_bytes) {
+    if (n_bytes == 0)            { n_bytes = stream->trigger; }
+    if (n_bytes == 0)            { n_bytes = 1; }
+    if (n_bytes > stream->size)  { n_bytes = stream->size; }
+    return (n_bytes);
+}
+
+// Wait for or commit stream bytes.
+// A pend returns true if the requested number of bytes is available, and sets the event
+// return value to the number of bytes available.
+// A post commits val bytes written into the write span. Return false if they don't fit.
+STATIC bool _eexStreamTry(const eex_thread_event_t *event) {
+    eex_stream_cb_t *stream;
+    uint32_t         used;
+    bool             f_pend, f_post;
+
+    assert (event);
+    assert (event->kobj);
+
+    stream = (eex_stream_cb_t *) event->kobj;
+    f_pend = (event->action == EEX_EVENT_PEND);
+    f_post = (event->action == EEX_EVENT_POST);
+    assert(f_pend || f_post);
+
+    used = stream->head - stream->tail;
+    if (f_pend) {
+        if (event->p_val) { *(event->p_val) = used; }
+        return (used >= _eexStreamNeed(stream, event->val));
+    }
+
+    if (event->val > (stream->size - used)) { return (false); }
+    stream->head += event->val;   // only the producer moves head
+    return (true);
+}
+
+
+// Find room for a block of n_words in the ring described by ht.
+// Return the ring indices after allocating, or 0 if the block doesn't fit. The index of
+// the block header is returned in *p_start if p_start is not NULL.
+// A block never wraps. If it doesn't fit at the end of the ring the remainder becomes a
+// pad block and the block is placed at the start. One word is always left unused so a full
+// ring can be told from an empty one, which means 0 is never a valid result.
+STATIC uint32_t _eexObufPlace(const eex_obuf_cb_t *obuf, uint32_t ht, uint32_t n_words, uint32_t *p_start) {
+    uint32_t head = ht >> 16;
+    uint32_t tail = ht & 0xffff;
+    uint32_t start = head;
+
+    if (head == tail) { head = tail = start = 0; }              // empty, start over at the beginning
+
+    if (head >= tail) {
+        if ((head + n_words) < obuf->n_words)                   { ht = EEX_OBUF_HT(head + n_words, tail); }
+        else if (((head + n_words) == obuf->n_words) && tail)   { ht = EEX_OBUF_HT(0, tail); }
+        else if (n_words < tail)                                { ht = EEX_OBUF_HT(n_words, tail); start = 0; }   // wrap
+        else                                                    { ht = 0; }
+    }
+    else {
+        ht = ((head + n_words) < tail) ? EEX_OBUF_HT(head + n_words, tail) : 0;
+    }
+    if (p_start) { *p_start = start; }
+    return (ht);
+}
+
+// Allocate or free an ordered buffer block.
+// A pend returns true if val bytes were allocated, and sets the event return value to the
+// block address. Only one thread may allocate from a buffer.
+// A post frees the block at address val and reclaims all freed blocks at the tail of
+// the ring. An address outside of the ring is ignored. Return false if the address is in
+// the ring but isn't an allocated block.
+STATIC bool _eexObufTry(const eex_thread_event_t *event) {
+    eex_obuf_cb_t   *obuf;
+    eex_obuf_index_t old_idx, new_idx;
+    uint32_t         n_words, start, head, offset, hdr, free;
+    bool             f_pend, f_post;
+
+    assert (event);
+    assert (event->kobj);
+
+    obuf   = (eex_obuf_cb_t *) event->kobj;
+    f_pend = (event->action == EEX_EVENT_PEND);
+    f_post = (event->action == EEX_EVENT_POST);
+    assert(f_pend || f_post);
+
+    if (f_pend) {
+        n_words = EEX_OBUF_WORDS(event->val);
+        do {
+            old_idx.ht = obuf->idx.ht;
+            new_idx.ht = _eexObufPlace(obuf, old_idx.ht, n_words, &start);
+            if (new_idx.ht == 0) {
+                if (event->p_val) { *(event->p_val) = 0; }
+                return (false);
+            }
+            // the producer owns the ring from head to tail, so headers are written before publishing
+            head = (old_idx.head == old_idx.tail) ? 0 : old_idx.head;
+            if (start != head) { obuf->buf[head] = (obuf->n_words - head) | EEX_OBUF_FREED; }   // pad to the end of the ring
+            obuf->buf[start] = n_words;
+        } while(eexCPUAtomic32CAS(&(obuf->idx.ht), old_idx.ht, new_idx.ht));
+
+        free = obuf->n_words - 1 - ((new_idx.head - new_idx.tail + obuf->n_words) % obuf->n_words);
+        if (free < obuf->min_free) { obuf->min_free = (uint16_t) free; }
+        if (event->p_val) { *(event->p_val) = (uint32_t) (uintptr_t) &(obuf->buf[start + 1]); }
+        return (true);
+    }
+
+    // post - ignore addresses outside of the ring, validate the block header and mark it freed
+    offset = event->val - (uint32_t) (uintptr_t) obuf->buf;
+    if (offset >= ((uint32_t) obuf->n_words * 4)) { return (true); }
+    if ((offset % 4) || (offset == 0)) { return (false); }
+    hdr = obuf->buf[(offset / 4) - 1];
+    if ((hdr & EEX_OBUF_FREED) || ((hdr & 0xffff) == 0)) { return (false); }
+    obuf->buf[(offset / 4) - 1] = hdr | EEX_OBUF_FREED;
+
+    // reclaim freed blocks from the tail. Frees may come from any context, the CAS
+    // fails and the loop retries if another free or an allocation moved the indices.
+    for (;;) {
+        old_idx.ht = obuf->idx.ht;
+        if (old_idx.head == old_idx.tail) { break; }
+        hdr = obuf->buf[old_idx.tail];
+        if (!(hdr & EEX_OBUF_FREED)) { break; }
+        new_idx.ht   = old_idx.ht;
+        new_idx.tail = (uint16_t) ((old_idx.tail + (hdr & 0xffff)) % obuf->n_words);
+        (void) eexCPUAtomic32CAS(&(obuf->idx.ht), old_idx.ht, new_idx.ht);
+    }
+    return (true);
+}
+
+// Wait on or signal a condition variable.
+// A pend releases the mutex on the first try. Return true if the thread has been signaled,
+// the event is then converted to a pend on the mutex and must be tried again.
+// A post always succeeds. Signaling with no threads waiting has no effect.
+STATIC bool _eexCondTry(eex_thread_id_t tid, eex_thread_event_t *event) {
+    eex_cond_cb_t       *cond;
+    eex_sema_mutex_cb_t *mutex;
+    eex_thread_event_t   release;
+    eex_thread_id_t      hpt;
+    uint32_t             old_sig, new_sig;
+    bool                 f_pend, f_post;
+
+    assert (event);
+    assert (event->kobj);
+
+    cond   = (eex_cond_cb_t *) event->kobj;
+    f_pend = (event->action == EEX_EVENT_PEND);
+    f_post = (event->action == EEX_EVENT_POST);
+    assert(f_pend || f_post);
+
+    if (f_pend) {
+        mutex = (eex_sema_mutex_cb_t *) (uintptr_t) (event->val & ~EEX_COND_MUTEX_RELEASED);
+        assert (mutex && (mutex->cb.type == 'MUTX'));
+        if (!(event->val & EEX_COND_MUTEX_RELEASED)) {          // first try, release the mutex
+            assert (mutex->owner_id == tid);                    // waiting requires holding the mutex
+            _eexThreadListDel(&(cond->signaled), tid);          // discard a signal left over from a timed out wait
+            (void) memset(&release, 0, sizeof(release));
+            release.kobj   = (eex_kobj_cb_t *) mutex;
+            release.action = EEX_EVENT_POST;
+            mutex->owner_id = 0;
+            (void) _eexSemaMutexTry(&release);
+            event->val |= EEX_COND_MUTEX_RELEASED;
+        }
+        if (!_eexThreadListContains(&(cond->signaled), tid)) { return (false); }
+
+        // signaled, move from the condition to the mutex
+        _eexThreadListDel(&(cond->signaled), tid);
+        _eexThreadListDel(&(cond->cb.pend), tid);
+        _eexThreadListAdd(&(mutex->cb.pend), tid);
+        event->kobj = (eex_kobj_cb_t *) mutex;
+        event->val  = 0;
+        return (true);
+    }
+
+    // post - mark waiters that have not already been signaled
+    do {
+        old_sig = cond->signaled;
+        if (event->val == EEX_COND_SIGNAL_ALL) {
+            new_sig = old_sig | cond->cb.pend;
+        }
+        else {
+            hpt = _eexThreadListHPT(cond->cb.pend, old_sig);
+            if (hpt == 0) { break; }
+            new_sig = old_sig | (0x80000000u >> (32 - hpt));
+        }
+    } while(eexCPUAtomic32CAS(&(cond->signaled), old_sig, new_sig));
+    return (true);
+}
+
+// Acquire or release a reader-writer lock.
+// A pend returns true if the lock was acquired for reading or writing, as selected by val.
+// A post releases the lock and always succeeds.
+STATIC bool _eexRWLockTry(eex_thread_id_t tid, const eex_thread_event_t *event) {
+    eex_rwlock_cb_t     *rwl;
+    eex_tagged_data_t    old_cnt, new_cnt;
+    eex_count_t          data;
+    bool                 f_pend, f_post, f_write, f_thread;
+
+    assert (event);
+    assert (event->kobj);
+
+    rwl      = (eex_rwlock_cb_t *) event->kobj;
+    f_thread = (!eexInInterrupt() || _eexInScheduler());   // interrupt handlers aren't on any thread list
+    f_pend  = (event->action == EEX_EVENT_PEND);
+    f_post  = (event->action == EEX_EVENT_POST);
+    f_write = (event->val == EEX_RWLOCK_WRITE);
+    assert(f_pend || f_post);
+    assert(f_write || (event->val == EEX_RWLOCK_READ));
+    assert(f_thread || !f_write);                       // writers must be threads
+
+    if (f_pend && f_write)                { _eexThreadListAdd(&(rwl->writers), tid); }
+    if (f_pend && !f_write && f_thread)   { _eexThreadListDel(&(rwl->writers), tid); }   // may be left over from a timed out write
+    if (f_post && f_write) {                            // only the writer can release, clear its id before another writer can acquire
+        assert (rwl->writer_id == tid);
+        rwl->writer_id = 0;
+    }
+
+    for (;;) {
+        old_cnt.td = rwl->count.td;
+        data       = old_cnt.data;
+
+        if (f_pend && !f_write) {               // acquire for reading
+            if (data & EEX_RWLOCK_WRITER_HELD) { return (false); }
+            if (data & EEX_RWLOCK_WRITER_WAITING) {
+                if (rwl->cb.pend & rwl->writers) { return (false); }
+                data &= ~EEX_RWLOCK_WRITER_WAITING;             // waiting writers timed out, clear the stale flag
+            }
+            assert ((data & EEX_RWLOCK_READERS) != EEX_RWLOCK_READERS);
+            data++;
+        }
+        else if (f_pend) {                      // acquire for writing
+            if ((data & (EEX_RWLOCK_WRITER_HELD | EEX_RWLOCK_READERS)) == 0) {
+                data = EEX_RWLOCK_WRITER_HELD;
+                if (rwl->cb.pend & rwl->writers & ~(0x80000000u >> (32 - tid))) { data |= EEX_RWLOCK_WRITER_WAITING; }
+            }
+            else {
+                if (data & EEX_RWLOCK_WRITER_WAITING) { return (false); }
+                data |= EEX_RWLOCK_WRITER_WAITING;              // block new readers
+            }
+        }
+        else if (!f_write) {                    // release a read lock
+            assert (data & EEX_RWLOCK_READERS);
+            data--;
+        }
+        else {                                  // release the write lock
+            assert (data & EEX_RWLOCK_WRITER_HELD);
+            data &= ~EEX_RWLOCK_WRITER_HELD;
+        }
+
+        new_cnt = _eexNewTaggedData(data);
+        if (EEX_TAGGED_CAS(&(rwl->count.td), old_cnt.td, new_cnt.td)) { continue; }
+        if (f_pend && f_write) {
+            if (!(data & EEX_RWLOCK_WRITER_HELD) || (old_cnt.data & EEX_RWLOCK_WRITER_HELD)) { return (false); }  // only set the waiting flag
+            _eexThreadListDel(&(rwl->writers), tid);
+            rwl->writer_id = (uint16_t) tid;
+        }
+        return (true);
+    }
+}
+
+// Arrive at or wait on a barrier.
+// Return true if the thread is the last arrival, which releases the other parties, or has been released.
+// A non-blocking pend that is not the last arrival returns false without arriving.
+STATIC bool _eexBarrierTry(eex_thread_id_t tid, eex_thread_event_t *event) {
+    eex_barrier_cb_t    *barrier;
+    uint32_t             old_arr, new_arr, old_rel;
+
+    assert (event);
+    assert (event->kobj);
+    assert (tid != 0);                                  // interrupts and thread 0 can't wait
+
+    barrier = (eex_barrier_cb_t *) event->kobj;
+
+    if (event->val & EEX_BARRIER_ARRIVED) {             // waiting, test for release
+        if (!_eexThreadListContains(&(barrier->released), tid)) { return (false); }
+        _eexThreadListDel(&(barrier->released), tid);
+        return (true);
+    }
+
+    _eexThreadListDel(&(barrier->released), tid);       // discard a release that raced a timeout
+    do {
+        old_arr = barrier->arrived;
+        if ((_eexBMCount(old_arr) + 1) >= barrier->parties) { new_arr = EEX_EMPTY_THREAD_LIST; }
+        else if (event->timeout == 0)                       { return (false); }
+        else                                                { new_arr = old_arr | (0x80000000u >> (32 - tid)); }
+    } while(eexCPUAtomic32CAS(&(barrier->arrived), old_arr, new_arr));
+
+    if (new_arr) {
+        event->val |= EEX_BARRIER_ARRIVED;
+        return (false);
+    }
+
+    // last arrival, release everyone that arrived before it
+    do {
+        old_rel = barrier->released;
+    } while(eexCPUAtomic32CAS(&(barrier->released), old_rel, old_rel | old_arr));
+    return (true);
+}
+
+// Wait on or count down a latch.
+// A pend returns true if the count is zero. A post returns true if it brought the count to zero.
+STATIC bool _eexLatchTry(const eex_thread_event_t *event) {
+    eex_latch_cb_t      *latch;
+    eex_tagged_data_t    old_cnt, new_cnt;
+    uint32_t             n;
+
+    assert (event);
+    assert (event->kobj);
+
+    latch = (eex_latch_cb_t *) event->kobj;
+    if (event->action == EEX_EVENT_PEND) { return (latch->count.data == 0); }
+
+    do {
+        old_cnt.td = latch->count.td;
+        if (old_cnt.data == 0) { return (false); }      // already open
+        n = (event->val < old_cnt.data) ? event->val : old_cnt.data;
+        new_cnt = _eexNewTaggedData((eex_count_t) (old_cnt.data - n));
+    } while(EEX_TAGGED_CAS(&(latch->count.td), old_cnt.td, new_cnt.td));
+    return (new_cnt.data == 0);
+}
+
+// Wait for or post a thread notification.
+// A pend returns true if the thread has been notified, sets the event return value to the
+// notification value and clears the bits in the event value. A post always succeeds.
+STATIC bool _eexNotifyTry(eex_thread_id_t tid, const eex_thread_event_t *event) {
+    eex_notify_cb_t     *notify;
+    uint32_t             old_val, new_val;
+
+    assert (event);
+    assert (event->kobj);
+
+    notify = (eex_notify_cb_t *) event->kobj;
+
+    if (event->action == EEX_EVENT_PEND) {
+        assert (!eexInInterrupt() || _eexInScheduler());        // interrupt handlers don't have a notification
+        assert (notify == &(eexThreadTCB(tid)->notify));        // a thread waits only on its own notification
+        if (!notify->pending) { return (false); }
+        notify->pending = 0;                                    // clear before reading, a racing notify wakes again
+        do {
+            old_val = notify->value;
+            new_val = old_val & ~(event->val);
+        } while(eexCPUAtomic32CAS(&(notify->value), old_val, new_val));
+        if (event->p_val) { *(event->p_val) = old_val; }
+        return (true);
+    }
+
+    assert (event->action == EEX_EVENT_POST);
+    do {
+        old_val = notify->value;
+        switch ((uint32_t) (uintptr_t) event->p_val) {
+            case EEX_NOTIFY_NO_VALUE:   new_val = old_val;              break;
+            case EEX_NOTIFY_SET_BITS:   new_val = old_val | event->val; break;
+            case EEX_NOTIFY_INCREMENT:  new_val = old_val + 1;          break;
+            case EEX_NOTIFY_OVERWRITE:  new_val = event->val;           break;
+            default: assert (0);
+        }
+    } while(eexCPUAtomic32CAS(&(notify->value), old_val, new_val));
+    notify->pending = 1;
+    return (true);
+}
+
+// A thread exits by posting its own completion, joiners pend on it.
+STATIC bool _eexJoinTry(eex_thread_id_t tid, const eex_thread_event_t *event) {
+    eex_join_cb_t       *join;
+
+    assert (event);
+    assert (event->kobj);
+
+    join = (eex_join_cb_t *) event->kobj;
+
+    if (event->action == EEX_EVENT_PEND) {
+        if (!join->done) { return (false); }
+        if (event->p_val) { *(event->p_val) = join->exit_code; }
+        return (true);
+    }
+
+    assert (event->action == EEX_EVENT_POST);
+    assert (!eexInInterrupt() || _eexInScheduler());            // interrupt handlers can't exit
+    assert (_eexThreadKobjOwner(event->kobj) == tid);           // a thread exits only itself
+    join->exit_code = event->val;
+    join->free_slot = (uint32_t) (uintptr_t) event->p_val;
+    join->done      = 1;
+    return (true);
+}
+
+// Take the thread's time-triggered release. Return false if it hasn't been released.
+STATIC bool _eexTableTry(eex_thread_id_t tid, const eex_thread_event_t *event) {
+    eex_thread_cb_t     *tcb;
+    uint32_t             jitter_us;
+
+    assert (event);
+    assert (!eexInInterrupt() || _eexInScheduler());            // interrupt handlers can't wait
+    if (!_eexThreadListContains(&g_table_released_list, tid)) { return (false); }
+
+    tcb       = eexThreadTCB(tid);
+    jitter_us = _eexKernelTimeUs() - tcb->table_release_us;
+    _eexThreadListDel(&g_table_released_list, tid);
+    tcb->table.jitter_last_us = jitter_us;
+    if (jitter_us > tcb->table.jitter_max_us) { tcb->table.jitter_max_us = jitter_us; }
+    if (event->p_val) { *(event->p_val) = jitter_us; }
+    return (true);
+}
+
+// Return the thread that a kernel object embedded in a thread control block (notification or completion) belongs to.
+STATIC eex_thread_id_t _eexThreadKobjOwner(const eex_kobj_cb_t *p_kobj) {
+    uintptr_t offset;
+
+    if (p_kobj->type == 'NTFY') { offset = (uintptr_t) p_kobj - (uintptr_t) &(g_thread_tcb[0].notify); }
+    else                        { offset = (uintptr_t) p_kobj - (uintptr_t) &(g_thread_tcb[0].join);   }
+
+    assert ((offset % sizeof(eex_thread_cb_t)) == 0);
+    assert ((offset / sizeof(eex_thread_cb_t)) <= EEX_CFG_THREADS_MAX);
+    return ((eex_thread_id_t) (offset / sizeof(eex_thread_cb_t)));
+}
+
+void eexLatchReset(void *latch, uint32_t count) {
+    eex_latch_cb_t      *p_latch = (eex_latch_cb_t *) latch;
+    eex_tagged_data_t    old_cnt, new_cnt;
+
+    assert (p_latch && (p_latch->cb.type == 'LTCH'));
+    assert (count <= EEX_COUNT_MAX);
+    do {
+        old_cnt.td = p_latch->count.td;
+        new_cnt = _eexNewTaggedData((eex_count_t) count);
+    } while(EEX_TAGGED_CAS(&(p_latch->count.td), old_cnt.td, new_cnt.td));
+}
+
+// Uncontended read lock acquire or release with a single CAS, without the event path.
+// Return false if the caller must take the event path: the lock is held by a writer,
+// a writer is waiting, or this is the last reader and a writer is waiting to be woken.
+bool eexRWLockReadFast(void *rwlock, bool acquire, eex_status_t *p_rtn_status) {
+    eex_rwlock_cb_t     *rwl = (eex_rwlock_cb_t *) rwlock;
+    eex_tagged_data_t    old_cnt, new_cnt;
+
+    assert (rwl && (rwl->cb.type == 'RWLK'));
+    old_cnt.td = rwl->count.td;
+    if (acquire) {
+        if (old_cnt.data & (EEX_RWLOCK_WRITER_HELD | EEX_RWLOCK_WRITER_WAITING)) { return (false); }
+        if ((old_cnt.data & EEX_RWLOCK_READERS) == EEX_RWLOCK_READERS)           { return (false); }
+        new_cnt = _eexNewTaggedData((eex_count_t) (old_cnt.data + 1));
+    }
+    else {
+        if ((old_cnt.data & EEX_RWLOCK_READERS) == 0)                            { return (false); }
+        if ((old_cnt.data & EEX_RWLOCK_WRITER_WAITING) && ((old_cnt.data & EEX_RWLOCK_READERS) == 1)) { return (false); }
+        new_cnt = _eexNewTaggedData((eex_count_t) (old_cnt.data - 1));
+    }
+    if (EEX_TAGGED_CAS(&(rwl->count.td), old_cnt.td, new_cnt.td)) { return (false); }
+    if (p_rtn_status) { *p_rtn_status = eexStatusOK; }
+    return (true);
+}
+
+void eexSignalClear(void *kobj, uint32_t signal_mask) {
+    eex_signal_cb_t *p_signal_cb = (eex_signal_cb_t *) kobj;
+    eex_signal_t     signal;
+
+    assert (p_signal_cb && (p_signal_cb->cb.type == 'SIGL'));
+    do {
+        signal = p_signal_cb->signal;
+    } while(eexCPUAtomic32CAS(&(p_signal_cb->signal), signal, signal & ~signal_mask));
+}
+
+void eexObufStats(void *obuf, eex_obuf_stats_t *p_stats) {
+    eex_obuf_cb_t   *ob = (eex_obuf_cb_t *) obuf;
+    eex_obuf_index_t idx;
+
+    assert (ob && (ob->cb.type == 'OBUF') && p_stats);
+    idx.ht            = ob->idx.ht;
+    p_stats->free     = 4 * (ob->n_words - 1 - ((idx.head - idx.tail + ob->n_words) % ob->n_words));
+    p_stats->min_free = 4 * ob->min_free;
+    p_stats->n_failed = ob->n_failed;
+}
+
+
+/*******************************************************************************
+
+    Stream Buffers
+
+    The producer owns head and the consumer owns tail, so neither needs a CAS.
+    head and tail are free running byte counts, the ring index is the count
+    modulo the (power of 2) ring size. A span is the contiguous run from the
+    ring index to either the other index or the end of the ring, whichever
+    comes first.
+
+    These functions never block and may be called from threads, functions,
+    and interrupt handlers. Waking the consumer is done by posting to the stream.
+
+ ******************************************************************************/
+
+uint8_t * eexStreamWriteSpan(void *stream, uint32_t *p_len) {
+    eex_stream_cb_t *strm = (eex_stream_cb_t *) stream;
+    uint32_t         idx, len;
+
+    assert (strm && (strm->cb.type == 'STRM') && p_len);
+    idx = strm->head & (strm->size - 1);
+    len = strm->size - (strm->head - strm->tail);               // free space
+    if (len > (strm->size - idx)) { len = strm->size - idx; }   // up to the end of the ring
+    *p_len = len;
+    return (&(strm->buf[idx]));
+}
+
+uint32_t eexStreamWrite(void *stream, const void *src, uint32_t n) {
+    eex_stream_cb_t *strm = (eex_stream_cb_t *) stream;
+    const uint8_t   *p_src = (const uint8_t *) src;
+    uint8_t         *span;
+    uint32_t         len, copied = 0;
+
+    while (copied < n) {    // at most two spans
+        span = eexStreamWriteSpan(stream, &len);
+        if (len == 0) { break; }
+        if (len > (n - copied)) { len = n - copied; }
+        (void) memcpy(span, &p_src[copied], len);
+        strm->head += len;
+        copied     += len;
+    }
+    return (copied);
+}
+
+const uint8_t * eexStreamReadSpan(void *stream, uint32_t *p_len) {
+    eex_stream_cb_t *strm = (eex_stream_cb_t *) stream;
+    uint32_t         idx, len;
+
+    assert (strm && (strm->cb.type == 'STRM') && p_len);
+    idx = strm->tail & (strm->size - 1);
+    len = strm->head - strm->tail;                              // bytes available
+    if (len > (strm->size - idx)) { len = strm->size - idx; }   // up to the end of the ring
+    *p_len = len;
+    return (&(strm->buf[idx]));
+}
+
+void eexStreamReadRelease(void *stream, uint32_t n) {
+    eex_stream_cb_t *strm = (eex_stream_cb_t *) stream;
+
+    assert (strm && (strm->cb.type == 'STRM'));
+    assert (n <= (strm->head - strm->tail));
+    strm->tail += n;
+}
+
+uint32_t eexStreamRead(void *stream, void *dst, uint32_t n) {
+    uint8_t         *p_dst = (uint8_t *) dst;
+    const uint8_t   *span;
+    uint32_t         len, copied = 0;
+
+    while (copied < n) {    // at most two spans
+        span = eexStreamReadSpan(stream, &len);
+        if (len == 0) { break; }
+        if (len > (n - copied)) { len = n - copied; }
+        (void) memcpy(&p_dst[copied], span, len);
+        eexStreamReadRelease(stream, len);
+        copied += len;
+    }
+    return (copied);
+}
+
+void eexStreamTriggerSet(void *stream, uint32_t trigger) {
+    eex_stream_cb_t *strm = (eex_stream_cb_t *) stream;
+
+    assert (strm && (strm->cb.type == 'STRM'));
+    strm->trigger = (uint16_t) ((trigger > strm->size) ? strm->size : trigger);
+}
+
 
 /*******************************************************************************
 
@@ -735,12 +2271,260 @@ eex_status_t eexThreadCreate(eex_thread_fn_t fn_thread, void * const tls, const
     tcb->fn_thread = fn_thread;
     tcb->arg       = tls;
     tcb->name      = name;
+    tcb->resume_pc = NULL;      // the slot may have been freed by an exited thread
+    tcb->notify.cb.type = 'NTFY';
+    tcb->notify.value   = 0;    // a notification to the exited thread isn't seen by the new one
+    tcb->notify.pending = 0;
+    tcb->join.cb.type   = 'JOIN';
+    tcb->join.done      = 0;
+    tcb->join.exit_code = 0;
+    tcb->join.free_slot = 0;
+    (void) memset(&(tcb->period), 0, sizeof(tcb->period));
+    eexThreadBudgetSet(priority, 0, 0);
+    eexThreadCriticalitySet(priority, 0, 0);
+    tcb->threshold = priority;
+    eexThreadPartitionSet(priority, 0);
+    (void) memset(&(tcb->table), 0, sizeof(tcb->table));
+    _eexThreadListDel(&g_thread_table_wait_list, priority);
+    _eexThreadListDel(&g_table_released_list, priority);
+    _eexThreadListDel(&g_thread_sleep_list, priority);
+    _eexThreadListDel(&g_thread_handler_list, priority);
+    _eexThreadListDel(&g_thread_preempted_list, priority);
     _eexThreadListAdd(_eexThreadListGet(EEX_THREAD_READY), priority);
 
     EEX_PROFILE_API_CALL_CREATE_THREAD(priority);
     return (eexStatusOK);
 }
 
+eex_status_t eexHandlerCreate(eex_handler_fn_t fn, void *argument, uint32_t priority, void *kobj, uint32_t val, const char *name) {
+    eex_kobj_cb_t   *p_kobj = (eex_kobj_cb_t *) kobj;
+    eex_thread_cb_t *tcb;
+    eex_status_t     status;
+
+    assert (fn && p_kobj);
+    assert ((p_kobj->type == 'SEMA') || (p_kobj->type == 'SIGL') || (p_kobj->type == 'POOL') || (p_kobj->type == 'STRM'));
+    assert ((p_kobj->type != 'SIGL') || !((eex_signal_cb_t *) p_kobj)->manual);   // a broadcast signal stays set
+
+    status = eexThreadCreate(_eexHandlerThread, argument, priority, name);
+    if (status != eexStatusOK) { return (status); }
+
+    tcb = eexThreadTCB(priority);
+    tcb->handler.fn      = fn;
+    tcb->handler.kobj    = p_kobj;
+    tcb->handler.val     = val;
+    tcb->handler.status  = eexStatusInvalid;
+    tcb->handler.rtn_val = 0;
+    _eexThreadListDel(_eexThreadListGet(EEX_THREAD_READY), priority);
+    _eexHandlerArm(priority);
+    _eexThreadListAdd(&g_thread_handler_list, priority);
+    _eexThreadListAdd(_eexThreadListGet(EEX_THREAD_WAITING), priority);
+    return (eexStatusOK);
+}
+
+void eexThreadSuspend(eex_thread_id_t tid) {
+    assert ((tid > 0) && (tid <= EEX_CFG_THREADS_MAX));
+    _eexThreadListAdd(&g_thread_suspended_list, tid);
+}
+
+// Only an interrupt pends the scheduler. A thread can't, on ARM the pend is taken at once and
+// the caller's continuation is lost, so the scheduler runs at its next blocking call.
+void eexThreadResume(eex_thread_id_t tid) {
+    assert ((tid > 0) && (tid <= EEX_CFG_THREADS_MAX));
+    _eexThreadListDel(&g_thread_suspended_list, tid);
+    if (eexInInterrupt() && (tid > eexThreadID())) { eexSchedulerPend(); }   // resumed thread may preempt
+}
+
+// The abort is completed by the next try of the wait, which is the only
+// place the event can be removed without racing the scheduler.
+void eexThreadAbortWait(eex_thread_id_t tid) {
+    assert ((tid > 0) && (tid <= EEX_CFG_THREADS_MAX));
+    _eexThreadListAdd(&g_thread_abort_list, tid);
+    if (eexInInterrupt() && (tid > eexThreadID())) { eexSchedulerPend(); }   // try the aborted wait now
+}
+
+void eexThreadPeriodSet(eex_thread_id_t tid, uint32_t period_ms, uint32_t phase_ms) {
+    eex_thread_cb_t *tcb;
+    uint32_t         now, next;
+
+    assert ((tid > 0) && (tid <= EEX_CFG_THREADS_MAX));
+    assert ((period_ms == 0) || (phase_ms < period_ms));
+    assert (period_ms <= (uint32_t) eexWaitMax);
+    tcb = eexThreadTCB(tid);
+
+    // first release on the phase grid after the current time
+    now = eexKernelTime(NULL);
+    if (period_ms) {
+        next = now - (now % period_ms) + phase_ms;
+        if (eexTimeDiff(next, now) <= 0) { next += period_ms; }
+    }
+    else { next = 0; }
+
+    tcb->period.period   = 0;   // not periodic while it's updated
+    tcb->period.next     = next;
+    tcb->period.n_missed = 0;
+    tcb->period.period   = period_ms;
+}
+
+void eexThreadBudgetSet(eex_thread_id_t tid, uint32_t budget_us, uint32_t period_ms) {
+    eex_thread_budget_t *budget;
+
+    assert ((tid > 0) && (tid <= EEX_CFG_THREADS_MAX));
+    assert ((budget_us == 0) || ((period_ms > 0) && (period_ms <= (uint32_t) eexWaitMax)));
+    assert (budget_us <= (uint32_t) INT32_MAX);
+    budget = &(eexThreadTCB(tid)->budget);
+
+    _eexThreadListDel(&g_thread_budget_list, tid);      // not charged or replenished while it's updated
+    _eexThreadListDel(&g_thread_exhausted_list, tid);
+    if (budget_us == 0) { return; }
+    budget->budget_us     = budget_us;
+    budget->period_ms     = period_ms;
+    budget->remaining_us  = (int32_t) budget_us;
+    budget->next_ms       = eexKernelTime(NULL) + period_ms;
+    if (!_eexThreadListContains(&g_thread_crit_list, tid)) {
+        eexThreadTCB(tid)->t_dispatch_us = _eexKernelTimeUs();  // in case it is the running thread
+    }
+    _eexThreadListAdd(&g_thread_budget_list, tid);
+}
+
+void eexThreadCriticalitySet(eex_thread_id_t tid, uint32_t level, uint32_t budget_us) {
+    eex_thread_crit_t *crit;
+
+    assert ((tid > 0) && (tid <= EEX_CFG_THREADS_MAX));
+    assert (level < EEX_CFG_CRIT_LEVELS);
+    crit = &(eexThreadTCB(tid)->crit);
+
+    _eexThreadListDel(&g_thread_crit_list, tid);        // not charged while it's updated
+    for (uint32_t mode=1; mode<EEX_CFG_CRIT_LEVELS; ++mode) {
+        if (level < mode) { _eexThreadListAdd(&g_crit_mask[mode], tid); }
+        else              { _eexThreadListDel(&g_crit_mask[mode], tid); }
+    }
+    crit->level     = level;
+    crit->budget_us = budget_us;
+    crit->job_us    = 0;
+    if ((level == 0) || (budget_us == 0)) { return; }   // can't raise the mode
+    if (!_eexThreadListContains(&g_thread_budget_list, tid)) {
+        eexThreadTCB(tid)->t_dispatch_us = _eexKernelTimeUs();  // in case it is the running thread
+    }
+    _eexThreadListAdd(&g_thread_crit_list, tid);
+}
+
+void eexThreadThresholdSet(eex_thread_id_t tid, uint32_t threshold) {
+    assert ((tid > 0) && (tid <= EEX_CFG_THREADS_MAX));
+    assert ((threshold >= tid) && (threshold <= EEX_CFG_THREADS_MAX));
+    eexThreadTCB(tid)->threshold = threshold;
+}
+
+void eexThreadPartitionSet(eex_thread_id_t tid, uint32_t partition) {
+    assert ((tid > 0) && (tid <= EEX_CFG_THREADS_MAX));
+    assert (partition <= EEX_CFG_PARTITIONS);
+
+    for (uint32_t p=1; p<=EEX_CFG_PARTITIONS; ++p) { _eexThreadListDel(&g_partition_threads[p], tid); }
+    _eexThreadListDel(&g_thread_partitioned_list, tid);
+    if (partition) {
+        _eexThreadListAdd(&g_partition_threads[partition], tid);
+        _eexThreadListAdd(&g_thread_partitioned_list, tid);
+    }
+    if (g_partition_n_windows) {
+        g_partition_mask = g_thread_partitioned_list & ~g_partition_threads[g_partition_windows[g_partition_window].partition];
+    }
+}
+
+void eexPartitionSchedule(const eex_partition_window_t *windows, uint32_t n_windows) {
+    g_partition_n_windows = 0;      // not switched while it's updated
+    g_partition_mask      = EEX_EMPTY_THREAD_LIST;
+    (void) memset(g_partition_stats, 0, sizeof(g_partition_stats));
+    if ((windows == NULL) || (n_windows == 0)) { return; }
+
+    for (uint32_t w=0; w<n_windows; ++w) {
+        assert ((windows[w].partition <= EEX_CFG_PARTITIONS) && (windows[w].duration_ms > 0));
+        g_partition_stats[windows[w].partition].budget_ms += windows[w].duration_ms;
+    }
+    g_partition_windows    = windows;
+    g_partition_window     = 0;
+    g_partition_window_end = eexKernelTime(NULL) + windows[0].duration_ms;
+    g_partition_stats[windows[0].partition].n_windows = 1;
+    g_partition_mask       = g_thread_partitioned_list & ~g_partition_threads[windows[0].partition];
+    g_partition_n_windows  = n_windows;
+    if (eexInInterrupt() && eexThreadID()) { eexSchedulerPend(); }   // the new window's threads may preempt
+}
+
+void eexTableSchedule(const eex_table_release_t *table, uint32_t n_releases, uint32_t hyperperiod_ms) {
+    g_table_n_releases    = 0;      // not walked while it's updated
+    g_table_released_list = EEX_EMPTY_THREAD_LIST;
+    if ((table == NULL) || (n_releases == 0)) { return; }
+
+    assert ((hyperperiod_ms > 0) && (hyperperiod_ms <= (uint32_t) eexWaitMax));
+    for (uint32_t r=0; r<n_releases; ++r) {
+        assert ((table[r].tid > 0) && (table[r].tid <= EEX_CFG_THREADS_MAX) && (table[r].offset_ms < hyperperiod_ms));
+        assert ((r == 0) || (table[r].offset_ms >= table[r-1].offset_ms));
+    }
+    g_table               = table;
+    g_table_hyperperiod   = hyperperiod_ms;
+    g_table_index         = 0;
+    g_table_frame_ms      = eexKernelTime(NULL);
+    g_table_next_ms       = g_table_frame_ms + table[0].offset_ms;
+    g_table_n_releases    = n_releases;
+}
+
+void eexTableStats(eex_thread_id_t tid, eex_table_stats_t *stats) {
+    assert ((tid > 0) && (tid <= EEX_CFG_THREADS_MAX) && stats);
+    *stats = eexThreadTCB(tid)->table;
+}
+
+eex_status_t eexIdleJobSubmit(eex_job_fn_t fn, void *argument, uint32_t wcet_us) {
+    eex_idle_job_t  *slot;
+    uint32_t         pos;
+    int32_t          diff;
+
+    assert (fn);
+    for (;;) {
+        pos  = g_idle_tail;
+        slot = &g_idle_job[pos & (EEX_CFG_IDLE_JOBS - 1)];
+        diff = (int32_t) (slot->seq - (pos & ~(uint32_t) (EEX_CFG_IDLE_JOBS - 1)));
+        if (diff < 0) {                                                     // queue is full
+            ++g_idle_n_dropped;
+            return (eexStatusKOErr);
+        }
+        if ((diff == 0) && !eexCPUAtomic32CAS(&g_idle_tail, pos, pos + 1)) { break; }
+        // another producer claimed the position first, try the next one
+    }
+    slot->fn      = fn;
+    slot->arg     = argument;
+    slot->wcet_us = wcet_us;
+    slot->seq    += 1;                                                      // publish
+    return (eexStatusOK);
+}
+
+bool eexDefer(void *item) {
+    eex_defer_t     *p_item = (eex_defer_t *) item;
+    eex_defer_t     *head;
+
+    assert (p_item && p_item->fn);
+    if (p_item->queued) { return (false); }                                 // not started yet, it will see this interrupt's work
+    p_item->queued = 1;
+    do { head = g_defer_head;  p_item->next = head; }
+    while (eexCPUAtomicPtrCAS((void * volatile *) &g_defer_head, head, p_item));
+
+    // the deferred work thread prospectively joined the pend list of defer_kobj when it waited
+    if ((head == NULL) && (_eexThreadListHPT(defer_kobj.pend, EEX_EMPTY_THREAD_LIST) > eexThreadID())) { eexSchedulerPend(); }
+    return (true);
+}
+
+void eexPartitionStats(uint32_t partition, eex_partition_stats_t *stats) {
+    assert ((partition <= EEX_CFG_PARTITIONS) && stats);
+    *stats = g_partition_stats[partition];
+}
+
+uint32_t eexKernelMode(uint32_t *n_switch, uint32_t *n_restore) {
+    if (n_switch)  { *n_switch  = g_crit_n_switch; }
+    if (n_restore) { *n_restore = g_crit_n_restore; }
+    return (g_crit_mode);
+}
+
+uint32_t eexThreadPeriodMissed(eex_thread_id_t tid) {
+    return (eexThreadTCB(tid)->period.n_missed);
+}
+
 eex_thread_cb_t * eexThreadTCB(eex_thread_id_t tid) {
     assert (tid <= EEX_CFG_THREADS_MAX);
     return (&g_thread_tcb[tid]);
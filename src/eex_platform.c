@@ -34,6 +34,13 @@ void _createTimerControlThread(void) {
     }
 }
 
+void _eexDeferThread(void * const argument);
+void _createDeferThread(void) {
+    if (EEX_CFG_DEFER_THREAD_PRIORITY != 0) {
+        (void) eexThreadCreate(_eexDeferThread, NULL, EEX_CFG_DEFER_THREAD_PRIORITY, "defer_thread"); // return ignored, nothing can be done if error
+    }
+}
+
 
 #if (defined __CONSOLE)
 
@@ -53,6 +60,10 @@ uint32_t eexCPUAtomic32CAS(uint32_t volatile *addr, uint32_t expected, uint32_t
     return (0);
 }
 
+uint32_t eexCPUAtomic64CAS(uint64_t volatile *addr, uint64_t expected, uint64_t store) {
+    return (__sync_bool_compare_and_swap(addr, expected, store) ? 0 : 1);
+}
+
 uint32_t eexCPUCLZ(uint32_t x) {
     return (x ? __builtin_clz(x) : 32);   // __builtin_clz undefined if x == 0
 }
@@ -85,6 +96,7 @@ void  eexKernelStart(void) {
     (void) setitimer(ITIMER_REAL, &it, NULL); // ITIMER_VIRTUAL doesn't work with Cygwin
 
     _createTimerControlThread();
+    _createDeferThread();
 
     // loop forever dispatching threads
     for (;;) {
@@ -176,6 +188,22 @@ uint32_t eexCPUCLZ(uint32_t x) {
 
 #if ((__CORTEX_M == 0) || (__CORTEX_M == 3) || (__CORTEX_M == 4))
 
+// ARMv6-M and ARMv7-M have no LDREXD/STREXD, the 64 bit CAS masks interrupts.
+// Only used if EEX_CFG_WIDE_COUNT is set.
+uint32_t eexCPUAtomic64CAS(uint64_t volatile *addr, uint64_t expected, uint64_t store) {
+    uint32_t rslt = 1;
+    uint32_t primask;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    if (*addr == expected) {
+      *addr = store;
+      rslt  = 0;
+    }
+    __set_PRIMASK(primask);
+    return (rslt);
+}
+
 // eexCPUAtomicPtrCAS is eexCPUAtomic32CAS with 32 bit Arm Cortex
 void * eexCPUAtomicPtrCAS(void * volatile *addr, void * expected, void * store) {
     return ((void *) eexCPUAtomic32CAS(((uint32_t volatile) *addr, (uint32_t) expected, (uint32_t )store));
@@ -183,10 +211,12 @@ void * eexCPUAtomicPtrCAS(void * volatile *addr, void * expected, void * store)
 
 
 // creates a timer thread if EEX_CFG_TIMER_THREAD_PRIORITY is nonzero
+// and a deferred work thread if EEX_CFG_DEFER_THREAD_PRIORITY is nonzero
 // triggers pendSV exception and never returns
 void eexKernelStart(void) {
 
     _createTimerControlThread();
+    _createDeferThread();
 
     NVIC_SetPriority(PendSV_IRQn, EEX_CFG_INT_PRI_PENDSV);    // pendSV is always enabled at lowest possible priority
     (void) SysTick_Config(((EEX_CFG_CPU_FREQ)/1000));         // configure systick for 1 ms ticks
@@ -241,7 +271,7 @@ uint32_t eexInInterrupt() {
 void SysTick_Handler(void) {
     ++g_timer_ms;
     EEX_PROFILE_ENTER;    // don't increment ms between profile timestamps
-    if (eexThreadTimeout() > eexThreadID()) {
+    if ((eexThreadTimeout() > eexThreadID()) || eexPartitionSwitchDue() || eexTableReleaseDue()) {
         eexSchedulerPend();
     }
     EEX_PROFILE_EXIT;
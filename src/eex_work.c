@@ -0,0 +1,221 @@
+/*******************************************************************************
+
+    eex_work.c - Real time executive work servers.
+
+    COPYRIGHT NOTICE: (c) ee-quipment.com
+    All Rights Reserved
+
+ ******************************************************************************/
+
+
+#include  <stdint.h>
+#include  <stddef.h>
+#include  "eex_os.h"
+#include  "eex_work.h"
+
+#pragma GCC diagnostic ignored "-Wmultichar"    // Don't complain about e.g. 'MUTX'
+
+#ifdef UNIT_TEST
+#define STATIC
+#else
+#define STATIC static
+#endif
+
+/*******************************************************************************
+ *
+ *  The job queue is a bounded ring of slots, each with a sequence number.
+ *  A slot is free for the producer claiming queue position pos when its
+ *  sequence is pos, and holds a job for the server when its sequence is
+ *  pos + 1. Producers, which may be threads or interrupt handlers, claim a
+ *  position by a CAS on the tail and then fill and publish the slot. The
+ *  server is the only consumer, it frees a slot by advancing its sequence by
+ *  the size of the queue.
+ *
+ *  A producer that is interrupted between claiming and publishing a slot
+ *  holds up the jobs behind it until it publishes, it doesn't lose them.
+ *
+ *  The server waits on its thread notification, which every submit sets.
+ *  It drains the queue, yielding after each job so the scheduler can charge
+ *  its budget and preempt it when the budget is used up.
+ *
+ *  A worker pool's queues are the same ring with several consumers, since
+ *  a worker can be preempted by a higher priority worker. Workers claim the
+ *  head with a CAS as producers claim the tail. The pool semaphore is only
+ *  a wake-up: a worker that wakes runs jobs until the queues are empty, so
+ *  a submit posts it only if it is zero. A job that is held up behind a
+ *  producer that hasn't published yet is run after that producer's post.
+ *
+ *  Workers share one thread function, so nothing is kept across the yield
+ *  between batches. A batch is run by a function call and the queues are
+ *  looked at again after the yield.
+ *
+ ******************************************************************************/
+
+
+STATIC bool  _eexServerGet(eex_server_cb_t *server, eex_job_t *job);
+STATIC void  _eexServerThread(void * const argument);
+STATIC bool  _eexJobQueueGet(eex_job_queue_t *queue, eex_job_t *job);
+STATIC bool  _eexWorkersBatch(eex_workers_cb_t *workers);
+STATIC void  _eexWorkerThread(void * const argument);
+
+
+eex_status_t eexServerCreate(void *server, uint32_t priority, uint32_t budget_us, uint32_t period_ms, const char *name) {
+    eex_server_cb_t *p_server = (eex_server_cb_t *) server;
+    eex_status_t     status;
+
+    assert (p_server && p_server->jobs);
+    for (uint32_t i=0; i<=p_server->mask; ++i) { p_server->jobs[i].seq = i; }
+    p_server->head      = 0;
+    p_server->tail      = 0;
+    p_server->n_dropped = 0;
+    p_server->tid       = priority;
+
+    status = eexThreadCreate(_eexServerThread, p_server, priority, name);
+    if (status == eexStatusOK) { eexThreadBudgetSet(priority, budget_us, period_ms); }
+    return (status);
+}
+
+eex_status_t _eexServerPut(eex_server_cb_t *server, eex_job_fn_t fn, void *argument) {
+    eex_job_t   *slot;
+    uint32_t     pos;
+    int32_t      diff;
+
+    assert (server && fn);
+    for (;;) {
+        pos  = server->tail;
+        slot = &(server->jobs[pos & server->mask]);
+        diff = (int32_t) (slot->seq - pos);
+        if (diff < 0) {                                                     // queue is full
+            ++server->n_dropped;
+            return (eexStatusKOErr);
+        }
+        if ((diff == 0) && !eexCPUAtomic32CAS(&(server->tail), pos, pos + 1)) { break; }
+        // another producer claimed the position first, try the next one
+    }
+    slot->fn  = fn;
+    slot->arg = argument;
+    slot->seq = pos + 1;                                                    // publish
+    return (eexStatusOK);
+}
+
+STATIC bool _eexServerGet(eex_server_cb_t *server, eex_job_t *job) {
+    eex_job_t   *slot;
+    uint32_t     pos;
+
+    pos  = server->head;
+    slot = &(server->jobs[pos & server->mask]);
+    if (slot->seq != (pos + 1)) { return (false); }                        // empty, or next job not published yet
+    job->fn  = slot->fn;
+    job->arg = slot->arg;
+    slot->seq = pos + server->mask + 1;                                     // free for the producer one lap later
+    server->head = pos + 1;
+    return (true);
+}
+
+STATIC void _eexServerThread(void * const argument) {
+    eex_job_t    job;
+
+    eexThreadEntry();
+
+    for (;;) {
+        eexNotifyWait(NULL, NULL, eexWaitForever, 0);
+        while (_eexServerGet((eex_server_cb_t *) argument, &job)) {
+            job.fn(job.arg);
+            eexYield();     // budget is charged and enforced between jobs
+        }
+    }
+}
+
+
+eex_status_t eexWorkersCreate(void *workers, uint32_t priority, uint32_t n_workers, uint32_t batch, const char *name) {
+    eex_workers_cb_t *p_workers = (eex_workers_cb_t *) workers;
+    eex_job_queue_t  *queue;
+    eex_status_t      status = eexStatusOK;
+
+    assert (p_workers && p_workers->jobs && n_workers && batch);
+    if ((priority + n_workers - 1) > EEX_CFG_THREADS_MAX) { return (eexStatusThreadCreateErr); }
+    for (uint32_t level=0; level<p_workers->n_levels; ++level) {
+        queue = &(p_workers->queues[level]);
+        queue->jobs      = &(p_workers->jobs[level * (p_workers->mask + 1)]);
+        queue->mask      = p_workers->mask;
+        queue->head      = 0;
+        queue->tail      = 0;
+        queue->n_dropped = 0;
+        for (uint32_t i=0; i<=queue->mask; ++i) { queue->jobs[i].seq = i; }
+    }
+    p_workers->batch = batch;
+
+    for (uint32_t i=0; (i<n_workers) && (status == eexStatusOK); ++i) {
+        status = eexThreadCreate(_eexWorkerThread, p_workers, priority + i, name);
+    }
+    return (status);
+}
+
+eex_status_t _eexWorkersPut(eex_workers_cb_t *workers, uint32_t level, eex_job_fn_t fn, void *argument) {
+    eex_job_queue_t *queue;
+    eex_job_t       *slot;
+    uint32_t         pos;
+    int32_t          diff;
+
+    assert (workers && fn && (level < workers->n_levels));
+    queue = &(workers->queues[level]);
+    for (;;) {
+        pos  = queue->tail;
+        slot = &(queue->jobs[pos & queue->mask]);
+        diff = (int32_t) (slot->seq - pos);
+        if (diff < 0) {                                                     // queue is full
+            ++queue->n_dropped;
+            return (eexStatusKOErr);
+        }
+        if ((diff == 0) && !eexCPUAtomic32CAS(&(queue->tail), pos, pos + 1)) { break; }
+        // another producer claimed the position first, try the next one
+    }
+    slot->fn  = fn;
+    slot->arg = argument;
+    slot->seq = pos + 1;                                                    // publish
+    return (eexStatusOK);
+}
+
+STATIC bool _eexJobQueueGet(eex_job_queue_t *queue, eex_job_t *job) {
+    eex_job_t   *slot;
+    uint32_t     pos;
+    int32_t      diff;
+
+    for (;;) {
+        pos  = queue->head;
+        slot = &(queue->jobs[pos & queue->mask]);
+        diff = (int32_t) (slot->seq - (pos + 1));
+        if (diff < 0) { return (false); }                                  // empty, or next job not published yet
+        if ((diff == 0) && !eexCPUAtomic32CAS(&(queue->head), pos, pos + 1)) { break; }
+        // another worker took the job first, try the next one
+    }
+    job->fn  = slot->fn;
+    job->arg = slot->arg;
+    slot->seq = pos + queue->mask + 1;                                      // free for the producer one lap later
+    return (true);
+}
+
+// Run up to a batch of jobs, highest level first. Returns true if jobs may remain.
+STATIC bool _eexWorkersBatch(eex_workers_cb_t *workers) {
+    eex_job_t    job;
+    uint32_t     n_run = 0, level = workers->n_levels;
+
+    while (level) {
+        if (!_eexJobQueueGet(&(workers->queues[level - 1]), &job)) { --level;  continue; }
+        job.fn(job.arg);
+        if (++n_run == workers->batch) { return (true); }
+        level = workers->n_levels;                                          // a higher level job may have been queued
+    }
+    return (false);
+}
+
+STATIC void _eexWorkerThread(void * const argument) {
+    eexThreadEntry();
+
+    for (;;) {
+        eexPend(NULL, NULL, eexWaitForever, ((eex_workers_cb_t *) argument)->sema);
+        while (_eexWorkersBatch((eex_workers_cb_t *) argument)) {
+            eexYield();     // one scheduler pass per batch
+        }
+    }
+}
@@ -0,0 +1,218 @@
+/*******************************************************************************
+ *    INCLUDED FILES
+ ******************************************************************************/
+#include <string.h>
+
+//-- unity: unit test framework
+#include "unity.h"
+#include "assert_test_helpers.h"
+
+//-- module being tested
+#include "eex_os.h"
+#include "eex_ao.h"
+#include "eex_platform_mock.c"
+
+#pragma GCC diagnostic ignored "-Wmultichar"            // to allow e.g. 'MUTX'
+#pragma GCC diagnostic ignored "-Wpointer-to-int-cast"  // console 64 bit pointers don't like cast to uint32_t
+#pragma GCC diagnostic ignored "-Wint-to-pointer-cast"
+
+
+/*******************************************************************************
+ *    DEFINITIONS
+ ******************************************************************************/
+
+#define AO_THREAD_PRI_H       12
+#define AO_THREAD_PRI_L       10
+#define SPIN_THREAD_PRI       1
+
+#define SIG_FORWARD           1     // L forwards the event to H
+#define SIG_RECORD            2
+
+
+/*******************************************************************************
+ *    MODULE INTERNAL DATA
+ ******************************************************************************/
+
+extern eex_thread_cb_t    g_thread_tcb[EEX_CFG_THREADS_MAX+1];
+extern eex_thread_list_t  g_thread_ready_list;
+extern eex_thread_list_t  g_thread_waiting_list;
+extern eex_thread_list_t  g_thread_interrupted_list;
+extern eex_thread_list_t  g_thread_preempted_list;
+extern eex_thread_list_t  g_thread_running;
+
+
+/*******************************************************************************
+ *    PRIVATE TYPES
+ ******************************************************************************/
+
+typedef struct {
+    eex_ao_event_t    super;
+    uint32_t          data;
+} test_event_t;
+
+
+/*******************************************************************************
+ *    PRIVATE DATA
+ ******************************************************************************/
+
+bool  g_all_tests_run;
+
+EEX_AO_NEW(ao_h, 4);
+EEX_AO_NEW(ao_l, 2);
+EEX_AO_POOL_NEW(pool_4, sizeof(test_event_t), 4);
+
+uint32_t          g_ao_order[8];
+eex_ao_event_t   *g_ao_event[8];
+uint32_t          g_ao_n;
+
+
+/*******************************************************************************
+ *    PRIVATE FUNCTIONS
+ ******************************************************************************/
+
+// simulate eexKernelStart function dispatching threads
+void dispatch(bool from_interrupt) {
+    eex_thread_cb_t * tcb;
+
+    tcb = eexScheduler(from_interrupt);
+    if (g_f_pend_scheduler) {    // rerun scheduler before dispatching thread
+        g_f_pend_scheduler = false;
+        tcb = eexScheduler(from_interrupt);
+    }
+    tcb->fn_thread(tcb->arg);
+}
+
+// increment the global timer by 1 ms when there are no threads ready to dispatch
+uint32_t eexIdleHook(int32_t sleep_for_ms)  {
+    return (1);
+}
+
+// objects record their argument and the event, L forwards SIG_FORWARD events to H
+static void ao_record(void * const argument, eex_ao_event_t *event) {
+    g_ao_order[g_ao_n]   = (uint32_t) argument;
+    g_ao_event[g_ao_n++] = event;
+    if ((event->sig == SIG_FORWARD) && ((uint32_t) argument == AO_THREAD_PRI_L)) {
+        TEST_ASSERT_EQUAL(eexStatusOK, eexAOPost(ao_h, event));
+    }
+}
+
+static void _queueReset(eex_ao_queue_t *queue) {
+    (void) memset(queue->slots, 0, sizeof(eex_ao_slot_t) * (queue->mask + 1));
+    queue->head      = 0;
+    queue->tail      = 0;
+    queue->n_dropped = 0;
+}
+
+// lowest priority thread, always ready so the scheduler never idles
+static void thread_spin(void * const argument) {
+    eexThreadEntry();
+    for (;;) { eexYield(); }
+}
+
+
+/*******************************************************************************
+ *    SETUP, TEARDOWN
+ ******************************************************************************/
+void setUp(void) {
+    (void) memset(g_thread_tcb, 0, sizeof(g_thread_tcb));
+    g_thread_ready_list       = 0;
+    g_thread_waiting_list     = 0;
+    g_thread_interrupted_list = 0;
+    g_thread_preempted_list   = 0;
+    g_thread_running          = 0;
+    g_timer_ms                = 0;
+    g_timer_us                = 0;
+    g_mock_interrupt_level    = 0;
+    g_ao_n                    = 0;
+    _queueReset(&((eex_ao_cb_t *) ao_h)->queue);
+    _queueReset(&((eex_ao_cb_t *) ao_l)->queue);
+    _queueReset(&((eex_ao_pool_t *) pool_4)->free);
+    ((eex_ao_pool_t *) pool_4)->fresh = 0;
+    g_all_tests_run = false;
+}
+
+void tearDown(void) {
+    TEST_ASSERT_TRUE(g_all_tests_run);
+    g_all_tests_run = false;
+}
+
+
+/*******************************************************************************
+ *    TESTS
+ ******************************************************************************/
+
+void test_event_pool(void) {
+    eex_ao_cb_t     *ao = (eex_ao_cb_t *) ao_l;
+    test_event_t    *evt[4];
+
+    // never-allocated events are handed out until the pool is empty
+    for (uint32_t i=0; i<4; ++i) {
+        evt[i] = (test_event_t *) eexAOEventNew(pool_4, SIG_RECORD);
+        TEST_ASSERT_NOT_NULL(evt[i]);
+        TEST_ASSERT_EQUAL(SIG_RECORD, evt[i]->super.sig);
+        if (i) { TEST_ASSERT_EQUAL(sizeof(test_event_t), (uint8_t *) evt[i] - (uint8_t *) evt[i-1]); }
+    }
+    TEST_ASSERT_NULL(eexAOEventNew(pool_4, SIG_RECORD));
+
+    // a post to a full queue recycles the event
+    TEST_ASSERT_EQUAL(eexStatusOK, eexAOCreate(ao_l, ao_record, (void *) AO_THREAD_PRI_L, AO_THREAD_PRI_L, NULL));
+    TEST_ASSERT_EQUAL(eexStatusOK, eexAOPost(ao_l, evt[0]));
+    TEST_ASSERT_EQUAL(eexStatusOK, eexAOPost(ao_l, evt[1]));
+    TEST_ASSERT_EQUAL(eexStatusKOErr, eexAOPost(ao_l, evt[2]));
+    TEST_ASSERT_EQUAL(1, ao->queue.n_dropped);
+    TEST_ASSERT_EQUAL(1, evt[0]->super.refs);
+    TEST_ASSERT_EQUAL_PTR(evt[2], eexAOEventNew(pool_4, SIG_FORWARD));
+    TEST_ASSERT_NULL(eexAOEventNew(pool_4, SIG_RECORD));
+
+    // events are dispatched by pointer in the order posted, and recycled after
+    dispatch(false);
+    TEST_ASSERT_EQUAL(2, g_ao_n);
+    TEST_ASSERT_EQUAL_PTR(evt[0], g_ao_event[0]);
+    TEST_ASSERT_EQUAL_PTR(evt[1], g_ao_event[1]);
+    TEST_ASSERT_EQUAL_PTR(evt[0], eexAOEventNew(pool_4, SIG_RECORD));
+    TEST_ASSERT_EQUAL_PTR(evt[1], eexAOEventNew(pool_4, SIG_RECORD));
+
+    g_all_tests_run = true;
+}
+
+void test_active_objects(void) {
+    static eex_ao_event_t  evt_static = { SIG_RECORD, NULL, 0 };
+    void * const           both[2]    = { ao_l, ao_h };
+    eex_ao_event_t        *evt;
+
+    (void) eexAOCreate(ao_h, ao_record, (void *) AO_THREAD_PRI_H, AO_THREAD_PRI_H, NULL);
+    (void) eexAOCreate(ao_l, ao_record, (void *) AO_THREAD_PRI_L, AO_THREAD_PRI_L, NULL);
+    (void) eexThreadCreate(thread_spin, NULL, SPIN_THREAD_PRI, NULL);
+    for (uint32_t i=0; i<3; ++i) { dispatch(false); }                            // objects wait, spin runs
+    TEST_ASSERT_EQUAL(SPIN_THREAD_PRI, eexThreadID());
+
+    // an interrupt posts to L, L forwards the same event to H, which runs after L's dispatch completes
+    evt = (eex_ao_event_t *) eexAOEventNew(pool_4, SIG_FORWARD);
+    g_mock_interrupt_level = 1;
+    TEST_ASSERT_EQUAL(eexStatusOK, eexAOPost(ao_l, evt));
+    g_mock_interrupt_level = 0;
+    dispatch(false);                                                              // L dispatches, forwards and yields
+    TEST_ASSERT_EQUAL(1, g_ao_n);
+    TEST_ASSERT_EQUAL(AO_THREAD_PRI_L, g_ao_order[0]);
+    TEST_ASSERT_EQUAL(1, evt->refs);
+    dispatch(false);                                                              // H dispatches and waits
+    TEST_ASSERT_EQUAL(2, g_ao_n);
+    TEST_ASSERT_EQUAL(AO_THREAD_PRI_H, g_ao_order[1]);
+    TEST_ASSERT_EQUAL_PTR(evt, g_ao_event[1]);
+    TEST_ASSERT_EQUAL(0, evt->refs);
+    TEST_ASSERT_EQUAL_PTR(evt, eexAOEventNew(pool_4, SIG_RECORD));               // recycled
+    dispatch(false);                                                              // L finds its queue empty and waits
+    dispatch(false);
+    TEST_ASSERT_EQUAL(SPIN_THREAD_PRI, eexThreadID());
+
+    // a published event is dispatched by each object, a static event is never recycled
+    TEST_ASSERT_EQUAL(eexStatusOK, eexAOPublish(&evt_static, both, 2));
+    for (uint32_t i=0; i<3; ++i) { dispatch(false); }
+    TEST_ASSERT_EQUAL(4, g_ao_n);
+    TEST_ASSERT_EQUAL(AO_THREAD_PRI_H, g_ao_order[2]);
+    TEST_ASSERT_EQUAL(AO_THREAD_PRI_L, g_ao_order[3]);
+    TEST_ASSERT_EQUAL_PTR(&evt_static, g_ao_event[3]);
+    TEST_ASSERT_EQUAL(SPIN_THREAD_PRI, eexThreadID());
+
+    g_all_tests_run = true;
+}
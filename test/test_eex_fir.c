@@ -0,0 +1,144 @@
+/*******************************************************************************
+ *    INCLUDED FILES
+ ******************************************************************************/
+//-- unity: unit test framework
+#include "unity.h"
+#include "assert_test_helpers.h"
+
+//-- module being tested
+#include "eex_os.h"
+#include "eex_fir.h"
+
+
+/*******************************************************************************
+ *    DEFINITIONS
+ ******************************************************************************/
+
+#define N_TAPS_MAX    67      // not a multiple of any vector width, exercises the remainders
+
+/*******************************************************************************
+ *    MODULE INTERNAL DATA
+ ******************************************************************************/
+
+int64_t _eexFirDotI16C(const int16_t *x, const int16_t *h, uint32_t n);
+int64_t _eexFirDotI32C(const int32_t *x, const int32_t *h, uint32_t n);
+float   _eexFirDotF32C(const float *x, const float *h, uint32_t n);
+
+/*******************************************************************************
+ *    PRIVATE DATA
+ ******************************************************************************/
+
+bool  g_all_tests_run;
+
+EEX_DELAY_LINE_NEW(dl_i16_5, int16_t, 5);
+EEX_DELAY_LINE_NEW(dl_fir_5, int16_t, 5);
+EEX_DELAY_LINE_NEW(dl_i32_3, int32_t, 3);
+EEX_DELAY_LINE_NEW(dl_f32_4, float, 4);
+
+static int16_t  x16[N_TAPS_MAX+1], h16[N_TAPS_MAX];
+static int32_t  x32[N_TAPS_MAX+1], h32[N_TAPS_MAX];
+static float    xf[N_TAPS_MAX+1],  hf[N_TAPS_MAX];
+
+/*******************************************************************************
+ *    PRIVATE FUNCTIONS
+ ******************************************************************************/
+
+// deterministic pseudo-random test vectors, with full scale values at the ends
+static void _fill(void) {
+    uint32_t lfsr = 0xace1;
+
+    for (int i=0; i<N_TAPS_MAX; ++i) {
+        lfsr = (lfsr >> 1) ^ (-(lfsr & 1) & 0xb400);
+        x16[i] = (int16_t) (lfsr * 7);          h16[i] = (int16_t) (lfsr * 13);
+        x32[i] = (int32_t) (lfsr * 0x101);      h32[i] = -(int32_t) (lfsr * 0x203);
+        xf[i]  = (float) x16[i] / 32768.0f;     hf[i]  = (float) h16[i] / 32768.0f;
+    }
+    x16[0] = INT16_MAX;  h16[0] = INT16_MIN;  x16[N_TAPS_MAX-1] = INT16_MIN;  h16[N_TAPS_MAX-1] = INT16_MAX;
+    x32[0] = INT32_MAX;  h32[0] = INT32_MIN;  x32[N_TAPS_MAX-1] = INT32_MIN;  h32[N_TAPS_MAX-1] = INT32_MIN;
+}
+
+/*******************************************************************************
+ *    SETUP, TEARDOWN
+ ******************************************************************************/
+void setUp(void) {
+    _fill();
+    g_all_tests_run = false;
+}
+
+void tearDown(void) {
+    TEST_ASSERT_TRUE(g_all_tests_run);
+    g_all_tests_run = false;
+}
+
+/*******************************************************************************
+ *    TESTS
+ ******************************************************************************/
+
+void test_delay_line(void) {
+    eex_dl_cb_t *dl = (eex_dl_cb_t *) dl_i16_5;
+    int16_t      sample;
+
+    TEST_ASSERT_EQUAL(5, eexDLNTaps(dl_i16_5));
+    TEST_ASSERT_EQUAL(2, dl->type_size);
+    for (int16_t i=1; i<=7; ++i) { eexDLUpdate(dl_i16_5, &i); }   // wraps the ring
+    for (uint32_t tap=0; tap<5; ++tap) {
+        sample = *(int16_t *) eexDLGetTap(dl_i16_5, tap);
+        TEST_ASSERT_EQUAL(7 - tap, sample);                         // newest at tap zero
+        TEST_ASSERT_EQUAL(7 - tap, ((int16_t *) eexDLTaps(dl_i16_5))[tap]);  // contiguous
+    }
+    TEST_ASSERTION_SHOULD_ASSERT(eexDLGetTap(dl_i16_5, 5));
+
+    g_all_tests_run = true;
+}
+
+void test_dot_i16(void) {
+    for (uint32_t n=0; n<=N_TAPS_MAX; ++n) {
+        TEST_ASSERT_EQUAL_INT64(_eexFirDotI16C(x16, h16, n), eexFirDotI16(x16, h16, n));
+        TEST_ASSERT_EQUAL_INT64(_eexFirDotI16C(&x16[1], h16, n - (n > 0)), eexFirDotI16(&x16[1], h16, n - (n > 0)));   // unaligned
+    }
+
+    g_all_tests_run = true;
+}
+
+void test_dot_i32(void) {
+    for (uint32_t n=0; n<=N_TAPS_MAX; ++n) {
+        TEST_ASSERT_EQUAL_INT64(_eexFirDotI32C(x32, h32, n), eexFirDotI32(x32, h32, n));
+        TEST_ASSERT_EQUAL_INT64(_eexFirDotI32C(&x32[1], h32, n - (n > 0)), eexFirDotI32(&x32[1], h32, n - (n > 0)));
+    }
+
+    g_all_tests_run = true;
+}
+
+void test_dot_f32(void) {
+    for (uint32_t n=0; n<=N_TAPS_MAX; ++n) {
+        TEST_ASSERT_FLOAT_WITHIN(1e-4f, _eexFirDotF32C(xf, hf, n), eexFirDotF32(xf, hf, n));
+        TEST_ASSERT_FLOAT_WITHIN(1e-4f, _eexFirDotF32C(&xf[1], hf, n - (n > 0)), eexFirDotF32(&xf[1], hf, n - (n > 0)));
+    }
+
+    g_all_tests_run = true;
+}
+
+void test_fir(void) {
+    const int16_t h_i16[5] = { 1, 2, 3, 4, 5 };
+    const int32_t h_i32[3] = { 1, -1, 2 };
+    const float   h_f32[4] = { 0.25f, 0.25f, 0.25f, 0.25f };   // moving average
+
+    TEST_ASSERT_EQUAL_INT64(1, eexFirI16(dl_fir_5, h_i16, 1));     // impulse response
+    for (int i=1; i<5; ++i) {
+        TEST_ASSERT_EQUAL_INT64(h_i16[i], eexFirI16(dl_fir_5, h_i16, 0));
+    }
+    TEST_ASSERT_EQUAL_INT64(0, eexFirI16(dl_fir_5, h_i16, 0));     // impulse has left the delay line
+
+    TEST_ASSERT_EQUAL_INT64(10,  eexFirI32(dl_i32_3, h_i32, 10));
+    TEST_ASSERT_EQUAL_INT64(10,  eexFirI32(dl_i32_3, h_i32, 20));  // 20 - 10
+    TEST_ASSERT_EQUAL_INT64(30,  eexFirI32(dl_i32_3, h_i32, 30));  // 30 - 20 + 20
+    TEST_ASSERT_EQUAL_INT64(50,  eexFirI32(dl_i32_3, h_i32, 40));  // 40 - 30 + 40
+
+    for (int i=0; i<4; ++i) { (void) eexFirF32(dl_f32_4, h_f32, 8.0f); }
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 8.0f, eexFirF32(dl_f32_4, h_f32, 8.0f));
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 6.0f, eexFirF32(dl_f32_4, h_f32, 0.0f));
+
+    TEST_ASSERTION_SHOULD_ASSERT(eexFirI32(dl_i16_5, h_i32, 0));  // wrong sample type
+
+    g_all_tests_run = true;
+}
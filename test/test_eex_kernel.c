@@ -33,11 +33,29 @@ extern volatile eex_thread_cb_t     g_thread_tcb[EEX_CFG_THREADS_MAX+1];
 extern volatile eex_thread_list_t   g_thread_ready_list;
 extern volatile eex_thread_list_t   g_thread_waiting_list;
 extern volatile eex_thread_list_t   g_thread_interrupted_list;
+extern volatile eex_thread_list_t   g_thread_preempted_list;
+extern volatile eex_thread_list_t   g_thread_suspended_list;
+extern volatile eex_thread_list_t   g_thread_abort_list;
+extern volatile eex_thread_list_t   g_thread_budget_list;
+extern volatile eex_thread_list_t   g_thread_exhausted_list;
+extern volatile eex_thread_list_t   g_thread_crit_list;
+extern volatile eex_thread_list_t   g_thread_sleep_list;
+extern volatile eex_thread_list_t   g_partition_threads[EEX_CFG_PARTITIONS+1];
+extern volatile eex_thread_list_t   g_thread_partitioned_list;
+extern volatile eex_thread_list_t   g_thread_table_wait_list;
+extern volatile eex_thread_list_t   g_table_released_list;
+extern volatile uint32_t            g_sleep_next;
+extern volatile eex_thread_list_t   g_crit_mask[EEX_CFG_CRIT_LEVELS];
+extern volatile uint32_t            g_crit_mode;
+extern volatile uint32_t            g_crit_n_switch;
+extern volatile uint32_t            g_crit_n_restore;
 extern volatile uint32_t            g_timer_ms;
 extern volatile uint32_t            g_timer_us;
 extern volatile uint32_t            g_mock_interrupt_level;
 
 extern volatile eex_kobj_cb_t       delay_kobj;
+extern volatile eex_kobj_cb_t       period_kobj;
+extern volatile eex_kobj_cb_t       table_kobj;
 
 /*******************************************************************************
  *    PRIVATE TYPES
@@ -47,8 +65,23 @@ extern volatile eex_kobj_cb_t       delay_kobj;
  *    PRIVATE DATA
  ******************************************************************************/
 EEX_SEMAPHORE_NEW(sema_10_10, 10, 10);
+EEX_SEMAPHORE_NEW(sema_1_0, 1, 0);
+EEX_SEMAPHORE_NEW(sema_threshold, 1, 0);
+EEX_SEMAPHORE_NEW(sema_threshold_hi, 1, 0);
+#if (EEX_CFG_WIDE_COUNT == 1)
+EEX_SEMAPHORE_NEW(sema_wide, 0x20000, 0xffff);
+#endif
 EEX_MUTEX_NEW(mutex);
 EEX_SIGNAL_NEW(sig);
+EEX_SIGNAL_BROADCAST_NEW(sig_bcast);
+EEX_POOL_NEW(pool_6_3, 6, 3);
+EEX_STREAM_NEW(stream_8, 8, 4);
+EEX_OBUF_NEW(obuf_40, 40);
+EEX_MUTEX_NEW(cond_mutex);
+EEX_COND_NEW(cond);
+EEX_RWLOCK_NEW(rwlock);
+EEX_BARRIER_NEW(barrier_3, 3);
+EEX_LATCH_NEW(latch_2, 2);
 
 bool  g_all_tests_run;
 
@@ -66,9 +99,31 @@ void setUp(void) {
     g_thread_ready_list       = EEX_EMPTY_THREAD_LIST;
     g_thread_waiting_list     = EEX_EMPTY_THREAD_LIST;
     g_thread_interrupted_list = EEX_EMPTY_THREAD_LIST;
+    g_thread_preempted_list   = EEX_EMPTY_THREAD_LIST;
+    g_thread_suspended_list   = EEX_EMPTY_THREAD_LIST;
+    g_thread_abort_list       = EEX_EMPTY_THREAD_LIST;
+    g_thread_budget_list      = EEX_EMPTY_THREAD_LIST;
+    g_thread_exhausted_list   = EEX_EMPTY_THREAD_LIST;
+    g_thread_crit_list        = EEX_EMPTY_THREAD_LIST;
+    g_thread_sleep_list       = EEX_EMPTY_THREAD_LIST;
+    g_sleep_next              = 0;
+    (void) memset((void *) g_partition_threads, 0, sizeof(g_partition_threads));
+    g_thread_partitioned_list = EEX_EMPTY_THREAD_LIST;
+    eexPartitionSchedule(NULL, 0);
+    eexTableSchedule(NULL, 0, 0);
+    g_thread_table_wait_list  = EEX_EMPTY_THREAD_LIST;
+    (void) memset((void *) g_crit_mask, 0, sizeof(g_crit_mask));
+    g_crit_mode               = 0;
+    g_crit_n_switch           = 0;
+    g_crit_n_restore          = 0;
     g_mock_interrupt_level    = 0;   // thread mode
     g_timer_ms                = 0;
     g_timer_us                = 0;
+    ((eex_pool_cb_t *) pool_6_3)->cb.pend = EEX_EMPTY_THREAD_LIST;
+    ((eex_pool_cb_t *) pool_6_3)->cb.post = EEX_EMPTY_THREAD_LIST;
+    ((eex_pool_cb_t *) pool_6_3)->free.td = 0;                  // every block never-allocated
+    ((eex_pool_cb_t *) pool_6_3)->fresh   = 0;
+    (void) memset((void *) ((eex_pool_cb_t *) pool_6_3)->link, 0, sizeof(uint32_t) * (3 + 1));
     _eexThreadIDSet(0);               // running thread
     g_all_tests_run = false;
 }
@@ -100,8 +155,8 @@ void test_kernel_timer(void) {
     g_all_tests_run = true;
 }
 
-// Tag initialized to 1, increments by one, rolls over at 16 bits, skips zero
-eex_tagged_data_t  _eexNewTaggedData(uint16_t data);
+// Tag initialized to 1, increments by one, rolls over at 16 bits (32 if EEX_CFG_WIDE_COUNT), skips zero
+eex_tagged_data_t  _eexNewTaggedData(eex_count_t data);
 void test_tagged_data_generator(void) {
     eex_tagged_data_t td;
 
@@ -109,10 +164,17 @@ void test_tagged_data_generator(void) {
                                     TEST_ASSERT_EQUAL_INT(td.tag+1, _eexNewTaggedData(0xffff).tag); TEST_ASSERT_EQUAL_INT(0, td.data);
     td = _eexNewTaggedData(0x1234); TEST_ASSERT_EQUAL_INT(3, td.tag);                               TEST_ASSERT_EQUAL_INT(0x1234, td.data);
 
+#if (EEX_CFG_WIDE_COUNT == 1)
+    TEST_ASSERT_EQUAL(8, sizeof(eex_tagged_data_t));
+    td = _eexNewTaggedData(0x12345678);                                                             TEST_ASSERT_EQUAL(0x12345678, td.data);
+    for (int i=5; i<0x10001; ++i) { td = _eexNewTaggedData(0); }
+                                    TEST_ASSERT_EQUAL(0x10000, td.tag);                             // no rollover at 16 bits
+#else
     for (int i=4; i<0xffff; ++i) { td = _eexNewTaggedData(0); }
                                     TEST_ASSERT_EQUAL_INT(0xfffe, td.tag);                          TEST_ASSERT_EQUAL_INT(0, td.data);
     td = _eexNewTaggedData(5678);   TEST_ASSERT_EQUAL_INT(0xffff, td.tag);                          TEST_ASSERT_EQUAL_INT(5678, td.data);
     td = _eexNewTaggedData(9012);   TEST_ASSERT_EQUAL_INT(1, td.tag);                               TEST_ASSERT_EQUAL_INT(9012, td.data);
+#endif
 
     g_all_tests_run = true;
 }
@@ -245,6 +307,17 @@ void test_bm_ff1(void) {
     g_all_tests_run = true;
 }
 
+uint32_t  _eexBMCount(const eex_bm_t a);
+void test_bm_count(void) {
+    TEST_ASSERT_EQUAL(0, _eexBMCount(0));
+    TEST_ASSERT_EQUAL(1, _eexBMCount(0x80000000));
+    TEST_ASSERT_EQUAL(2, _eexBMCount(0x80000001));
+    TEST_ASSERT_EQUAL(16, _eexBMCount(0x5555aaaa));
+    TEST_ASSERT_EQUAL(32, _eexBMCount(0xffffffff));
+
+    g_all_tests_run = true;
+}
+
 eex_thread_list_t * _eexThreadListGet(eex_thread_list_selector_t which_list);
 void test_thread_list_get(void) {
     TEST_ASSERT_EQUAL_PTR(&g_thread_ready_list,       _eexThreadListGet(EEX_THREAD_READY));
@@ -387,6 +460,14 @@ void test_thread_timeout_next(void) {
     g_thread_tcb[test_pri_M].event.timeout = 0;
     TEST_ASSERT_EQUAL(301, _eexThreadTimeoutNext());
 
+    // an overdue deadline is -1 whatever it is for, it isn't skipped
+    g_timer_ms = 310;
+    TEST_ASSERT_EQUAL(-1, _eexThreadTimeoutNext());   // event_L is overdue
+    g_thread_tcb[test_pri_L].event.timeout = 0;
+    _eexThreadListAdd(&g_thread_exhausted_list, test_pri_H);
+    g_thread_tcb[test_pri_H].budget.next_ms = 305;
+    TEST_ASSERT_EQUAL(-1, _eexThreadTimeoutNext());   // budget replenishment is overdue
+
     g_all_tests_run = true;
 }
 
@@ -486,7 +567,7 @@ void test_event_init_remove(void) {
     g_all_tests_run = true;
 }
 
-bool _eexSignalTry(eex_thread_event_t *event);
+bool _eexSignalTry(eex_thread_id_t tid, eex_thread_event_t *event);
 void test_signal_try(void) {
     eex_thread_id_t     test_pri = EEX_CFG_THREADS_MAX;
     eex_thread_event_t *event    = &(eexThreadTCB(test_pri)->event);
@@ -496,24 +577,24 @@ void test_signal_try(void) {
     _eexThreadIDSet(test_pri);
 
     _eexEventInit((void *) 0xabcd1234, &rtn_status, &rtn_val, 5, 0xffffffff, sig, EEX_EVENT_PEND);    // mask = 0xffffffff
-    TEST_ASSERTION_SHOULD_NOT_ASSERT(_eexSignalTry(event)); TEST_ASSERT_EQUAL(0, rtn_val);            // initial value
+    TEST_ASSERTION_SHOULD_NOT_ASSERT(_eexSignalTry(test_pri, event)); TEST_ASSERT_EQUAL(0, rtn_val);            // initial value
     _eexEventInit((void *) 0xabcd1234, &rtn_status, &rtn_val, 5, 1, sig, EEX_EVENT_POST);             // signal now 0x00000001
-    TEST_ASSERTION_SHOULD_NOT_ASSERT(_eexSignalTry(event));
+    TEST_ASSERTION_SHOULD_NOT_ASSERT(_eexSignalTry(test_pri, event));
     _eexEventInit((void *) 0xabcd1234, &rtn_status, &rtn_val, 5, 1, sig, EEX_EVENT_NO_ACTION);
-    TEST_ASSERTION_SHOULD_ASSERT(_eexSignalTry(event));
+    TEST_ASSERTION_SHOULD_ASSERT(_eexSignalTry(test_pri, event));
 
     _eexEventInit((void *) 0xabcd1234, &rtn_status, &rtn_val, 5, 0x10101010, sig, EEX_EVENT_POST);    // signal now 0x10101011
-    TEST_ASSERT_TRUE(_eexSignalTry(event));
+    TEST_ASSERT_TRUE(_eexSignalTry(test_pri, event));
     _eexEventInit((void *) 0xabcd1234, &rtn_status, &rtn_val, 5, 0, sig, EEX_EVENT_PEND);             // set mask = 0
-    TEST_ASSERT_FALSE(_eexSignalTry(event));          TEST_ASSERT_EQUAL(0, rtn_val);                  // 0x10101011 & 0 = 0
+    TEST_ASSERT_FALSE(_eexSignalTry(test_pri, event));  TEST_ASSERT_EQUAL(0, rtn_val);                 // 0x10101011 & 0 = 0
     _eexEventInit((void *) 0xabcd1234, &rtn_status, &rtn_val, 5, 0x00000010, sig, EEX_EVENT_PEND);    // mask = 0x00000010
-    TEST_ASSERT_TRUE(_eexSignalTry(event));           TEST_ASSERT_EQUAL(0x00000010, rtn_val);         // signal now 0x10101001
+    TEST_ASSERT_TRUE(_eexSignalTry(test_pri, event));   TEST_ASSERT_EQUAL(0x00000010, rtn_val);       // signal now 0x10101001
     _eexEventInit((void *) 0xabcd1234, &rtn_status, &rtn_val, 5, 0x01010101, sig, EEX_EVENT_PEND);    // mask = 0x01010101
-    TEST_ASSERT_TRUE(_eexSignalTry(event));          TEST_ASSERT_EQUAL(1, rtn_val);                   // signal now 0x10101000
+    TEST_ASSERT_TRUE(_eexSignalTry(test_pri, event));   TEST_ASSERT_EQUAL(1, rtn_val);                 // signal now 0x10101000
     _eexEventInit((void *) 0xabcd1234, &rtn_status, &rtn_val, 5, 0xffffffff, sig, EEX_EVENT_PEND);    // mask = 0xffffffff
-    TEST_ASSERT_TRUE(_eexSignalTry(event));           TEST_ASSERT_EQUAL(0x10101000, rtn_val);         // signal now 0
+    TEST_ASSERT_TRUE(_eexSignalTry(test_pri, event));   TEST_ASSERT_EQUAL(0x10101000, rtn_val);       // signal now 0
     _eexEventInit((void *) 0xabcd1234, &rtn_status, &rtn_val, 5, 0xffffffff, sig, EEX_EVENT_PEND);    // mask = 0xffffffff
-    TEST_ASSERT_FALSE(_eexSignalTry(event));          TEST_ASSERT_EQUAL(0, rtn_val);                  // signal now 0
+    TEST_ASSERT_FALSE(_eexSignalTry(test_pri, event));  TEST_ASSERT_EQUAL(0, rtn_val);                 // signal now 0
 
     g_all_tests_run = true;
 }
@@ -547,6 +628,11 @@ void test_semaphore_try(void) {
     _eexEventInit((void *) 0xabcd1234, &rtn_status, &rtn_val, 5, 0, sema_10_10, EEX_EVENT_PEND);
     TEST_ASSERT_TRUE(_eexSemaMutexTry(event));       TEST_ASSERT_EQUAL_UINT16(0, rtn_val);          // dec
 
+#if (EEX_CFG_WIDE_COUNT == 1)
+    _eexEventInit((void *) 0xabcd1234, &rtn_status, &rtn_val, 5, 0, sema_wide, EEX_EVENT_POST);
+    TEST_ASSERT_TRUE(_eexSemaMutexTry(event));       TEST_ASSERT_EQUAL(0x10000, rtn_val);           // count past 16 bits
+#endif
+
     g_all_tests_run = true;
 }
 
@@ -577,6 +663,169 @@ void test_mutex_try(void) {
     g_all_tests_run = true;
 }
 
+bool _eexPoolTry(eex_thread_event_t *event);
+void test_pool_try(void) {
+    eex_thread_event_t *event    = &(eexThreadTCB(EEX_CFG_THREADS_MAX)->event);
+    eex_pool_cb_t      *pool     = (eex_pool_cb_t *) pool_6_3;
+    eex_status_t        rtn_status;
+    uint32_t            rtn_val, blk[3];
+
+    _eexThreadIDSet(EEX_CFG_THREADS_MAX);
+
+    TEST_ASSERT_EQUAL('POOL', pool->cb.type);
+    TEST_ASSERT_EQUAL(8, pool->blk_size);                                                       // rounded up to a multiple of 4
+    _eexEventInit((void *) 0xabcd1234, &rtn_status, &rtn_val, 5, 0, pool_6_3, EEX_EVENT_NO_ACTION);
+    TEST_ASSERTION_SHOULD_ASSERT(_eexPoolTry(event));                                          // must be pend or post
+    for (int i=0; i<3; ++i) {                                                                   // allocate all blocks
+        _eexEventInit((void *) 0xabcd1234, &rtn_status, &rtn_val, 5, 0, pool_6_3, EEX_EVENT_PEND);
+        TEST_ASSERT_TRUE(_eexPoolTry(event));
+        TEST_ASSERT_EQUAL_HEX((uint32_t) (uintptr_t) &pool->mem[i * 8], rtn_val);
+        blk[i] = rtn_val;
+    }
+    _eexEventInit((void *) 0xabcd1234, &rtn_status, &rtn_val, 5, 0, pool_6_3, EEX_EVENT_PEND);
+    TEST_ASSERT_FALSE(_eexPoolTry(event));           TEST_ASSERT_EQUAL(0, rtn_val);            // pool exhausted
+    _eexEventInit((void *) 0xabcd1234, &rtn_status, &rtn_val, 5, blk[1] + 1, pool_6_3, EEX_EVENT_POST);
+    TEST_ASSERT_FALSE(_eexPoolTry(event));                                                      // not on a block boundary
+    _eexEventInit((void *) 0xabcd1234, &rtn_status, &rtn_val, 5, blk[0] + 24, pool_6_3, EEX_EVENT_POST);
+    TEST_ASSERT_FALSE(_eexPoolTry(event));                                                      // past the end of the pool
+    _eexEventInit((void *) 0xabcd1234, &rtn_status, &rtn_val, 5, blk[1], pool_6_3, EEX_EVENT_POST);
+    TEST_ASSERT_TRUE(_eexPoolTry(event));                                                       // free
+    TEST_ASSERT_FALSE(_eexPoolTry(event));                                                      // already free
+    _eexEventInit((void *) 0xabcd1234, &rtn_status, &rtn_val, 5, blk[2], pool_6_3, EEX_EVENT_POST);
+    TEST_ASSERT_TRUE(_eexPoolTry(event));                                                       // free
+    _eexEventInit((void *) 0xabcd1234, &rtn_status, &rtn_val, 5, blk[1], pool_6_3, EEX_EVENT_POST);
+    TEST_ASSERT_FALSE(_eexPoolTry(event));                                                      // already free, not at the head
+    _eexEventInit((void *) 0xabcd1234, &rtn_status, &rtn_val, 5, 0, pool_6_3, EEX_EVENT_PEND);
+    TEST_ASSERT_TRUE(_eexPoolTry(event));            TEST_ASSERT_EQUAL_HEX(blk[2], rtn_val);   // last freed is first allocated
+    _eexEventInit((void *) 0xabcd1234, &rtn_status, &rtn_val, 5, 0, pool_6_3, EEX_EVENT_PEND);
+    TEST_ASSERT_TRUE(_eexPoolTry(event));            TEST_ASSERT_EQUAL_HEX(blk[1], rtn_val);
+    _eexEventInit((void *) 0xabcd1234, &rtn_status, &rtn_val, 5, 0, pool_6_3, EEX_EVENT_PEND);
+    TEST_ASSERT_FALSE(_eexPoolTry(event));                                                      // exhausted again
+
+    g_all_tests_run = true;
+}
+
+bool _eexStreamTry(eex_thread_event_t *event);
+void test_stream_try(void) {
+    eex_thread_event_t *event    = &(eexThreadTCB(EEX_CFG_THREADS_MAX)->event);
+    eex_stream_cb_t    *stream   = (eex_stream_cb_t *) stream_8;
+    eex_status_t        rtn_status;
+    uint32_t            rtn_val, len;
+    uint8_t             buf[8];
+    uint8_t            *wspan;
+    const uint8_t      *rspan;
+
+    _eexThreadIDSet(EEX_CFG_THREADS_MAX);
+
+    TEST_ASSERT_EQUAL('STRM', stream->cb.type);
+    _eexEventInit((void *) 0xabcd1234, &rtn_status, &rtn_val, 5, 0, stream_8, EEX_EVENT_NO_ACTION);
+    TEST_ASSERTION_SHOULD_ASSERT(_eexStreamTry(event));                                        // must be pend or post
+    _eexEventInit((void *) 0xabcd1234, &rtn_status, &rtn_val, 5, 0, stream_8, EEX_EVENT_PEND);
+    TEST_ASSERT_FALSE(_eexStreamTry(event));         TEST_ASSERT_EQUAL(0, rtn_val);            // empty
+
+    TEST_ASSERT_EQUAL(3, eexStreamWrite(stream_8, "abc", 3));                                   // written but not committed by a post
+    _eexEventInit((void *) 0xabcd1234, &rtn_status, &rtn_val, 5, 0, stream_8, EEX_EVENT_PEND);
+    TEST_ASSERT_FALSE(_eexStreamTry(event));         TEST_ASSERT_EQUAL(3, rtn_val);            // below trigger level
+    _eexEventInit((void *) 0xabcd1234, &rtn_status, &rtn_val, 5, 2, stream_8, EEX_EVENT_PEND);
+    TEST_ASSERT_TRUE(_eexStreamTry(event));          TEST_ASSERT_EQUAL(3, rtn_val);            // explicit count
+    TEST_ASSERT_EQUAL(3, eexStreamRead(stream_8, buf, 8));
+    TEST_ASSERT_EQUAL_MEMORY("abc", buf, 3);
+
+    wspan = eexStreamWriteSpan(stream_8, &len);
+    TEST_ASSERT_EQUAL(5, len);                                                                  // span stops at the end of the ring
+    memcpy(wspan, "defgh", 5);
+    _eexEventInit((void *) 0xabcd1234, &rtn_status, &rtn_val, 5, 5, stream_8, EEX_EVENT_POST);
+    TEST_ASSERT_TRUE(_eexStreamTry(event));                                                     // commit
+    wspan = eexStreamWriteSpan(stream_8, &len);
+    TEST_ASSERT_EQUAL(3, len);                                                                  // wrapped
+    TEST_ASSERT_EQUAL_PTR(stream->buf, wspan);
+    _eexEventInit((void *) 0xabcd1234, &rtn_status, &rtn_val, 5, 4, stream_8, EEX_EVENT_POST);
+    TEST_ASSERT_FALSE(_eexStreamTry(event));                                                    // doesn't fit
+    TEST_ASSERT_EQUAL(3, eexStreamWrite(stream_8, "ijklm", 5));                                 // truncated to free space
+    _eexEventInit((void *) 0xabcd1234, &rtn_status, &rtn_val, 5, 0, stream_8, EEX_EVENT_PEND);
+    TEST_ASSERT_TRUE(_eexStreamTry(event));          TEST_ASSERT_EQUAL(8, rtn_val);            // full
+
+    rspan = eexStreamReadSpan(stream_8, &len);
+    TEST_ASSERT_EQUAL(5, len);
+    TEST_ASSERT_EQUAL_MEMORY("defgh", rspan, 5);
+    TEST_ASSERTION_SHOULD_ASSERT(eexStreamReadRelease(stream_8, 9));                           // more than available
+    eexStreamReadRelease(stream_8, 5);
+    rspan = eexStreamReadSpan(stream_8, &len);
+    TEST_ASSERT_EQUAL(3, len);
+    TEST_ASSERT_EQUAL_MEMORY("ijk", rspan, 3);
+    eexStreamReadRelease(stream_8, 3);
+
+    eexStreamTriggerSet(stream_8, 100);
+    TEST_ASSERT_EQUAL(8, stream->trigger);                                                      // limited to the ring size
+    eexStreamTriggerSet(stream_8, 4);
+
+    g_all_tests_run = true;
+}
+
+bool _eexObufTry(eex_thread_event_t *event);
+void test_obuf_try(void) {
+    eex_thread_event_t *event    = &(eexThreadTCB(EEX_CFG_THREADS_MAX)->event);
+    eex_obuf_cb_t      *obuf     = (eex_obuf_cb_t *) obuf_40;
+    eex_obuf_stats_t    stats;
+    eex_status_t        rtn_status;
+    uint32_t            rtn_val, blk[3];
+
+    _eexThreadIDSet(EEX_CFG_THREADS_MAX);
+
+    TEST_ASSERT_EQUAL('OBUF', obuf->cb.type);
+    TEST_ASSERT_EQUAL(10, obuf->n_words);
+    _eexEventInit((void *) 0xabcd1234, &rtn_status, &rtn_val, 5, 0, obuf_40, EEX_EVENT_NO_ACTION);
+    TEST_ASSERTION_SHOULD_ASSERT(_eexObufTry(event));                                          // must be pend or post
+
+    _eexEventInit((void *) 0xabcd1234, &rtn_status, &rtn_val, 5, 8, obuf_40, EEX_EVENT_PEND);
+    TEST_ASSERT_TRUE(_eexObufTry(event));            TEST_ASSERT_EQUAL_HEX((uint32_t) (uintptr_t) &obuf->buf[1], rtn_val);
+    blk[0] = rtn_val;
+    _eexEventInit((void *) 0xabcd1234, &rtn_status, &rtn_val, 5, 10, obuf_40, EEX_EVENT_PEND);
+    TEST_ASSERT_TRUE(_eexObufTry(event));            TEST_ASSERT_EQUAL_HEX((uint32_t) (uintptr_t) &obuf->buf[4], rtn_val);
+    blk[1] = rtn_val;
+    _eexEventInit((void *) 0xabcd1234, &rtn_status, &rtn_val, 5, 8, obuf_40, EEX_EVENT_PEND);
+    TEST_ASSERT_FALSE(_eexObufTry(event));           TEST_ASSERT_EQUAL(0, rtn_val);            // one word short
+
+    _eexEventInit((void *) 0xabcd1234, &rtn_status, &rtn_val, 5, blk[1] + 2, obuf_40, EEX_EVENT_POST);
+    TEST_ASSERT_FALSE(_eexObufTry(event));                                                      // not word aligned
+    _eexEventInit((void *) 0xabcd1234, &rtn_status, &rtn_val, 5, 0x10, obuf_40, EEX_EVENT_POST);
+    TEST_ASSERT_TRUE(_eexObufTry(event));                                                       // not in the ring, ignored
+    _eexEventInit((void *) 0xabcd1234, &rtn_status, &rtn_val, 5, blk[1], obuf_40, EEX_EVENT_POST);
+    TEST_ASSERT_TRUE(_eexObufTry(event));                                                       // freed out of order
+    TEST_ASSERT_EQUAL(0, obuf->idx.tail);                                                       // but not reclaimed
+    _eexEventInit((void *) 0xabcd1234, &rtn_status, &rtn_val, 5, blk[1], obuf_40, EEX_EVENT_POST);
+    TEST_ASSERT_FALSE(_eexObufTry(event));                                                      // already freed
+    _eexEventInit((void *) 0xabcd1234, &rtn_status, &rtn_val, 5, blk[0], obuf_40, EEX_EVENT_POST);
+    TEST_ASSERT_TRUE(_eexObufTry(event));                                                       // oldest freed, both reclaimed
+    TEST_ASSERT_EQUAL(obuf->idx.head, obuf->idx.tail);
+
+    _eexEventInit((void *) 0xabcd1234, &rtn_status, &rtn_val, 5, 16, obuf_40, EEX_EVENT_PEND);
+    TEST_ASSERT_TRUE(_eexObufTry(event));            TEST_ASSERT_EQUAL_HEX((uint32_t) (uintptr_t) &obuf->buf[1], rtn_val);  // empty ring starts over
+    blk[0] = rtn_val;
+    _eexEventInit((void *) 0xabcd1234, &rtn_status, &rtn_val, 5, 8, obuf_40, EEX_EVENT_PEND);
+    TEST_ASSERT_TRUE(_eexObufTry(event));            TEST_ASSERT_EQUAL_HEX((uint32_t) (uintptr_t) &obuf->buf[6], rtn_val);
+    blk[1] = rtn_val;
+    _eexEventInit((void *) 0xabcd1234, &rtn_status, &rtn_val, 5, blk[0], obuf_40, EEX_EVENT_POST);
+    TEST_ASSERT_TRUE(_eexObufTry(event));
+    _eexEventInit((void *) 0xabcd1234, &rtn_status, &rtn_val, 5, 12, obuf_40, EEX_EVENT_PEND);
+    TEST_ASSERT_TRUE(_eexObufTry(event));            TEST_ASSERT_EQUAL_HEX((uint32_t) (uintptr_t) &obuf->buf[1], rtn_val);  // wrapped, end of ring padded
+    blk[2] = rtn_val;
+    _eexEventInit((void *) 0xabcd1234, &rtn_status, &rtn_val, 5, blk[1], obuf_40, EEX_EVENT_POST);
+    TEST_ASSERT_TRUE(_eexObufTry(event));
+    TEST_ASSERT_EQUAL(0, obuf->idx.tail);                                                       // pad reclaimed too
+    TEST_ASSERT_EQUAL(4, obuf->idx.head);
+
+    eexObufStats(obuf_40, &stats);
+    TEST_ASSERT_EQUAL(20, stats.free);
+    TEST_ASSERT_EQUAL(0, stats.min_free);                                                       // was full before the wrap
+    TEST_ASSERT_EQUAL(0, stats.n_failed);                                                       // counted by the event, not the try
+
+    _eexEventInit((void *) 0xabcd1234, &rtn_status, &rtn_val, 5, blk[2], obuf_40, EEX_EVENT_POST);
+    TEST_ASSERT_TRUE(_eexObufTry(event));                                                       // leave the ring empty
+
+    g_all_tests_run = true;
+}
+
 eex_thread_id_t _eexEventTry(eex_thread_id_t evt_thread_priority, const eex_thread_event_t *event);
 void test_event_try(void) {
     eex_thread_event_t *event, int_event;
@@ -645,6 +894,696 @@ void test_event_try(void) {
     g_all_tests_run = true;
 }
 
+void test_event_try_signal_broadcast(void) {
+    eex_thread_event_t *event, int_event;
+    eex_thread_id_t     test_pri = EEX_CFG_THREADS_MAX;
+    eex_status_t        rtn_status[3], int_status;
+    uint32_t            rtn_val[3];
+    const uint32_t      mask[3] = { 0x01, 0x11, 0x02 };
+
+    // three threads wait, two of them on bit 0
+    for (int i=0; i<3; ++i) {
+        _eexThreadIDSet(test_pri-i);
+        event = &(eexThreadTCB(test_pri-i)->event);
+        _eexEventInit((void *) 0xabcd1234, &rtn_status[i], &rtn_val[i], eexWaitForever, mask[i], sig_bcast, EEX_EVENT_PEND);
+        TEST_ASSERT_EQUAL(0, _eexEventTry(test_pri-i, event));
+    }
+
+    // interrupt posts bit 0, every matching waiter succeeds and the bit stays set
+    _eexThreadIDSet(1);
+    g_mock_interrupt_level = 1;
+    _eexEventInit(&int_event, &int_status, NULL, 0, 0x01, sig_bcast, EEX_EVENT_POST);
+    TEST_ASSERT_EQUAL(test_pri, _eexEventTry(1, &int_event));
+    g_mock_interrupt_level = 0;
+    for (int i=0; i<2; ++i) {
+        event = &(eexThreadTCB(test_pri-i)->event);
+        TEST_ASSERT_EQUAL(test_pri-i, _eexEventTry(test_pri-i, event));
+        TEST_ASSERT_EQUAL(eexStatusOK, rtn_status[i]);
+        TEST_ASSERT_EQUAL(0x01, rtn_val[i]);
+    }
+    event = &(eexThreadTCB(test_pri-2)->event);
+    TEST_ASSERT_EQUAL(0, _eexEventTry(test_pri-2, event));                  // mask doesn't match
+    TEST_ASSERT_EQUAL(0x01, ((eex_signal_cb_t *) sig_bcast)->signal);
+    TEST_ASSERT_EQUAL(1 << (test_pri-3), ((eex_kobj_cb_t *) sig_bcast)->pend);
+
+    // explicit clear
+    eexSignalClear(sig_bcast, 0xffffffff);
+    TEST_ASSERT_EQUAL(0, ((eex_signal_cb_t *) sig_bcast)->signal);
+    _eexThreadIDSet(test_pri);
+    event = &(eexThreadTCB(test_pri)->event);
+    _eexEventInit((void *) 0xabcd1234, &rtn_status[0], &rtn_val[0], 0, 0x01, sig_bcast, EEX_EVENT_PEND);
+    TEST_ASSERT_EQUAL(test_pri, _eexEventTry(test_pri, event));
+    TEST_ASSERT_EQUAL(eexStatusSignalNone, rtn_status[0]);
+
+    // a clear right after a post doesn't strand the waiters the post released
+    for (int i=0; i<3; ++i) {
+        _eexThreadIDSet(test_pri-i);
+        event = &(eexThreadTCB(test_pri-i)->event);
+        _eexEventInit((void *) 0xabcd1234, &rtn_status[i], &rtn_val[i], eexWaitForever, mask[i], sig_bcast, EEX_EVENT_PEND);
+        TEST_ASSERT_EQUAL(0, _eexEventTry(test_pri-i, event));
+    }
+    _eexThreadIDSet(1);
+    g_mock_interrupt_level = 1;
+    _eexEventInit(&int_event, &int_status, NULL, 0, 0x03, sig_bcast, EEX_EVENT_POST);
+    TEST_ASSERT_EQUAL(test_pri, _eexEventTry(1, &int_event));
+    g_mock_interrupt_level = 0;
+    eexSignalClear(sig_bcast, 0xffffffff);
+    for (int i=0; i<3; ++i) {
+        event = &(eexThreadTCB(test_pri-i)->event);
+        TEST_ASSERT_EQUAL(test_pri-i, _eexEventTry(test_pri-i, event));
+        TEST_ASSERT_EQUAL(eexStatusOK, rtn_status[i]);
+        TEST_ASSERT_EQUAL(mask[i] & 0x03, rtn_val[i]);                      // the bits that released it
+    }
+    TEST_ASSERT_EQUAL(0, ((eex_signal_cb_t *) sig_bcast)->released);
+    TEST_ASSERT_EQUAL(0, ((eex_kobj_cb_t *) sig_bcast)->pend);
+    TEST_ASSERTION_SHOULD_ASSERT(eexSignalClear(mutex, 1));                 // not a signal
+
+    g_all_tests_run = true;
+}
+
+void test_event_try_pool(void) {
+    eex_thread_event_t *event;
+    eex_thread_id_t     tid, test_pri = EEX_CFG_THREADS_MAX;
+    eex_status_t        rtn_status;
+    uint32_t            rtn_val, blk;
+
+    _eexThreadIDSet(test_pri);
+    event = &(eexThreadTCB(test_pri)->event);
+    for (int i=0; i<3; ++i) {             // exhaust the pool
+        _eexEventInit((void *) 0xabcd1234, &rtn_status, &rtn_val, 0, 0, pool_6_3, EEX_EVENT_PEND);
+        TEST_ASSERT_EQUAL(test_pri, _eexEventTry(test_pri, event));
+        TEST_ASSERT_EQUAL(eexStatusOK, rtn_status);
+    }
+    _eexEventInit((void *) 0xabcd1234, &rtn_status, &rtn_val, 0, 0, pool_6_3, EEX_EVENT_PEND);
+    tid = _eexEventTry(test_pri, event);
+    TEST_ASSERT_EQUAL(test_pri, tid);     // pend unsuccessful but nonblocking
+    TEST_ASSERT_EQUAL(eexStatusEventNotReady, rtn_status);
+    _eexEventInit((void *) 0xabcd1234, &rtn_status, &rtn_val, 5, 0, pool_6_3, EEX_EVENT_PEND);
+    tid = _eexEventTry(test_pri, event);
+    TEST_ASSERT_EQUAL(0, tid);            // pend unsuccessful, timeout != 0, block
+
+    _eexThreadIDSet(test_pri-1);          // free from a lower priority thread
+    event = &(eexThreadTCB(test_pri-1)->event);
+    _eexEventInit((void *) 0xabcd1234, &rtn_status, &rtn_val, 0, 1, pool_6_3, EEX_EVENT_POST);
+    tid = _eexEventTry(test_pri-1, event);
+    TEST_ASSERT_EQUAL(test_pri-1, tid);   // not a pool block, nothing unblocked
+    TEST_ASSERT_EQUAL(eexStatusKOPoolPtrErr, rtn_status);
+    blk = (uint32_t) (uintptr_t) ((eex_pool_cb_t *) pool_6_3)->mem;
+    _eexEventInit((void *) 0xabcd1234, &rtn_status, &rtn_val, 0, blk, pool_6_3, EEX_EVENT_POST);
+    tid = _eexEventTry(test_pri-1, event);
+    TEST_ASSERT_EQUAL(test_pri, tid);     // free successful, higher priority thread unblocked
+    TEST_ASSERT_EQUAL(eexStatusOK, rtn_status);
+
+    // blocked thread is tried again by the scheduler
+    event = &(eexThreadTCB(test_pri)->event);
+    tid = _eexEventTry(test_pri, event);
+    TEST_ASSERT_EQUAL(test_pri, tid);
+    TEST_ASSERT_EQUAL(eexStatusOK, rtn_status);
+    TEST_ASSERT_EQUAL_HEX(blk, rtn_val);
+    TEST_ASSERT_EQUAL(0, ((eex_kobj_cb_t *) pool_6_3)->pend);
+
+    // a block freed twice is only freed once
+    _eexThreadIDSet(test_pri-1);
+    event = &(eexThreadTCB(test_pri-1)->event);
+    _eexEventInit((void *) 0xabcd1234, &rtn_status, &rtn_val, 0, blk, pool_6_3, EEX_EVENT_POST);
+    TEST_ASSERT_EQUAL(test_pri-1, _eexEventTry(test_pri-1, event));
+    TEST_ASSERT_EQUAL(eexStatusOK, rtn_status);
+    _eexEventInit((void *) 0xabcd1234, &rtn_status, &rtn_val, 0, blk, pool_6_3, EEX_EVENT_POST);
+    TEST_ASSERT_EQUAL(test_pri-1, _eexEventTry(test_pri-1, event));
+    TEST_ASSERT_EQUAL(eexStatusKOPoolPtrErr, rtn_status);
+    TEST_ASSERT_EQUAL(1, ((eex_pool_cb_t *) pool_6_3)->free.data);
+    TEST_ASSERT_EQUAL(0, ((eex_pool_cb_t *) pool_6_3)->link[1]);
+
+    g_all_tests_run = true;
+}
+
+void test_event_try_stream(void) {
+    eex_thread_event_t *event;
+    eex_thread_id_t     tid, test_pri = EEX_CFG_THREADS_MAX;
+    eex_status_t        rtn_status;
+    uint32_t            rtn_val;
+
+    // stream_8 is empty with a trigger level of 4 from test_stream_try, above
+    _eexThreadIDSet(test_pri);
+    event = &(eexThreadTCB(test_pri)->event);
+    _eexEventInit((void *) 0xabcd1234, &rtn_status, &rtn_val, 0, 0, stream_8, EEX_EVENT_PEND);
+    tid = _eexEventTry(test_pri, event);
+    TEST_ASSERT_EQUAL(test_pri, tid);     // pend unsuccessful but nonblocking
+    TEST_ASSERT_EQUAL(eexStatusEventNotReady, rtn_status);
+    _eexEventInit((void *) 0xabcd1234, &rtn_status, &rtn_val, 5, 0, stream_8, EEX_EVENT_PEND);
+    tid = _eexEventTry(test_pri, event);
+    TEST_ASSERT_EQUAL(0, tid);            // pend unsuccessful, timeout != 0, block
+
+    _eexThreadIDSet(test_pri-1);          // produce from a lower priority thread
+    event = &(eexThreadTCB(test_pri-1)->event);
+    (void) eexStreamWrite(stream_8, "abc", 3);
+    stream_8_storage.head -= 3;           // uncommit, written bytes are committed by the post
+    _eexEventInit((void *) 0xabcd1234, &rtn_status, &rtn_val, 0, 3, stream_8, EEX_EVENT_POST);
+    tid = _eexEventTry(test_pri-1, event);
+    TEST_ASSERT_EQUAL(test_pri-1, tid);   // below trigger level, nothing unblocked
+    TEST_ASSERT_EQUAL(eexStatusOK, rtn_status);
+    _eexEventInit((void *) 0xabcd1234, &rtn_status, &rtn_val, 0, 6, stream_8, EEX_EVENT_POST);
+    tid = _eexEventTry(test_pri-1, event);
+    TEST_ASSERT_EQUAL(test_pri-1, tid);   // doesn't fit
+    TEST_ASSERT_EQUAL(eexStatusKOStreamFull, rtn_status);
+    _eexEventInit((void *) 0xabcd1234, &rtn_status, &rtn_val, 0, 1, stream_8, EEX_EVENT_POST);
+    tid = _eexEventTry(test_pri-1, event);
+    TEST_ASSERT_EQUAL(test_pri, tid);     // trigger level reached, higher priority thread unblocked
+    TEST_ASSERT_EQUAL(eexStatusOK, rtn_status);
+
+    // blocked thread is tried again by the scheduler
+    event = &(eexThreadTCB(test_pri)->event);
+    tid = _eexEventTry(test_pri, event);
+    TEST_ASSERT_EQUAL(test_pri, tid);
+    TEST_ASSERT_EQUAL(eexStatusOK, rtn_status);
+    TEST_ASSERT_EQUAL(4, rtn_val);
+    TEST_ASSERT_EQUAL(0, ((eex_kobj_cb_t *) stream_8)->pend);
+
+    g_all_tests_run = true;
+}
+
+void test_event_try_obuf(void) {
+    eex_thread_event_t *event;
+    eex_thread_id_t     tid, test_pri = EEX_CFG_THREADS_MAX;
+    eex_status_t        rtn_status;
+    uint32_t            rtn_val, blk;
+    eex_obuf_stats_t    stats;
+
+    // obuf_40 is empty from test_obuf_try, above. Fill all but 12 bytes.
+    _eexThreadIDSet(test_pri);
+    event = &(eexThreadTCB(test_pri)->event);
+    _eexEventInit((void *) 0xabcd1234, &rtn_status, &rtn_val, 0, 20, obuf_40, EEX_EVENT_PEND);
+    tid = _eexEventTry(test_pri, event);
+    TEST_ASSERT_EQUAL(test_pri, tid);
+    TEST_ASSERT_EQUAL(eexStatusOK, rtn_status);
+    blk = rtn_val;
+    _eexEventInit((void *) 0xabcd1234, &rtn_status, &rtn_val, 0, 16, obuf_40, EEX_EVENT_PEND);
+    tid = _eexEventTry(test_pri, event);
+    TEST_ASSERT_EQUAL(test_pri, tid);     // pend unsuccessful but nonblocking
+    TEST_ASSERT_EQUAL(eexStatusEventNotReady, rtn_status);
+    _eexEventInit((void *) 0xabcd1234, &rtn_status, &rtn_val, 5, 16, obuf_40, EEX_EVENT_PEND);
+    tid = _eexEventTry(test_pri, event);
+    TEST_ASSERT_EQUAL(0, tid);            // pend unsuccessful, timeout != 0, block
+
+    _eexThreadIDSet(test_pri-1);          // free from a lower priority thread
+    event = &(eexThreadTCB(test_pri-1)->event);
+    _eexEventInit((void *) 0xabcd1234, &rtn_status, &rtn_val, 0, blk + 4, obuf_40, EEX_EVENT_POST);
+    tid = _eexEventTry(test_pri-1, event);
+    TEST_ASSERT_EQUAL(test_pri-1, tid);   // not an allocated block, nothing unblocked
+    TEST_ASSERT_EQUAL(eexStatusKOObufPtrErr, rtn_status);
+    _eexEventInit((void *) 0xabcd1234, &rtn_status, &rtn_val, 0, blk, obuf_40, EEX_EVENT_POST);
+    tid = _eexEventTry(test_pri-1, event);
+    TEST_ASSERT_EQUAL(test_pri, tid);     // free successful, request fits, higher priority thread unblocked
+    TEST_ASSERT_EQUAL(eexStatusOK, rtn_status);
+
+    // blocked thread is tried again by the scheduler
+    event = &(eexThreadTCB(test_pri)->event);
+    tid = _eexEventTry(test_pri, event);
+    TEST_ASSERT_EQUAL(test_pri, tid);
+    TEST_ASSERT_EQUAL(eexStatusOK, rtn_status);
+    TEST_ASSERT_NOT_EQUAL(0, rtn_val);
+    TEST_ASSERT_EQUAL(0, ((eex_kobj_cb_t *) obuf_40)->pend);
+
+    eexObufStats(obuf_40, &stats);
+    TEST_ASSERT_EQUAL(1, stats.n_failed);
+
+    g_all_tests_run = true;
+}
+
+void test_event_try_cond(void) {
+    eex_thread_event_t *event;
+    eex_thread_id_t     tid, test_pri = EEX_CFG_THREADS_MAX;
+    eex_status_t        rtn_status, sig_status;
+    uint32_t            mutex_addr = (uint32_t) (uintptr_t) cond_mutex;
+
+    // wait requires holding the mutex
+    _eexThreadIDSet(test_pri);
+    event = &(eexThreadTCB(test_pri)->event);
+    _eexEventInit((void *) 0xabcd1234, &rtn_status, NULL, 5, mutex_addr, cond, EEX_EVENT_PEND);
+    TEST_ASSERTION_SHOULD_ASSERT(_eexEventTry(test_pri, event));
+
+    // acquire the mutex, then wait
+    _eexEventInit((void *) 0xabcd1234, &rtn_status, NULL, 0, 0, cond_mutex, EEX_EVENT_PEND);
+    tid = _eexEventTry(test_pri, event);
+    TEST_ASSERT_EQUAL(test_pri, tid);
+    TEST_ASSERT_EQUAL(test_pri, ((eex_sema_mutex_cb_t *) cond_mutex)->owner_id);
+    _eexEventInit((void *) 0xabcd1234, &rtn_status, NULL, 5, mutex_addr, cond, EEX_EVENT_PEND);
+    tid = _eexEventTry(test_pri, event);
+    TEST_ASSERT_EQUAL(0, tid);            // not signaled, block
+    TEST_ASSERT_EQUAL(0, ((eex_sema_mutex_cb_t *) cond_mutex)->owner_id);        // mutex released
+    TEST_ASSERT_EQUAL(1, ((eex_sema_mutex_cb_t *) cond_mutex)->count.data);
+    tid = _eexEventTry(test_pri, event);
+    TEST_ASSERT_EQUAL(0, tid);            // tried again by the scheduler, still not signaled, mutex not released twice
+    TEST_ASSERT_EQUAL(1, ((eex_sema_mutex_cb_t *) cond_mutex)->count.data);
+
+    // a lower priority thread takes the mutex and signals
+    _eexThreadIDSet(test_pri-1);
+    event = &(eexThreadTCB(test_pri-1)->event);
+    _eexEventInit((void *) 0xabcd1234, &sig_status, NULL, 0, 0, cond_mutex, EEX_EVENT_PEND);
+    tid = _eexEventTry(test_pri-1, event);
+    TEST_ASSERT_EQUAL(test_pri-1, tid);
+    _eexEventInit((void *) 0xabcd1234, &sig_status, NULL, 0, EEX_COND_SIGNAL_ONE, cond, EEX_EVENT_POST);
+    tid = _eexEventTry(test_pri-1, event);
+    TEST_ASSERT_EQUAL(test_pri, tid);     // signaled a higher priority thread
+    TEST_ASSERT_EQUAL(eexStatusOK, sig_status);
+
+    // the waiter is tried by the scheduler, is moved to the mutex and blocks because the mutex is held
+    event = &(eexThreadTCB(test_pri)->event);
+    tid = _eexEventTry(test_pri, event);
+    TEST_ASSERT_EQUAL(0, tid);
+    TEST_ASSERT_EQUAL(0, ((eex_kobj_cb_t *) cond)->pend);
+    TEST_ASSERT_EQUAL(0, ((eex_cond_cb_t *) cond)->signaled);
+    TEST_ASSERT_TRUE(((eex_kobj_cb_t *) cond_mutex)->pend & (1 << (test_pri-1)));
+
+    // the signaling thread releases the mutex, waking the waiter
+    _eexThreadIDSet(test_pri-1);
+    event = &(eexThreadTCB(test_pri-1)->event);
+    _eexEventInit((void *) 0xabcd1234, &sig_status, NULL, 0, 0, cond_mutex, EEX_EVENT_POST);
+    tid = _eexEventTry(test_pri-1, event);
+    TEST_ASSERT_EQUAL(test_pri, tid);
+    event = &(eexThreadTCB(test_pri)->event);
+    tid = _eexEventTry(test_pri, event);
+    TEST_ASSERT_EQUAL(test_pri, tid);     // mutex re-acquired
+    TEST_ASSERT_EQUAL(eexStatusOK, rtn_status);
+    TEST_ASSERT_EQUAL(test_pri, ((eex_sema_mutex_cb_t *) cond_mutex)->owner_id);
+
+    // signal with no waiters is lost, a non-blocking wait returns without the mutex
+    _eexThreadIDSet(test_pri);
+    _eexEventInit((void *) 0xabcd1234, &sig_status, NULL, 0, EEX_COND_SIGNAL_ALL, cond, EEX_EVENT_POST);
+    TEST_ASSERT_EQUAL(test_pri, _eexEventTry(test_pri, event));
+    _eexEventInit((void *) 0xabcd1234, &rtn_status, NULL, 0, mutex_addr, cond, EEX_EVENT_PEND);
+    TEST_ASSERT_EQUAL(test_pri, _eexEventTry(test_pri, event));
+    TEST_ASSERT_EQUAL(eexStatusEventNotReady, rtn_status);
+    TEST_ASSERT_EQUAL(0, ((eex_sema_mutex_cb_t *) cond_mutex)->owner_id);
+
+    g_all_tests_run = true;
+}
+
+void test_rwlock_fast(void) {
+    eex_rwlock_cb_t *rwl = (eex_rwlock_cb_t *) rwlock;
+    eex_status_t     rtn_status = eexStatusInvalid;
+
+    TEST_ASSERT_TRUE(eexRWLockReadFast(rwlock, true, &rtn_status));     TEST_ASSERT_EQUAL(1, rwl->count.data);
+    TEST_ASSERT_EQUAL(eexStatusOK, rtn_status);
+    TEST_ASSERT_TRUE(eexRWLockReadFast(rwlock, true, NULL));            TEST_ASSERT_EQUAL(2, rwl->count.data);
+    TEST_ASSERT_TRUE(eexRWLockReadFast(rwlock, false, NULL));           TEST_ASSERT_EQUAL(1, rwl->count.data);
+    TEST_ASSERT_TRUE(eexRWLockReadFast(rwlock, false, NULL));           TEST_ASSERT_EQUAL(0, rwl->count.data);
+    TEST_ASSERT_FALSE(eexRWLockReadFast(rwlock, false, NULL));          // not held, use the event path (and assert)
+    TEST_ASSERT_EQUAL(0, g_thread_waiting_list);                        // no scheduler involvement
+
+    g_all_tests_run = true;
+}
+
+void test_event_try_rwlock(void) {
+    eex_rwlock_cb_t    *rwl = (eex_rwlock_cb_t *) rwlock;
+    eex_thread_event_t *event;
+    eex_thread_id_t     tid;
+    eex_thread_id_t     tid_w = EEX_CFG_THREADS_MAX, tid_r = EEX_CFG_THREADS_MAX-1, tid_a = EEX_CFG_THREADS_MAX-2;
+    eex_status_t        status_w, status_r, status_a;
+
+    // low priority reader A holds the lock
+    TEST_ASSERT_TRUE(eexRWLockReadFast(rwlock, true, &status_a));
+
+    // writer W blocks and sets the writer waiting flag
+    _eexThreadIDSet(tid_w);
+    event = &(eexThreadTCB(tid_w)->event);
+    _eexEventInit((void *) 0xabcd1234, &status_w, NULL, 5, EEX_RWLOCK_WRITE, rwlock, EEX_EVENT_PEND);
+    TEST_ASSERT_EQUAL(0, _eexEventTry(tid_w, event));
+    TEST_ASSERT_TRUE(rwl->count.data & 0x4000);
+
+    // new readers wait for the writer
+    TEST_ASSERT_FALSE(eexRWLockReadFast(rwlock, true, NULL));
+    _eexThreadIDSet(tid_r);
+    event = &(eexThreadTCB(tid_r)->event);
+    _eexEventInit((void *) 0xabcd1234, &status_r, NULL, 5, EEX_RWLOCK_READ, rwlock, EEX_EVENT_PEND);
+    TEST_ASSERT_EQUAL(0, _eexEventTry(tid_r, event));
+
+    // A releases, the last reader must wake the writer through the event path
+    TEST_ASSERT_FALSE(eexRWLockReadFast(rwlock, false, NULL));
+    _eexThreadIDSet(tid_a);
+    event = &(eexThreadTCB(tid_a)->event);
+    _eexEventInit((void *) 0xabcd1234, &status_a, NULL, 0, EEX_RWLOCK_READ, rwlock, EEX_EVENT_POST);
+    TEST_ASSERT_EQUAL(tid_w, _eexEventTry(tid_a, event));            // writer preferred over the higher priority reader
+    TEST_ASSERT_EQUAL(eexStatusOK, status_a);
+
+    // scheduler tries W then R
+    event = &(eexThreadTCB(tid_w)->event);
+    TEST_ASSERT_EQUAL(tid_w, _eexEventTry(tid_w, event));
+    TEST_ASSERT_EQUAL(eexStatusOK, status_w);
+    TEST_ASSERT_EQUAL(tid_w, rwl->writer_id);
+    TEST_ASSERT_EQUAL_HEX(0x8000, rwl->count.data);                  // held, no other writers waiting
+    event = &(eexThreadTCB(tid_r)->event);
+    TEST_ASSERT_EQUAL(0, _eexEventTry(tid_r, event));
+
+    // W releases, waking R
+    _eexThreadIDSet(tid_w);
+    event = &(eexThreadTCB(tid_w)->event);
+    _eexEventInit((void *) 0xabcd1234, &status_w, NULL, 0, EEX_RWLOCK_WRITE, rwlock, EEX_EVENT_POST);
+    TEST_ASSERT_EQUAL(tid_w, _eexEventTry(tid_w, event));            // R has a lower priority, nothing to preempt
+    TEST_ASSERT_EQUAL(0, rwl->writer_id);
+    event = &(eexThreadTCB(tid_r)->event);
+    TEST_ASSERT_EQUAL(tid_r, _eexEventTry(tid_r, event));
+    TEST_ASSERT_EQUAL(eexStatusOK, status_r);
+    TEST_ASSERT_EQUAL(1, rwl->count.data);
+    TEST_ASSERT_EQUAL(0, ((eex_kobj_cb_t *) rwlock)->pend);
+
+    // a writer that times out leaves a stale waiting flag, which the next reader clears
+    _eexThreadIDSet(tid_w);
+    event = &(eexThreadTCB(tid_w)->event);
+    _eexEventInit((void *) 0xabcd1234, &status_w, NULL, 5, EEX_RWLOCK_WRITE, rwlock, EEX_EVENT_PEND);
+    TEST_ASSERT_EQUAL(0, _eexEventTry(tid_w, event));
+    g_timer_ms += 10;
+    TEST_ASSERT_EQUAL(tid_w, _eexEventTry(tid_w, event));
+    TEST_ASSERT_EQUAL(eexStatusThreadTimeout, status_w);
+    _eexThreadIDSet(tid_a);
+    event = &(eexThreadTCB(tid_a)->event);
+    _eexEventInit((void *) 0xabcd1234, &status_a, NULL, 0, EEX_RWLOCK_READ, rwlock, EEX_EVENT_PEND);
+    tid = _eexEventTry(tid_a, event);
+    TEST_ASSERT_EQUAL(tid_a, tid);
+    TEST_ASSERT_EQUAL(eexStatusOK, status_a);
+    TEST_ASSERT_EQUAL_HEX(2, rwl->count.data);                       // flag cleared, two readers
+
+    // writers must be threads
+    g_mock_interrupt_level = 1;
+    _eexEventInit((void *) event, &status_a, NULL, 0, EEX_RWLOCK_WRITE, rwlock, EEX_EVENT_PEND);
+    TEST_ASSERTION_SHOULD_ASSERT(_eexEventTry(tid_a, event));
+
+    g_all_tests_run = true;
+}
+
+void test_event_try_barrier(void) {
+    eex_barrier_cb_t   *bar = (eex_barrier_cb_t *) barrier_3;
+    eex_thread_event_t *event;
+    eex_thread_id_t     tid, test_pri = EEX_CFG_THREADS_MAX;
+    eex_status_t        rtn_status[3];
+
+    // a non-blocking wait that is not the last arrival doesn't arrive
+    _eexThreadIDSet(test_pri);
+    event = &(eexThreadTCB(test_pri)->event);
+    _eexEventInit((void *) 0xabcd1234, &rtn_status[0], NULL, 0, 0, barrier_3, EEX_EVENT_PEND);
+    TEST_ASSERT_EQUAL(test_pri, _eexEventTry(test_pri, event));
+    TEST_ASSERT_EQUAL(eexStatusEventNotReady, rtn_status[0]);
+    TEST_ASSERT_EQUAL(0, bar->arrived);
+
+    // two threads arrive and block, retrying doesn't arrive twice
+    for (int i=0; i<2; ++i) {
+        _eexThreadIDSet(test_pri-i);
+        event = &(eexThreadTCB(test_pri-i)->event);
+        _eexEventInit((void *) 0xabcd1234, &rtn_status[i], NULL, 5, 0, barrier_3, EEX_EVENT_PEND);
+        TEST_ASSERT_EQUAL(0, _eexEventTry(test_pri-i, event));
+        TEST_ASSERT_EQUAL(0, _eexEventTry(test_pri-i, event));
+    }
+    TEST_ASSERT_EQUAL(2, _eexBMCount(bar->arrived));
+
+    // the lowest priority thread arrives last, releases both and continues
+    _eexThreadIDSet(test_pri-2);
+    event = &(eexThreadTCB(test_pri-2)->event);
+    _eexEventInit((void *) 0xabcd1234, &rtn_status[2], NULL, 5, 0, barrier_3, EEX_EVENT_PEND);
+    tid = _eexEventTry(test_pri-2, event);
+    TEST_ASSERT_EQUAL(test_pri, tid);
+    TEST_ASSERT_EQUAL(eexStatusOK, rtn_status[2]);
+    TEST_ASSERT_EQUAL(0, bar->arrived);
+    TEST_ASSERT_EQUAL(3u << (test_pri-2), bar->released);
+
+    // the released threads succeed when tried by the scheduler
+    for (int i=0; i<2; ++i) {
+        event = &(eexThreadTCB(test_pri-i)->event);
+        TEST_ASSERT_EQUAL(test_pri-i, _eexEventTry(test_pri-i, event));
+        TEST_ASSERT_EQUAL(eexStatusOK, rtn_status[i]);
+    }
+    TEST_ASSERT_EQUAL(0, bar->released);
+    TEST_ASSERT_EQUAL(0, ((eex_kobj_cb_t *) barrier_3)->pend);
+
+    // a timed out thread withdraws its arrival
+    _eexThreadIDSet(test_pri);
+    event = &(eexThreadTCB(test_pri)->event);
+    _eexEventInit((void *) 0xabcd1234, &rtn_status[0], NULL, 5, 0, barrier_3, EEX_EVENT_PEND);
+    TEST_ASSERT_EQUAL(0, _eexEventTry(test_pri, event));
+    g_timer_ms = 5;
+    TEST_ASSERT_EQUAL(test_pri, _eexEventTry(test_pri, event));
+    TEST_ASSERT_EQUAL(eexStatusThreadTimeout, rtn_status[0]);
+    TEST_ASSERT_EQUAL(0, bar->arrived);
+
+    // posting to a barrier is an error
+    _eexEventInit((void *) 0xabcd1234, &rtn_status[0], NULL, 0, 0, barrier_3, EEX_EVENT_POST);
+    TEST_ASSERTION_SHOULD_ASSERT(_eexEventTry(test_pri, event));
+
+    g_all_tests_run = true;
+}
+
+void test_event_try_latch(void) {
+    eex_thread_event_t *event, int_event;
+    eex_thread_id_t     test_pri = EEX_CFG_THREADS_MAX;
+    eex_status_t        rtn_status[2], int_status;
+
+    // two threads wait for the latch
+    for (int i=0; i<2; ++i) {
+        _eexThreadIDSet(test_pri-i);
+        event = &(eexThreadTCB(test_pri-i)->event);
+        _eexEventInit((void *) 0xabcd1234, &rtn_status[i], NULL, eexWaitForever, 0, latch_2, EEX_EVENT_PEND);
+        TEST_ASSERT_EQUAL(0, _eexEventTry(test_pri-i, event));
+    }
+
+    // an interrupt counts down, the latch is still closed
+    _eexThreadIDSet(1);
+    g_mock_interrupt_level = 1;
+    _eexEventInit(&int_event, &int_status, NULL, 0, 1, latch_2, EEX_EVENT_POST);
+    TEST_ASSERT_EQUAL(1, _eexEventTry(1, &int_event));
+    TEST_ASSERT_EQUAL(eexStatusOK, int_status);
+    TEST_ASSERT_EQUAL(1, ((eex_latch_cb_t *) latch_2)->count.data);
+
+    // counting down past zero opens the latch and releases both waiters
+    _eexEventInit(&int_event, &int_status, NULL, 0, 5, latch_2, EEX_EVENT_POST);
+    TEST_ASSERT_EQUAL(test_pri, _eexEventTry(1, &int_event));
+    TEST_ASSERT_EQUAL(0, ((eex_latch_cb_t *) latch_2)->count.data);
+    g_mock_interrupt_level = 0;
+    for (int i=0; i<2; ++i) {
+        event = &(eexThreadTCB(test_pri-i)->event);
+        TEST_ASSERT_EQUAL(test_pri-i, _eexEventTry(test_pri-i, event));
+        TEST_ASSERT_EQUAL(eexStatusOK, rtn_status[i]);
+    }
+
+    // the latch stays open until it is reset
+    _eexThreadIDSet(test_pri);
+    event = &(eexThreadTCB(test_pri)->event);
+    _eexEventInit((void *) 0xabcd1234, &rtn_status[0], NULL, 0, 0, latch_2, EEX_EVENT_PEND);
+    TEST_ASSERT_EQUAL(test_pri, _eexEventTry(test_pri, event));
+    TEST_ASSERT_EQUAL(eexStatusOK, rtn_status[0]);
+    eexLatchReset(latch_2, 2);
+    _eexEventInit((void *) 0xabcd1234, &rtn_status[0], NULL, 0, 0, latch_2, EEX_EVENT_PEND);
+    TEST_ASSERT_EQUAL(test_pri, _eexEventTry(test_pri, event));
+    TEST_ASSERT_EQUAL(eexStatusEventNotReady, rtn_status[0]);
+
+    g_all_tests_run = true;
+}
+
+void test_event_try_notify(void) {
+    eex_thread_event_t *event, int_event;
+    eex_thread_id_t     test_pri = EEX_CFG_THREADS_MAX;
+    eex_notify_cb_t    *notify;
+    eex_status_t        rtn_status, int_status;
+    uint32_t            rtn_val;
+
+    (void) eexThreadCreate(thread, NULL, test_pri, NULL);
+    notify = &(eexThreadTCB(test_pri)->notify);
+    TEST_ASSERT_EQUAL('NTFY', notify->cb.type);
+
+    // nothing pending, non-blocking wait fails, blocking wait blocks, no kernel object lists are used
+    _eexThreadIDSet(test_pri);
+    event = &(eexThreadTCB(test_pri)->event);
+    _eexEventInit((void *) 0xabcd1234, &rtn_status, &rtn_val, 0, 0, notify, EEX_EVENT_PEND);
+    TEST_ASSERT_EQUAL(test_pri, _eexEventTry(test_pri, event));
+    TEST_ASSERT_EQUAL(eexStatusEventNotReady, rtn_status);
+    _eexEventInit((void *) 0xabcd1234, &rtn_status, &rtn_val, eexWaitForever, 0x0f, notify, EEX_EVENT_PEND);
+    TEST_ASSERT_EQUAL(0, _eexEventTry(test_pri, event));
+    TEST_ASSERT_EQUAL(0, notify->cb.pend);
+
+    // interrupt sets bits and wakes the higher priority owner
+    _eexThreadIDSet(1);
+    g_mock_interrupt_level = 1;
+    _eexEventInit(&int_event, &int_status, (uint32_t *) EEX_NOTIFY_SET_BITS, 0, 0x11, notify, EEX_EVENT_POST);
+    TEST_ASSERT_EQUAL(test_pri, _eexEventTry(1, &int_event));
+    TEST_ASSERT_EQUAL(eexStatusOK, int_status);
+    _eexEventInit(&int_event, &int_status, (uint32_t *) EEX_NOTIFY_SET_BITS, 0, 0x22, notify, EEX_EVENT_POST);
+    TEST_ASSERT_EQUAL(test_pri, _eexEventTry(1, &int_event));
+    TEST_ASSERT_EQUAL(0, notify->cb.post);
+    g_mock_interrupt_level = 0;
+
+    // owner is tried, gets the value and clears the masked bits
+    _eexThreadIDSet(test_pri);
+    TEST_ASSERT_EQUAL(test_pri, _eexEventTry(test_pri, event));
+    TEST_ASSERT_EQUAL(eexStatusOK, rtn_status);
+    TEST_ASSERT_EQUAL(0x33, rtn_val);
+    TEST_ASSERT_EQUAL(0x30, notify->value);
+    TEST_ASSERT_EQUAL(0, notify->pending);
+
+    // increment and overwrite from a lower priority thread, owner not waiting
+    _eexThreadIDSet(1);
+    event = &(eexThreadTCB(1)->event);
+    _eexEventInit((void *) 0xabcd1234, &int_status, (uint32_t *) EEX_NOTIFY_INCREMENT, 0, 0, notify, EEX_EVENT_POST);
+    TEST_ASSERT_EQUAL(1, _eexEventTry(1, event));
+    TEST_ASSERT_EQUAL(0x31, notify->value);
+    _eexEventInit((void *) 0xabcd1234, &int_status, (uint32_t *) EEX_NOTIFY_OVERWRITE, 0, 7, notify, EEX_EVENT_POST);
+    TEST_ASSERT_EQUAL(1, _eexEventTry(1, event));
+    TEST_ASSERT_EQUAL(7, notify->value);
+    _eexEventInit((void *) 0xabcd1234, &int_status, (uint32_t *) 9, 0, 7, notify, EEX_EVENT_POST);
+    TEST_ASSERTION_SHOULD_ASSERT(_eexEventTry(1, event));                       // unknown action
+
+    // a thread can only wait on its own notification
+    _eexEventInit((void *) 0xabcd1234, &rtn_status, &rtn_val, 0, 0, notify, EEX_EVENT_PEND);
+    TEST_ASSERTION_SHOULD_ASSERT(_eexEventTry(1, event));
+
+    g_all_tests_run = true;
+}
+
+void test_event_try_join(void) {
+    eex_thread_event_t *event;
+    eex_thread_id_t     test_pri = EEX_CFG_THREADS_MAX;
+    eex_join_cb_t      *join;
+    eex_status_t        rtn_status;
+    uint32_t            rtn_val;
+
+    (void) eexThreadCreate(thread, NULL, test_pri-1, NULL);
+    join = &(eexThreadTCB(test_pri-1)->join);
+    TEST_ASSERT_EQUAL('JOIN', join->cb.type);
+
+    // worker is running, non-blocking join fails, blocking join blocks
+    _eexThreadIDSet(test_pri);
+    event = &(eexThreadTCB(test_pri)->event);
+    _eexEventInit((void *) 0xabcd1234, &rtn_status, &rtn_val, 0, 0, join, EEX_EVENT_PEND);
+    TEST_ASSERT_EQUAL(test_pri, _eexEventTry(test_pri, event));
+    TEST_ASSERT_EQUAL(eexStatusEventNotReady, rtn_status);
+    _eexEventInit((void *) 0xabcd1234, &rtn_status, &rtn_val, eexWaitForever, 0, join, EEX_EVENT_PEND);
+    TEST_ASSERT_EQUAL(0, _eexEventTry(test_pri, event));
+
+    // only the worker can exit itself
+    _eexThreadIDSet(1);
+    _eexEventInit((void *) 0xabcd1234, NULL, (uint32_t *) true, 0, 42, join, EEX_EVENT_POST);
+    TEST_ASSERTION_SHOULD_ASSERT(_eexEventTry(1, &(eexThreadTCB(1)->event)));
+    _eexEventRemove(1, &(eexThreadTCB(1)->event), eexStatusOK);
+
+    // worker exits and releases the higher priority joiner
+    _eexThreadIDSet(test_pri-1);
+    _eexEventInit((void *) 0xabcd1234, NULL, (uint32_t *) true, 0, 42, join, EEX_EVENT_POST);
+    TEST_ASSERT_EQUAL(test_pri, _eexEventTry(test_pri-1, &(eexThreadTCB(test_pri-1)->event)));
+    TEST_ASSERT_EQUAL(1, join->done);
+    TEST_ASSERT_EQUAL(1, join->free_slot);
+    TEST_ASSERT_EQUAL(test_pri, _eexEventTry(test_pri, event));
+    TEST_ASSERT_EQUAL(eexStatusOK, rtn_status);
+    TEST_ASSERT_EQUAL(42, rtn_val);
+    TEST_ASSERT_EQUAL(0, join->cb.pend);
+
+    // the completion stays set, a later join succeeds without blocking
+    _eexThreadIDSet(test_pri);
+    _eexEventInit((void *) 0xabcd1234, &rtn_status, &rtn_val, 0, 0, join, EEX_EVENT_PEND);
+    TEST_ASSERT_EQUAL(test_pri, _eexEventTry(test_pri, event));
+    TEST_ASSERT_EQUAL(eexStatusOK, rtn_status);
+
+    // the exited thread leaves all lists when it leaves the cpu, and its slot is free
+    _eexThreadIDSet(test_pri-1);
+    g_thread_ready_list = 1 << (test_pri-1);
+    (void) eexScheduler(false);
+    TEST_ASSERT_EQUAL(0, g_thread_ready_list | g_thread_waiting_list | g_thread_interrupted_list);
+    TEST_ASSERT_EQUAL(eexStatusOK, eexThreadCreate(thread, NULL, test_pri-1, NULL));
+    TEST_ASSERT_EQUAL(0, join->done);
+
+    g_all_tests_run = true;
+}
+
+void test_event_try_period(void) {
+    eex_thread_event_t *event;
+    eex_thread_id_t     test_pri = EEX_CFG_THREADS_MAX;
+    eex_status_t        rtn_status;
+    uint32_t            rtn_missed;
+
+    // first release is on the phase grid after the current time
+    g_timer_ms = 3;
+    eexThreadPeriodSet(test_pri, 10, 5);
+    TEST_ASSERT_EQUAL(5, eexThreadTCB(test_pri)->period.next);
+    eexThreadPeriodSet(test_pri-1, 10, 2);
+    TEST_ASSERT_EQUAL(12, eexThreadTCB(test_pri-1)->period.next);
+
+    // wait blocks until the release, the deadline is absolute
+    _eexThreadIDSet(test_pri);
+    event = &(eexThreadTCB(test_pri)->event);
+    _eexEventInit((void *) 0xabcd1234, &rtn_status, &rtn_missed, eexWaitForever, 0, &period_kobj, EEX_EVENT_PEND);
+    TEST_ASSERT_EQUAL(5, event->timeout);
+    TEST_ASSERT_EQUAL(0, rtn_missed);
+    TEST_ASSERT_EQUAL(0, _eexEventTry(test_pri, event));
+    g_timer_ms = 6;                                                             // released late, the next release doesn't move
+    TEST_ASSERT_EQUAL(test_pri, _eexEventTry(test_pri, event));
+    TEST_ASSERT_EQUAL(eexStatusOK, rtn_status);
+    TEST_ASSERT_EQUAL(15, eexThreadTCB(test_pri)->period.next);
+
+    // overrun by less than a period, released at once
+    g_timer_ms = 20;
+    _eexEventInit((void *) 0xabcd1234, &rtn_status, &rtn_missed, eexWaitForever, 0, &period_kobj, EEX_EVENT_PEND);
+    TEST_ASSERT_EQUAL(test_pri, _eexEventTry(test_pri, event));
+    TEST_ASSERT_EQUAL(0, rtn_missed);
+
+    // overrun by more than a period, the whole periods are missed
+    g_timer_ms = 47;
+    _eexEventInit((void *) 0xabcd1234, &rtn_status, &rtn_missed, eexWaitForever, 0, &period_kobj, EEX_EVENT_PEND);
+    TEST_ASSERT_EQUAL(2, rtn_missed);
+    TEST_ASSERT_EQUAL(45, event->timeout);
+    TEST_ASSERT_EQUAL(test_pri, _eexEventTry(test_pri, event));
+    TEST_ASSERT_EQUAL(2, eexThreadPeriodMissed(test_pri));
+    _eexEventInit((void *) 0xabcd1234, &rtn_status, &rtn_missed, eexWaitForever, 0, &period_kobj, EEX_EVENT_PEND);
+    TEST_ASSERT_EQUAL(55, event->timeout);
+    TEST_ASSERT_EQUAL(0, _eexEventTry(test_pri, event));
+
+    TEST_ASSERTION_SHOULD_ASSERT(eexThreadPeriodSet(test_pri, 10, 10));
+
+    g_all_tests_run = true;
+}
+
+void test_event_try_abort(void) {
+    eex_thread_event_t *event, int_event;
+    eex_thread_id_t     test_pri = EEX_CFG_THREADS_MAX;
+    eex_status_t        rtn_status, int_status;
+
+    // thread blocks in a barrier, abort ends the wait and withdraws the arrival
+    _eexThreadIDSet(test_pri);
+    event = &(eexThreadTCB(test_pri)->event);
+    _eexEventInit((void *) 0xabcd1234, &rtn_status, NULL, eexWaitForever, 0, barrier_3, EEX_EVENT_PEND);
+    TEST_ASSERT_EQUAL(0, _eexEventTry(test_pri, event));
+    TEST_ASSERT_TRUE(_eexThreadListContains(&(((eex_barrier_cb_t *) barrier_3)->arrived), test_pri));
+    _eexThreadIDSet(1);
+    eexThreadAbortWait(test_pri);
+    TEST_ASSERT_FALSE(g_f_pend_scheduler);                                  // from a thread the scheduler isn't pended
+    g_mock_interrupt_level = 1;
+    eexThreadAbortWait(test_pri);
+    g_mock_interrupt_level = 0;
+    TEST_ASSERT_TRUE(g_f_pend_scheduler);
+    g_f_pend_scheduler = false;
+    TEST_ASSERT_EQUAL(test_pri, _eexEventTry(test_pri, event));
+    TEST_ASSERT_EQUAL(eexStatusThreadAborted, rtn_status);
+    TEST_ASSERT_EQUAL(EEX_EVENT_NO_ACTION, event->action);
+    TEST_ASSERT_EQUAL(0, ((eex_barrier_cb_t *) barrier_3)->arrived);
+    TEST_ASSERT_EQUAL(0, ((eex_kobj_cb_t *) barrier_3)->pend);
+    TEST_ASSERT_EQUAL(0, g_thread_abort_list);
+
+    // an abort of a thread that isn't waiting is discarded by its next wait
+    eexThreadAbortWait(test_pri);
+    _eexThreadIDSet(test_pri);
+    _eexEventInit((void *) 0xabcd1234, &rtn_status, NULL, eexWaitForever, 0, &delay_kobj, EEX_EVENT_PEND);
+    TEST_ASSERT_EQUAL(0, _eexEventTry(test_pri, event));
+
+    // an interrupt event never consumes the abort of the thread it interrupted
+    eexThreadAbortWait(test_pri);
+    g_mock_interrupt_level = 1;
+    _eexEventInit(&int_event, &int_status, NULL, 0, 0, sema_10_10, EEX_EVENT_PEND);
+    TEST_ASSERT_EQUAL(test_pri, _eexEventTry(test_pri, &int_event));
+    TEST_ASSERT_EQUAL(eexStatusOK, int_status);
+    g_mock_interrupt_level = 0;
+    TEST_ASSERT_EQUAL(test_pri, _eexEventTry(test_pri, event));
+    TEST_ASSERT_EQUAL(eexStatusThreadAborted, rtn_status);
+
+    TEST_ASSERTION_SHOULD_ASSERT(eexThreadAbortWait(0));
+
+    g_all_tests_run = true;
+}
+
 void test_scheduler(void) {
     eex_thread_id_t     test_pri = EEX_CFG_THREADS_MAX-2;
     eex_thread_cb_t    *tcb;
@@ -677,6 +1616,443 @@ void test_scheduler(void) {
     g_all_tests_run = true;
 }
 
+void test_scheduler_wake_chain(void) {
+    eex_thread_id_t     test_pri = EEX_CFG_THREADS_MAX;
+    eex_thread_cb_t    *tcb;
+    eex_status_t        rtn_status_h, rtn_status_l;
+
+    // high priority thread blocks on an empty semaphore
+    _eexThreadIDSet(test_pri);
+    _eexEventInit((void *) 0xabcd1234, &rtn_status_h, NULL, eexWaitForever, 0, sema_1_0, EEX_EVENT_PEND);
+    TEST_ASSERT_EQUAL(0, _eexEventTry(test_pri, &(eexThreadTCB(test_pri)->event)));
+
+    // a waiting low priority thread posts the semaphore in the scheduler, the high
+    // priority thread is dispatched directly and the low priority thread is left ready
+    _eexThreadIDSet(test_pri-2);
+    _eexEventInit((void *) 0xabcd1234, &rtn_status_l, NULL, eexWaitForever, 0, sema_1_0, EEX_EVENT_POST);
+    _eexThreadIDSet(test_pri-3);
+    g_thread_waiting_list = (1 << (test_pri-1)) | (1 << (test_pri-3));
+    g_f_pend_scheduler = false;
+    tcb = eexScheduler(false);
+    TEST_ASSERT_EQUAL(eexThreadTCB(test_pri), tcb);
+    TEST_ASSERT_FALSE(g_f_pend_scheduler);
+    TEST_ASSERT_EQUAL(eexStatusOK, rtn_status_h);
+    TEST_ASSERT_EQUAL(eexStatusOK, rtn_status_l);
+    TEST_ASSERT_EQUAL(0, g_thread_waiting_list);
+    TEST_ASSERT_EQUAL((1 << (test_pri-3)) | (1 << (test_pri-4)), g_thread_ready_list);
+
+    g_all_tests_run = true;
+}
+
+void test_scheduler_sleep(void) {
+    eex_thread_id_t     test_pri = EEX_CFG_THREADS_MAX;
+    eex_thread_cb_t    *tcb;
+    eex_status_t        rtn_status;
+
+    // delayed threads are kept in the sleep list, the lower priority thread runs
+    _eexThreadIDSet(test_pri);
+    _eexEventInit((void *) 0xabcd1234, &rtn_status, NULL, 10, 0, &delay_kobj, EEX_EVENT_PEND);
+    g_thread_ready_list = 1 << (test_pri-3);
+    tcb = eexScheduler(false);
+    TEST_ASSERT_EQUAL(eexThreadTCB(test_pri-2), tcb);
+    _eexThreadIDSet(test_pri-1);
+    _eexEventInit((void *) 0xabcd1234, &rtn_status, NULL, 5, 0, &delay_kobj, EEX_EVENT_PEND);
+    g_thread_ready_list = 1 << (test_pri-3);
+    tcb = eexScheduler(false);
+    TEST_ASSERT_EQUAL(eexThreadTCB(test_pri-2), tcb);
+    TEST_ASSERT_EQUAL((1u << (test_pri-1)) | (1u << (test_pri-2)), g_thread_sleep_list);
+    TEST_ASSERT_EQUAL(5, g_sleep_next);
+    TEST_ASSERT_EQUAL(g_thread_sleep_list, g_thread_waiting_list);      // still waiting, the idle hook sees the timeouts
+
+    // the earliest timeout passes, only that thread leaves the sleep list and is dispatched
+    g_timer_ms = 5;
+    tcb = eexScheduler(false);
+    TEST_ASSERT_EQUAL(eexThreadTCB(test_pri-1), tcb);
+    TEST_ASSERT_EQUAL(1u << (test_pri-1), g_thread_sleep_list);
+    TEST_ASSERT_EQUAL(10, g_sleep_next);
+
+    // an aborted sleep is tried at once
+    eexThreadAbortWait(test_pri);
+    tcb = eexScheduler(false);
+    TEST_ASSERT_EQUAL(eexThreadTCB(test_pri), tcb);
+    TEST_ASSERT_EQUAL(eexStatusThreadAborted, rtn_status);
+    TEST_ASSERT_EQUAL(0, g_thread_sleep_list);
+
+    g_all_tests_run = true;
+}
+
+void test_scheduler_threshold(void) {
+    eex_thread_id_t     test_pri = EEX_CFG_THREADS_MAX-2;
+    eex_thread_cb_t    *tcb;
+    eex_status_t        rtn_status;
+
+    // a thread above the priority but not above the threshold of the interrupted thread doesn't preempt it
+    eexThreadThresholdSet(test_pri, test_pri+1);
+    _eexThreadIDSet(test_pri);
+    g_thread_ready_list = 1 << (test_pri+1-1);
+    tcb = eexScheduler(true);
+    TEST_ASSERT_NULL(tcb);
+    TEST_ASSERT_EQUAL(test_pri, eexThreadID());
+
+    // a thread above the threshold does
+    g_thread_ready_list |= 1 << (test_pri+2-1);
+    tcb = eexScheduler(true);
+    TEST_ASSERT_EQUAL(eexThreadTCB(test_pri+2), tcb);
+    TEST_ASSERT_EQUAL(1 << (test_pri-1), g_thread_interrupted_list);
+
+    // once the thread blocks the threshold no longer applies
+    g_thread_interrupted_list = EEX_EMPTY_THREAD_LIST;
+    _eexThreadIDSet(test_pri);
+    tcb = eexScheduler(false);
+    TEST_ASSERT_EQUAL(eexThreadTCB(test_pri+1), tcb);
+
+    // releasing a thread at or below the threshold doesn't block the posting thread
+    _eexThreadIDSet(test_pri+1);
+    _eexEventInit((void *) 0xabcd1234, &rtn_status, NULL, eexWaitForever, 0, sema_threshold, EEX_EVENT_PEND);
+    TEST_ASSERT_EQUAL(0, _eexEventTry(test_pri+1, &(eexThreadTCB(test_pri+1)->event)));
+    _eexThreadIDSet(test_pri);
+    TEST_ASSERT_FALSE(eexPendPost((void *) 0xabcd1234, &rtn_status, NULL, 0, 0, sema_threshold, EEX_EVENT_POST));
+    TEST_ASSERT_EQUAL(test_pri+1, _eexEventTry(test_pri+1, &(eexThreadTCB(test_pri+1)->event)));
+
+    // without the threshold it does
+    eexThreadThresholdSet(test_pri, test_pri);
+    _eexThreadIDSet(test_pri+1);
+    _eexEventInit((void *) 0xabcd1234, &rtn_status, NULL, eexWaitForever, 0, sema_threshold, EEX_EVENT_PEND);
+    TEST_ASSERT_EQUAL(0, _eexEventTry(test_pri+1, &(eexThreadTCB(test_pri+1)->event)));
+    _eexThreadIDSet(test_pri);
+    TEST_ASSERT_TRUE(eexPendPost((void *) 0xabcd1234, &rtn_status, NULL, 0, 0, sema_threshold, EEX_EVENT_POST));
+    TEST_ASSERT_EQUAL(1 << (test_pri-1), g_thread_preempted_list);
+
+    // a thread blocked by its own post above the threshold keeps the threshold until it runs again
+    TEST_ASSERT_EQUAL(test_pri+1, _eexEventTry(test_pri+1, &(eexThreadTCB(test_pri+1)->event)));
+    eexThreadThresholdSet(test_pri-1, test_pri);
+    g_thread_ready_list     = EEX_EMPTY_THREAD_LIST;
+    g_thread_preempted_list = EEX_EMPTY_THREAD_LIST;
+    g_thread_waiting_list   = (1 << (test_pri-1)) | (1 << (test_pri+1-1));
+    _eexThreadIDSet(test_pri);
+    _eexEventInit((void *) 0xabcd1234, &rtn_status, NULL, eexWaitForever, 0, sema_threshold, EEX_EVENT_PEND);
+    TEST_ASSERT_EQUAL(0, _eexEventTry(test_pri, &(eexThreadTCB(test_pri)->event)));
+    _eexThreadIDSet(test_pri-1);
+    TEST_ASSERT_FALSE(eexPendPost((void *) 0xabcd1234, &rtn_status, NULL, 0, 0, sema_threshold, EEX_EVENT_POST));
+    _eexThreadIDSet(test_pri+1);
+    _eexEventInit((void *) 0xabcd1234, &rtn_status, NULL, eexWaitForever, 0, sema_threshold_hi, EEX_EVENT_PEND);
+    TEST_ASSERT_EQUAL(0, _eexEventTry(test_pri+1, &(eexThreadTCB(test_pri+1)->event)));
+    _eexThreadIDSet(test_pri-1);
+    TEST_ASSERT_TRUE(eexPendPost((void *) 0xabcd1234, &rtn_status, NULL, 0, 0, sema_threshold_hi, EEX_EVENT_POST));
+    TEST_ASSERT_EQUAL(1 << (test_pri-1-1), g_thread_preempted_list);
+    tcb = eexScheduler(false);
+    TEST_ASSERT_EQUAL(eexThreadTCB(test_pri+1), tcb);
+    TEST_ASSERT_TRUE(eexPendPost((void *) 0xabcd1234, &rtn_status, NULL, eexWaitForever, 0, sema_threshold_hi, EEX_EVENT_PEND));
+    tcb = eexScheduler(false);
+    TEST_ASSERT_EQUAL(eexThreadTCB(test_pri-1), tcb);     // not test_pri, which is within its threshold
+    TEST_ASSERT_EQUAL(0, g_thread_preempted_list);
+
+    // once it blocks for real the released thread runs
+    TEST_ASSERT_TRUE(eexPendPost((void *) 0xabcd1234, &rtn_status, NULL, eexWaitForever, 0, sema_threshold_hi, EEX_EVENT_PEND));
+    tcb = eexScheduler(false);
+    TEST_ASSERT_EQUAL(eexThreadTCB(test_pri), tcb);
+    TEST_ASSERT_EQUAL(0, g_thread_preempted_list);
+
+    TEST_ASSERTION_SHOULD_ASSERT(eexThreadThresholdSet(test_pri, test_pri-1));
+
+    g_all_tests_run = true;
+}
+
+void test_scheduler_partition(void) {
+    static const eex_partition_window_t windows[] = { { 1, 10 }, { 2, 5 }, { 0, 5 } };
+    eex_thread_id_t         test_pri = EEX_CFG_THREADS_MAX;
+    eex_thread_cb_t        *tcb;
+    eex_partition_stats_t   stats;
+
+    eexThreadPartitionSet(test_pri, 1);
+    eexThreadPartitionSet(test_pri-1, 2);
+    eexThreadPartitionSet(test_pri-2, 2);
+    eexThreadPartitionSet(test_pri-2, 0);     // moved back to the unpartitioned threads
+    _eexThreadIDSet(test_pri-3);
+    g_f_pend_scheduler = false;
+    eexPartitionSchedule(windows, 3);
+    TEST_ASSERT_FALSE(g_f_pend_scheduler);    // from a thread it takes effect at the next blocking call
+    eexPartitionStats(1, &stats);
+    TEST_ASSERT_EQUAL(10, stats.budget_ms);
+    TEST_ASSERT_EQUAL(1, stats.n_windows);
+
+    // partition 1 window, the partition 2 thread is masked out
+    _eexThreadIDSet(test_pri-3);
+    g_thread_ready_list = (1u << (test_pri-2)) | (1u << (test_pri-3));
+    tcb = eexScheduler(false);
+    TEST_ASSERT_EQUAL(eexThreadTCB(test_pri-2), tcb);
+    g_thread_ready_list |= 1u << (test_pri-1);
+    tcb = eexScheduler(false);
+    TEST_ASSERT_EQUAL(eexThreadTCB(test_pri), tcb);
+    TEST_ASSERT_FALSE(eexPartitionSwitchDue());
+
+    // partition 2 window, the partition 1 thread is masked out
+    g_timer_ms = 10;
+    TEST_ASSERT_TRUE(eexPartitionSwitchDue());
+    tcb = eexScheduler(false);
+    TEST_ASSERT_EQUAL(eexThreadTCB(test_pri-1), tcb);
+    TEST_ASSERT_TRUE(_eexThreadListContains(&g_thread_ready_list, test_pri));
+
+    // switched late, the overrun is charged to partition 2. Only unpartitioned threads run in the partition 0 window.
+    g_timer_ms = 17;
+    tcb = eexScheduler(false);
+    TEST_ASSERT_EQUAL(eexThreadTCB(test_pri-2), tcb);
+    eexPartitionStats(2, &stats);
+    TEST_ASSERT_EQUAL(1, stats.n_overrun);
+    TEST_ASSERT_EQUAL(2, stats.overrun_ms);
+
+    // windows that have passed are skipped
+    g_timer_ms = 46;
+    tcb = eexScheduler(false);
+    TEST_ASSERT_EQUAL(eexThreadTCB(test_pri), tcb);
+    eexPartitionStats(1, &stats);
+    TEST_ASSERT_EQUAL(2, stats.n_windows);
+    TEST_ASSERT_EQUAL(1, stats.n_skipped);
+    eexPartitionStats(0, &stats);
+    TEST_ASSERT_EQUAL(26, stats.overrun_ms);
+
+    // a thread of the outgoing partition that was interrupted is on the stack and is returned to,
+    // the incoming partition's thread runs when it blocks
+    g_thread_ready_list = 1u << (test_pri-2);
+    g_timer_ms = 50;
+    tcb = eexScheduler(true);
+    TEST_ASSERT_NULL(tcb);
+    TEST_ASSERT_EQUAL(test_pri, eexThreadID());
+    tcb = eexScheduler(false);
+    TEST_ASSERT_EQUAL(eexThreadTCB(test_pri-1), tcb);
+
+    // stopping partitioning unmasks every thread
+    eexPartitionSchedule(NULL, 0);
+    g_thread_ready_list |= 1u << (test_pri-1);
+    _eexThreadIDSet(test_pri-3);
+    tcb = eexScheduler(false);
+    TEST_ASSERT_EQUAL(eexThreadTCB(test_pri), tcb);
+    TEST_ASSERTION_SHOULD_ASSERT(eexThreadPartitionSet(test_pri, EEX_CFG_PARTITIONS+1));
+
+    g_all_tests_run = true;
+}
+
+void test_scheduler_table(void) {
+    eex_thread_id_t     test_pri = EEX_CFG_THREADS_MAX;
+    static const eex_table_release_t table[] = { { 0, EEX_CFG_THREADS_MAX }, { 5, EEX_CFG_THREADS_MAX-1 }, { 5, EEX_CFG_THREADS_MAX } };
+    eex_thread_cb_t    *tcb;
+    eex_table_stats_t   stats;
+    eex_status_t        rtn_status;
+    uint32_t            rtn_jitter;
+
+    eexTableSchedule(table, 3, 10);
+
+    // a table thread waits until it is released, event-triggered threads run in the slack
+    _eexThreadIDSet(test_pri-1);
+    _eexEventInit((void *) 0xabcd1234, &rtn_status, &rtn_jitter, eexWaitForever, 0, &table_kobj, EEX_EVENT_PEND);
+    g_thread_ready_list = 1 << (test_pri-3);
+    tcb = eexScheduler(false);
+    TEST_ASSERT_EQUAL(eexThreadTCB(test_pri-2), tcb);
+    TEST_ASSERT_TRUE(_eexThreadListContains(&g_thread_table_wait_list, test_pri-1));
+    TEST_ASSERT_TRUE(_eexThreadListContains(&g_table_released_list, test_pri));     // released at 0
+
+    // a released thread takes its release when it waits, the jitter is returned
+    _eexThreadIDSet(test_pri);
+    _eexEventInit((void *) 0xabcd1234, &rtn_status, &rtn_jitter, eexWaitForever, 0, &table_kobj, EEX_EVENT_PEND);
+    g_timer_us = 300;
+    TEST_ASSERT_EQUAL(test_pri, _eexEventTry(test_pri, &(eexThreadTCB(test_pri)->event)));
+    TEST_ASSERT_EQUAL(eexStatusOK, rtn_status);
+    TEST_ASSERT_EQUAL(300, rtn_jitter);
+
+    // both threads are released at 5 and are dispatched by priority
+    _eexEventInit((void *) 0xabcd1234, &rtn_status, &rtn_jitter, eexWaitForever, 0, &table_kobj, EEX_EVENT_PEND);
+    g_thread_ready_list = 1 << (test_pri-3);
+    tcb = eexScheduler(false);
+    TEST_ASSERT_EQUAL(eexThreadTCB(test_pri-2), tcb);
+    TEST_ASSERT_FALSE(eexTableReleaseDue());
+    g_timer_ms = 5;
+    g_timer_us = 100;
+    TEST_ASSERT_TRUE(eexTableReleaseDue());
+    tcb = eexScheduler(false);
+    TEST_ASSERT_EQUAL(eexThreadTCB(test_pri), tcb);
+    TEST_ASSERT_EQUAL(100, rtn_jitter);
+    _eexEventInit((void *) 0xabcd1234, &rtn_status, &rtn_jitter, eexWaitForever, 0, &table_kobj, EEX_EVENT_PEND);
+    tcb = eexScheduler(false);
+    TEST_ASSERT_EQUAL(eexThreadTCB(test_pri-1), tcb);
+    eexTableStats(test_pri, &stats);
+    TEST_ASSERT_EQUAL(2, stats.n_releases);
+    TEST_ASSERT_EQUAL(100, stats.jitter_last_us);
+    TEST_ASSERT_EQUAL(300, stats.jitter_max_us);
+
+    // a release the thread hasn't taken by its next release is missed
+    g_timer_ms = 15;
+    g_timer_us = 0;
+    _eexThreadIDSet(test_pri-3);
+    tcb = eexScheduler(false);
+    TEST_ASSERT_EQUAL(eexThreadTCB(test_pri), tcb);
+    TEST_ASSERT_EQUAL(5000, rtn_jitter);
+    eexTableStats(test_pri, &stats);
+    TEST_ASSERT_EQUAL(3, stats.n_releases);
+    TEST_ASSERT_EQUAL(1, stats.n_missed);
+
+    g_all_tests_run = true;
+}
+
+void test_scheduler_suspend(void) {
+    eex_thread_id_t     test_pri = EEX_CFG_THREADS_MAX-2;
+    eex_thread_cb_t    *tcb;
+
+    // suspended ready thread is skipped
+    _eexThreadIDSet(test_pri);
+    g_thread_ready_list = (1 << (EEX_CFG_THREADS_MAX-1)) | (1 << (EEX_CFG_THREADS_MAX-2));
+    eexThreadSuspend(EEX_CFG_THREADS_MAX);
+    tcb = eexScheduler(false);
+    TEST_ASSERT_EQUAL(eexThreadTCB(EEX_CFG_THREADS_MAX-1), tcb);
+
+    // suspended interrupted thread is still returned to, the suspended ready thread is still skipped
+    _eexThreadIDSet(test_pri);
+    g_thread_ready_list = 1 << (EEX_CFG_THREADS_MAX-1);
+    eexThreadSuspend(test_pri);
+    tcb = eexScheduler(true);
+    TEST_ASSERT_EQUAL(NULL, tcb);
+    TEST_ASSERT_EQUAL(test_pri, eexThreadID());
+
+    // resuming a higher priority thread from an interrupt pends the scheduler, from a thread it
+    // runs at the next blocking call
+    g_f_pend_scheduler = false;
+    eexThreadResume(EEX_CFG_THREADS_MAX);
+    TEST_ASSERT_FALSE(g_f_pend_scheduler);
+    eexThreadSuspend(EEX_CFG_THREADS_MAX);
+    g_mock_interrupt_level = 1;
+    eexThreadResume(EEX_CFG_THREADS_MAX);
+    g_mock_interrupt_level = 0;
+    TEST_ASSERT_TRUE(g_f_pend_scheduler);
+    g_f_pend_scheduler = false;
+    eexThreadResume(test_pri);
+    tcb = eexScheduler(false);
+    TEST_ASSERT_EQUAL(eexThreadTCB(EEX_CFG_THREADS_MAX), tcb);
+
+    TEST_ASSERTION_SHOULD_ASSERT(eexThreadSuspend(EEX_CFG_THREADS_MAX+1));
+
+    g_all_tests_run = true;
+}
+
+void test_scheduler_budget(void) {
+    eex_thread_id_t     test_pri = EEX_CFG_THREADS_MAX;
+    eex_thread_cb_t    *tcb;
+
+    // budgeted thread is dispatched and runs within its budget
+    eexThreadBudgetSet(test_pri, 500, 10);
+    _eexThreadIDSet(test_pri-1);
+    g_thread_ready_list = 1 << (test_pri-1);
+    tcb = eexScheduler(false);
+    TEST_ASSERT_EQUAL(eexThreadTCB(test_pri), tcb);
+    g_timer_us = 300;
+    tcb = eexScheduler(false);
+    TEST_ASSERT_EQUAL(eexThreadTCB(test_pri), tcb);
+    TEST_ASSERT_EQUAL(200, tcb->budget.remaining_us);
+
+    // time spent interrupted isn't charged
+    tcb = eexScheduler(true);
+    g_timer_us = 400;
+    _eexThreadIDSet(test_pri-2);
+    g_thread_ready_list = 0;
+    g_thread_interrupted_list = 1 << (test_pri-1);
+    tcb = eexScheduler(false);
+    TEST_ASSERT_NULL(tcb);
+    TEST_ASSERT_EQUAL(test_pri, eexThreadID());
+    TEST_ASSERT_EQUAL(200, eexThreadTCB(test_pri)->budget.remaining_us);
+
+    // overrun, thread is exhausted and a lower priority thread runs
+    g_timer_us = 700;
+    g_thread_ready_list = 1 << (test_pri-3);
+    tcb = eexScheduler(false);
+    TEST_ASSERT_EQUAL(eexThreadTCB(test_pri-2), tcb);
+    TEST_ASSERT_EQUAL(-100, eexThreadTCB(test_pri)->budget.remaining_us);
+    TEST_ASSERT_TRUE(_eexThreadListContains(&g_thread_exhausted_list, test_pri));
+    TEST_ASSERT_EQUAL(10, _eexThreadTimeoutNext());
+
+    // replenished at the period boundary, less the overrun
+    g_timer_ms = 10;
+    g_timer_us = 0;
+    tcb = eexScheduler(false);
+    TEST_ASSERT_EQUAL(eexThreadTCB(test_pri), tcb);
+    TEST_ASSERT_EQUAL(400, tcb->budget.remaining_us);
+    TEST_ASSERT_EQUAL(20, tcb->budget.next_ms);
+
+    // removing the budget
+    eexThreadBudgetSet(test_pri, 0, 0);
+    TEST_ASSERT_EQUAL(0, g_thread_budget_list);
+    TEST_ASSERTION_SHOULD_ASSERT(eexThreadBudgetSet(test_pri, 100, 0));
+
+    g_all_tests_run = true;
+}
+
+void _eexThreadCharge(eex_thread_id_t tid, bool f_job_done);
+void test_scheduler_criticality(void) {
+    eex_thread_id_t     test_pri = EEX_CFG_THREADS_MAX;
+    eex_thread_cb_t    *tcb;
+    uint32_t            n_switch, n_restore;
+
+    // high criticality thread runs within its optimistic budget
+    eexThreadCriticalitySet(test_pri, 1, 500);
+    eexThreadCriticalitySet(test_pri-1, 0, 0);
+    _eexThreadIDSet(test_pri-1);
+    g_thread_ready_list = 1 << (test_pri-1);
+    tcb = eexScheduler(false);
+    TEST_ASSERT_EQUAL(eexThreadTCB(test_pri), tcb);
+    g_timer_us = 300;
+    tcb = eexScheduler(false);
+    TEST_ASSERT_EQUAL(eexThreadTCB(test_pri), tcb);
+    TEST_ASSERT_EQUAL(300, tcb->crit.job_us);
+    TEST_ASSERT_EQUAL(0, eexKernelMode(NULL, NULL));
+
+    // the job overruns, low criticality threads are masked out
+    g_timer_us = 900;
+    tcb = eexScheduler(false);
+    TEST_ASSERT_EQUAL(eexThreadTCB(test_pri), tcb);
+    TEST_ASSERT_EQUAL(1, eexKernelMode(&n_switch, &n_restore));
+    TEST_ASSERT_EQUAL(1, n_switch);
+    TEST_ASSERT_EQUAL(0, n_restore);
+    TEST_ASSERT_TRUE(_eexThreadListContains(&g_thread_ready_list, test_pri-1));
+
+    // nothing of high criticality can run, the mode falls back instead of idling
+    eexThreadSuspend(test_pri);
+    tcb = eexScheduler(false);
+    TEST_ASSERT_EQUAL(eexThreadTCB(test_pri-1), tcb);
+    TEST_ASSERT_EQUAL(0, eexKernelMode(&n_switch, &n_restore));
+    TEST_ASSERT_EQUAL(1, n_switch);
+    TEST_ASSERT_EQUAL(1, n_restore);
+
+    // a job ends when the thread blocks
+    _eexThreadCharge(test_pri, true);
+    TEST_ASSERT_EQUAL(0, eexThreadTCB(test_pri)->crit.job_us);
+
+    // a high criticality thread interrupts a low one and overruns, the low one is on the stack and
+    // is still returned to without the mode falling back
+    eexThreadResume(test_pri);
+    _eexThreadIDSet(test_pri-1);
+    g_thread_ready_list = 1 << (test_pri-1);
+    tcb = eexScheduler(true);
+    TEST_ASSERT_EQUAL(eexThreadTCB(test_pri), tcb);
+    TEST_ASSERT_TRUE(_eexThreadListContains(&g_thread_interrupted_list, test_pri-1));
+    g_timer_us = 1500;
+    tcb = eexScheduler(false);
+    TEST_ASSERT_EQUAL(eexThreadTCB(test_pri), tcb);
+    TEST_ASSERT_EQUAL(1, eexKernelMode(&n_switch, &n_restore));
+    TEST_ASSERT_EQUAL(2, n_switch);
+    eexThreadSuspend(test_pri);
+    tcb = eexScheduler(false);
+    TEST_ASSERT_NULL(tcb);
+    TEST_ASSERT_EQUAL(test_pri-1, eexThreadID());
+    TEST_ASSERT_EQUAL(1, eexKernelMode(&n_switch, &n_restore));
+    TEST_ASSERT_EQUAL(1, n_restore);
+
+    // level 0 or no budget isn't monitored
+    eexThreadCriticalitySet(test_pri, 1, 0);
+    TEST_ASSERT_EQUAL(0, g_thread_crit_list);
+    TEST_ASSERT_TRUE(_eexThreadListContains(&g_crit_mask[1], test_pri-1));
+    TEST_ASSERT_FALSE(_eexThreadListContains(&g_crit_mask[1], test_pri));
+    TEST_ASSERTION_SHOULD_ASSERT(eexThreadCriticalitySet(test_pri, EEX_CFG_CRIT_LEVELS, 0));
+
+    g_all_tests_run = true;
+}
+
 
 
 
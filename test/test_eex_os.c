@@ -29,6 +29,43 @@
 #define MUTEX_TEST_THREAD_PRI_M   7
 #define MUTEX_TEST_THREAD_PRI_L   6
 
+#define POOL_TEST_THREAD_PRI_H    12
+#define POOL_TEST_THREAD_PRI_L    4
+
+#define COND_TEST_THREAD_PRI_H    14
+#define COND_TEST_THREAD_PRI_M    13
+#define COND_TEST_THREAD_PRI_L    3
+
+#define RWLOCK_TEST_THREAD_PRI_H  20
+#define RWLOCK_TEST_THREAD_PRI_L  2
+
+#define BARRIER_TEST_THREAD_PRI_H 22
+#define BARRIER_TEST_THREAD_PRI_M 21
+#define BARRIER_TEST_THREAD_PRI_L 5
+
+#define NOTIFY_TEST_THREAD_PRI_H  24
+#define NOTIFY_TEST_THREAD_PRI_L  8
+
+#define BCAST_TEST_THREAD_PRI_H   26
+#define BCAST_TEST_THREAD_PRI_M   25
+#define BCAST_TEST_THREAD_PRI_L   9
+
+#define ABORT_TEST_THREAD_PRI_H   28
+#define ABORT_TEST_THREAD_PRI_L   11
+
+#define JOIN_TEST_THREAD_PRI_H    29
+#define JOIN_TEST_THREAD_PRI_L    15
+
+#define IDLE_TEST_THREAD_PRI_H    31
+#define IDLE_TEST_THREAD_PRI_L    16
+
+#define FAST_TEST_THREAD_PRI_H    30
+#define FAST_TEST_HANDLER_PRI     27
+#define FAST_TEST_THREAD_PRI_L    17
+
+#define DEFER_TEST_THREAD_PRI     26
+#define DEFER_TEST_THREAD_PRI_L   18
+
 
 /*******************************************************************************
  *    MODULE INTERNAL DATA
@@ -37,8 +74,18 @@ extern eex_thread_cb_t    g_thread_tcb[EEX_CFG_THREADS_MAX];
 extern eex_thread_list_t  g_thread_ready_list;
 extern eex_thread_list_t  g_thread_waiting_list;
 extern eex_thread_list_t  g_thread_interrupted_list;
+extern eex_thread_list_t  g_thread_preempted_list;
+extern eex_thread_list_t  g_thread_suspended_list;
+extern eex_thread_list_t  g_thread_abort_list;
 extern eex_thread_list_t  g_thread_running;
 
+extern eex_idle_job_t     g_idle_job[EEX_CFG_IDLE_JOBS];
+extern volatile uint32_t  g_idle_head;
+extern volatile uint32_t  g_idle_tail;
+
+extern eex_defer_t * volatile g_defer_head;
+void _eexDeferThread(void * const argument);
+
 extern volatile uint32_t  g_timer_ms;
 extern volatile uint32_t  g_timer_us;
 
@@ -53,11 +100,51 @@ EEX_SEMAPHORE_NEW(sem1, 1, 0);
 EEX_SEMAPHORE_NEW(sem2, 1, 0);
 EEX_MUTEX_NEW(mutex);
 EEX_SIGNAL_NEW(sig_wake_up);
+EEX_POOL_NEW(pool_1, 16, 1);
+EEX_MUTEX_NEW(cond_mutex);
+EEX_COND_NEW(cond);
+EEX_RWLOCK_NEW(rwlock);
+EEX_SIGNAL_NEW(sig_rwlock);
+EEX_BARRIER_NEW(barrier, 3);
+EEX_SIGNAL_BROADCAST_NEW(sig_shutdown);
+EEX_SIGNAL_NEW(sig_abort);
+EEX_SEMAPHORE_NEW(sem_fast, 2, 0);
 
 bool  f_g_mutex_test_thread_pri_h_done = false;
 bool  f_g_mutex_test_thread_pri_m_done = false;
 bool  f_g_mutex_test_thread_pri_l_done = false;
 
+uint32_t  g_pool_blk_h[2];
+
+bool      g_cond_ready = false;
+uint32_t  g_cond_order[2];
+uint32_t  g_cond_n = 0;
+
+bool      g_rwlock_written = false;
+
+uint32_t  g_barrier_order[3];
+uint32_t  g_barrier_n = 0;
+
+uint32_t  g_notify_val = 0;
+
+uint32_t  g_bcast_n = 0;
+
+eex_status_t  g_abort_status[2];
+uint32_t      g_abort_n = 0;
+
+uint32_t  g_join_code = 0;
+uint32_t  g_join_n = 0;
+
+uint32_t  g_idle_order[EEX_CFG_IDLE_JOBS];
+uint32_t  g_idle_n = 0;
+
+uint32_t      g_fast_order[8];
+uint32_t      g_fast_n = 0;
+eex_status_t  g_fast_status;
+
+uint32_t      g_defer_order[4];
+uint32_t      g_defer_n = 0;
+
 
 /*******************************************************************************
  *    PRIVATE FUNCTIONS
@@ -162,6 +249,240 @@ static void thread_mutex_L(void * const argument) {
     }
 }
 
+static void thread_pool_H(void * const argument) {
+    static eex_status_t  rtn_status;
+
+    eexThreadEntry();
+    for (;;) {
+        eexPend(&rtn_status, &g_pool_blk_h[0], eexWaitForever, pool_1);  // take the only block
+        TEST_ASSERT_EQUAL(eexStatusOK, rtn_status);
+        eexPend(&rtn_status, &g_pool_blk_h[1], eexWaitForever, pool_1);  // pool empty, block until L frees
+        TEST_ASSERT_EQUAL(eexStatusOK, rtn_status);
+        eexDelay(eexWaitForever);
+    }
+}
+
+static void thread_pool_L(void * const argument) {
+    static eex_status_t  rtn_status;
+
+    eexThreadEntry();
+    for (;;) {
+        eexPost(&rtn_status, g_pool_blk_h[0], 0, pool_1);                 // free H's block, H preempts
+        TEST_ASSERT_EQUAL(eexStatusOK, rtn_status);
+        eexDelay(eexWaitForever);
+    }
+}
+
+// wait on the condition, argument selects the status variable
+static void thread_cond_wait(void * const argument) {
+    static eex_status_t  rtn_status[2];
+
+    eexThreadEntry();
+    for (;;) {
+        eexPend(&rtn_status[(uint32_t) argument], NULL, eexWaitForever, cond_mutex);
+        while (!g_cond_ready) {
+            eexCondWait(&rtn_status[(uint32_t) argument], eexWaitForever, cond, cond_mutex);
+            TEST_ASSERT_EQUAL(eexStatusOK, rtn_status[(uint32_t) argument]);
+        }
+        TEST_ASSERT_EQUAL(eexThreadID(), ((eex_sema_mutex_cb_t *) cond_mutex)->owner_id);  // holds the mutex
+        g_cond_order[g_cond_n++] = eexThreadID();
+        eexPost(&rtn_status[(uint32_t) argument], 0, 0, cond_mutex);
+        eexDelay(eexWaitForever);
+    }
+}
+
+static void thread_cond_broadcast(void * const argument) {
+    static eex_status_t  rtn_status;
+
+    eexThreadEntry();
+    for (;;) {
+        eexPend(&rtn_status, NULL, eexWaitForever, cond_mutex);
+        g_cond_ready = true;
+        eexCondBroadcast(&rtn_status, cond);                              // waiters move to the mutex
+        TEST_ASSERT_EQUAL(eexStatusOK, rtn_status);
+        eexPost(&rtn_status, 0, 0, cond_mutex);                           // waiters run in priority order
+        eexDelay(eexWaitForever);
+    }
+}
+
+static void thread_rwlock_writer(void * const argument) {
+    static eex_status_t  rtn_status;
+
+    eexThreadEntry();
+    for (;;) {
+        eexPendSignal(&rtn_status, NULL, eexWaitForever, 1, sig_rwlock);    // wait for the reader to take the lock
+        eexRWLockWrite(&rtn_status, eexWaitForever, rwlock);                // block until the reader releases
+        TEST_ASSERT_EQUAL(eexStatusOK, rtn_status);
+        g_rwlock_written = true;
+        eexRWLockWriteRelease(&rtn_status, rwlock);
+        TEST_ASSERT_EQUAL(eexStatusOK, rtn_status);
+        eexDelay(eexWaitForever);
+    }
+}
+
+static void thread_rwlock_reader(void * const argument) {
+    static eex_status_t  rtn_status;
+
+    eexThreadEntry();
+    for (;;) {
+        eexRWLockRead(&rtn_status, eexWaitForever, rwlock);                 // uncontended, fast path
+        TEST_ASSERT_EQUAL(eexStatusOK, rtn_status);
+        eexPostSignal(&rtn_status, 1, sig_rwlock);                          // writer preempts and blocks
+        TEST_ASSERT_FALSE(g_rwlock_written);
+        eexRWLockReadRelease(&rtn_status, rwlock);                          // writer preempts and runs
+        TEST_ASSERT_EQUAL(eexStatusOK, rtn_status);
+        TEST_ASSERT_TRUE(g_rwlock_written);
+        eexDelay(eexWaitForever);
+    }
+}
+
+static void thread_notify_wait(void * const argument) {
+    static eex_status_t  rtn_status;
+    static uint32_t      rtn_val;
+
+    eexThreadEntry();
+    for (;;) {
+        eexNotifyWait(&rtn_status, &rtn_val, eexWaitForever, 0xffffffff);
+        TEST_ASSERT_EQUAL(eexStatusOK, rtn_status);
+        g_notify_val = rtn_val;
+    }
+}
+
+static void thread_notify_post(void * const argument) {
+    static eex_status_t  rtn_status;
+
+    eexThreadEntry();
+    for (;;) {
+        eexNotify(&rtn_status, NOTIFY_TEST_THREAD_PRI_H, EEX_NOTIFY_INCREMENT, 0);   // waiter preempts
+        TEST_ASSERT_EQUAL(eexStatusOK, rtn_status);
+        TEST_ASSERT_EQUAL(1, g_notify_val);
+        eexNotify(&rtn_status, NOTIFY_TEST_THREAD_PRI_H, EEX_NOTIFY_OVERWRITE, 0x5a5a);
+        TEST_ASSERT_EQUAL(0x5a5a, g_notify_val);
+        eexDelay(eexWaitForever);
+    }
+}
+
+// wait for the broadcast, argument selects the status variable
+static void thread_bcast_wait(void * const argument) {
+    static eex_status_t  rtn_status[2];
+
+    eexThreadEntry();
+    for (;;) {
+        eexPendSignal(&rtn_status[(uint32_t) argument], NULL, eexWaitForever, 1, sig_shutdown);
+        TEST_ASSERT_EQUAL(eexStatusOK, rtn_status[(uint32_t) argument]);
+        ++g_bcast_n;
+        eexDelay(eexWaitForever);
+    }
+}
+
+static void thread_bcast_post(void * const argument) {
+    static eex_status_t  rtn_status;
+
+    eexThreadEntry();
+    for (;;) {
+        eexPostSignal(&rtn_status, 1, sig_shutdown);                          // both waiters run
+        TEST_ASSERT_EQUAL(2, g_bcast_n);
+        eexSignalClear(sig_shutdown, 1);
+        eexDelay(eexWaitForever);
+    }
+}
+
+static void thread_abort_wait(void * const argument) {
+    static eex_status_t  rtn_status;
+
+    eexThreadEntry();
+    for (;;) {
+        eexPendSignal(&rtn_status, NULL, eexWaitForever, 1, sig_abort);
+        g_abort_status[g_abort_n++] = rtn_status;
+    }
+}
+
+static void thread_abort_post(void * const argument) {
+    static eex_status_t  rtn_status;
+
+    eexThreadEntry();
+    for (;;) {
+        eexThreadAbortWait(ABORT_TEST_THREAD_PRI_H);
+        eexDelay(1);                                                            // waiter runs with the abort status
+        TEST_ASSERT_EQUAL(1, g_abort_n);
+        eexThreadSuspend(ABORT_TEST_THREAD_PRI_H);
+        eexPostSignal(&rtn_status, 1, sig_abort);                               // suspended waiter doesn't run
+        TEST_ASSERT_EQUAL(1, g_abort_n);
+        eexThreadResume(ABORT_TEST_THREAD_PRI_H);
+        eexDelay(eexWaitForever);
+    }
+}
+
+static void thread_join_wait(void * const argument) {
+    static eex_status_t  rtn_status;
+    static uint32_t      rtn_val;
+
+    eexThreadEntry();
+    for (;;) {
+        eexThreadJoin(&rtn_status, &rtn_val, eexWaitForever, JOIN_TEST_THREAD_PRI_L);
+        TEST_ASSERT_EQUAL(eexStatusOK, rtn_status);
+        g_join_code = rtn_val;
+        eexDelay(eexWaitForever);
+    }
+}
+
+// one-shot worker, exits with the number of times it was run
+static void thread_join_worker(void * const argument) {
+    eexThreadEntry();
+    ++g_join_n;
+    eexThreadExit(0x100 + g_join_n, (bool) argument);
+}
+
+// wait at the barrier, argument selects the status variable
+static void thread_barrier_party(void * const argument) {
+    static eex_status_t  rtn_status[3];
+
+    eexThreadEntry();
+    for (;;) {
+        eexBarrierWait(&rtn_status[(uint32_t) argument], eexWaitForever, barrier);
+        TEST_ASSERT_EQUAL(eexStatusOK, rtn_status[(uint32_t) argument]);
+        g_barrier_order[g_barrier_n++] = eexThreadID();
+        eexDelay(eexWaitForever);
+    }
+}
+
+// background job, job 1 resumes a suspended thread
+static void job_idle(void * const argument) {
+    g_idle_order[g_idle_n++] = (uint32_t) argument;
+    if ((uint32_t) argument == 1) { eexThreadResume(IDLE_TEST_THREAD_PRI_H); }
+}
+
+// fast handler and threads record their argument when they run
+static void fast_handler(void *argument, eex_status_t status, uint32_t val) {
+    g_fast_order[g_fast_n++] = (uint32_t) argument;
+    g_fast_status = status;
+}
+
+static void thread_fast_post(void * const argument) {
+    static eex_status_t  rtn_status;
+
+    eexThreadEntry();
+    for (;;) {
+        eexPost(&rtn_status, 0, 0, sem_fast);
+        g_fast_order[g_fast_n++] = (uint32_t) argument;
+        eexDelay(5);
+    }
+}
+
+static void thread_fast_record(void * const argument) {
+    eexThreadEntry();
+    g_fast_order[g_fast_n++] = (uint32_t) argument;
+    eexDelay(eexWaitForever);
+}
+
+// deferred work records its argument
+static void defer_record(void * const argument) {
+    g_defer_order[g_defer_n++] = (uint32_t) argument;
+}
+
+EEX_DEFER_NEW(defer_a, defer_record, (void *) 1);
+EEX_DEFER_NEW(defer_b, defer_record, (void *) 2);
+
 
 /*******************************************************************************
  *    SETUP, TEARDOWN
@@ -171,9 +492,17 @@ void setUp(void) {
     g_thread_ready_list       = 0;
     g_thread_waiting_list     = 0;
     g_thread_interrupted_list = 0;
+    g_thread_preempted_list   = 0;
+    g_thread_suspended_list   = 0;
+    g_thread_abort_list       = 0;
     g_thread_running          = 0;
     g_timer_ms = 0;
     g_timer_us = 0;
+    (void) memset(g_idle_job, 0, sizeof(g_idle_job));
+    g_idle_head = 0;
+    g_idle_tail = 0;
+    g_defer_head = NULL;
+    defer_kobj.pend = 0;
 }
 
 void tearDown(void) { }
@@ -280,6 +609,269 @@ void test_mutex_priority_inversion(void) {
                                                                                   // L sets f_g_mutex_test_thread_pri_l_done
 }
 
+void test_pool_blocking(void) {
+    (void) eexThreadCreate(thread_pool_H, NULL, POOL_TEST_THREAD_PRI_H, NULL);
+    (void) eexThreadCreate(thread_pool_L, NULL, POOL_TEST_THREAD_PRI_L, NULL);
+
+    dispatch(false);                                                              // dispatch H, takes the block
+    TEST_ASSERT_EQUAL(POOL_TEST_THREAD_PRI_H, eexThreadID());
+    TEST_ASSERT_NOT_NULL(g_pool_blk_h[0]);
+
+    dispatch(false);                                                              // H blocks on empty pool, L dispatches
+    TEST_ASSERT_EQUAL(POOL_TEST_THREAD_PRI_L, eexThreadID());
+    TEST_ASSERT_TRUE(g_thread_waiting_list & (1 << (POOL_TEST_THREAD_PRI_H-1))); // H waiting
+    TEST_ASSERT_TRUE(((eex_kobj_cb_t *) pool_1)->pend & (1 << (POOL_TEST_THREAD_PRI_H-1)));
+
+    dispatch(false);                                                              // L frees the block and is preempted, H dispatches
+    TEST_ASSERT_EQUAL(POOL_TEST_THREAD_PRI_H, eexThreadID());
+    TEST_ASSERT_EQUAL_HEX(g_pool_blk_h[0], g_pool_blk_h[1]);                      // H got the freed block
+    TEST_ASSERT_EQUAL(0, ((eex_kobj_cb_t *) pool_1)->pend);
+}
+
+void test_cond_broadcast(void) {
+    (void) eexThreadCreate(thread_cond_wait, (void *) 0, COND_TEST_THREAD_PRI_M, NULL);
+    (void) eexThreadCreate(thread_cond_wait, (void *) 1, COND_TEST_THREAD_PRI_H, NULL);
+    (void) eexThreadCreate(thread_cond_broadcast, NULL, COND_TEST_THREAD_PRI_L, NULL);
+
+    dispatch(false);                                                              // H takes the mutex and waits
+    dispatch(false);                                                              // M takes the released mutex and waits
+    TEST_ASSERT_EQUAL(COND_TEST_THREAD_PRI_M, eexThreadID());
+    dispatch(false);                                                              // L takes the mutex, broadcasts
+    TEST_ASSERT_EQUAL(COND_TEST_THREAD_PRI_L, eexThreadID());
+    TEST_ASSERT_EQUAL(0, g_cond_n);                                               // L still holds the mutex
+
+    for (int i=0; (i<6) && (g_cond_n < 2); ++i) { dispatch(false); }
+    TEST_ASSERT_EQUAL(2, g_cond_n);
+    TEST_ASSERT_EQUAL(COND_TEST_THREAD_PRI_H, g_cond_order[0]);                   // woken in priority order
+    TEST_ASSERT_EQUAL(COND_TEST_THREAD_PRI_M, g_cond_order[1]);
+    TEST_ASSERT_EQUAL(0, ((eex_kobj_cb_t *) cond)->pend);
+    TEST_ASSERT_EQUAL(0, ((eex_cond_cb_t *) cond)->signaled);
+    TEST_ASSERT_EQUAL(0, ((eex_sema_mutex_cb_t *) cond_mutex)->owner_id);
+}
+
+void test_rwlock_writer_waits(void) {
+    (void) eexThreadCreate(thread_rwlock_writer, NULL, RWLOCK_TEST_THREAD_PRI_H, NULL);
+    (void) eexThreadCreate(thread_rwlock_reader, NULL, RWLOCK_TEST_THREAD_PRI_L, NULL);
+
+    dispatch(false);                                                              // writer waits for the signal
+    dispatch(false);                                                              // reader takes the lock, signals and is preempted
+    TEST_ASSERT_EQUAL(RWLOCK_TEST_THREAD_PRI_L, eexThreadID());
+    dispatch(false);                                                              // writer blocks on the lock
+    TEST_ASSERT_EQUAL(RWLOCK_TEST_THREAD_PRI_H, eexThreadID());
+    TEST_ASSERT_TRUE(((eex_kobj_cb_t *) rwlock)->pend & (1 << (RWLOCK_TEST_THREAD_PRI_H-1)));
+    TEST_ASSERT_FALSE(g_rwlock_written);
+    dispatch(false);                                                              // reader resumes, releases and is preempted
+    TEST_ASSERT_EQUAL(RWLOCK_TEST_THREAD_PRI_L, eexThreadID());
+    dispatch(false);                                                              // writer takes the lock, writes and releases
+    TEST_ASSERT_EQUAL(RWLOCK_TEST_THREAD_PRI_H, eexThreadID());
+    TEST_ASSERT_TRUE(g_rwlock_written);
+    dispatch(false);                                                              // reader finishes
+    TEST_ASSERT_EQUAL(RWLOCK_TEST_THREAD_PRI_L, eexThreadID());
+    TEST_ASSERT_EQUAL(0, ((eex_rwlock_cb_t *) rwlock)->count.data);
+}
+
+void test_barrier_release_all(void) {
+    (void) eexThreadCreate(thread_barrier_party, (void *) 0, BARRIER_TEST_THREAD_PRI_H, NULL);
+    (void) eexThreadCreate(thread_barrier_party, (void *) 1, BARRIER_TEST_THREAD_PRI_M, NULL);
+    (void) eexThreadCreate(thread_barrier_party, (void *) 2, BARRIER_TEST_THREAD_PRI_L, NULL);
+
+    dispatch(false);                                                              // H arrives and waits
+    dispatch(false);                                                              // M arrives and waits
+    TEST_ASSERT_EQUAL(BARRIER_TEST_THREAD_PRI_M, eexThreadID());
+    TEST_ASSERT_EQUAL(0, g_barrier_n);
+    dispatch(false);                                                              // L arrives last, releases both and is preempted
+    TEST_ASSERT_EQUAL(BARRIER_TEST_THREAD_PRI_L, eexThreadID());
+    TEST_ASSERT_EQUAL(0, ((eex_barrier_cb_t *) barrier)->arrived);
+
+    for (int i=0; (i<6) && (g_barrier_n < 3); ++i) { dispatch(false); }
+    TEST_ASSERT_EQUAL(3, g_barrier_n);
+    TEST_ASSERT_EQUAL(BARRIER_TEST_THREAD_PRI_H, g_barrier_order[0]);             // released in priority order
+    TEST_ASSERT_EQUAL(BARRIER_TEST_THREAD_PRI_M, g_barrier_order[1]);
+    TEST_ASSERT_EQUAL(BARRIER_TEST_THREAD_PRI_L, g_barrier_order[2]);
+    TEST_ASSERT_EQUAL(0, ((eex_kobj_cb_t *) barrier)->pend);
+    TEST_ASSERT_EQUAL(0, ((eex_barrier_cb_t *) barrier)->released);
+}
+
+void test_notify_wakes_owner(void) {
+    (void) eexThreadCreate(thread_notify_wait, NULL, NOTIFY_TEST_THREAD_PRI_H, NULL);
+    (void) eexThreadCreate(thread_notify_post, NULL, NOTIFY_TEST_THREAD_PRI_L, NULL);
+
+    dispatch(false);                                                              // H waits
+    dispatch(false);                                                              // L increments and is preempted
+    TEST_ASSERT_EQUAL(NOTIFY_TEST_THREAD_PRI_L, eexThreadID());
+    TEST_ASSERT_EQUAL(0, g_notify_val);
+    for (int i=0; (i<6) && (g_notify_val != 0x5a5a); ++i) { dispatch(false); }
+    TEST_ASSERT_EQUAL(0x5a5a, g_notify_val);
+    dispatch(false);                                                              // L finishes its checks
+    TEST_ASSERT_EQUAL(NOTIFY_TEST_THREAD_PRI_L, eexThreadID());
+    TEST_ASSERT_EQUAL(0, eexThreadTCB(NOTIFY_TEST_THREAD_PRI_H)->notify.value);   // cleared by the wait
+    TEST_ASSERT_EQUAL(0, eexThreadTCB(NOTIFY_TEST_THREAD_PRI_H)->notify.cb.pend);
+}
+
+void test_signal_broadcast(void) {
+    (void) eexThreadCreate(thread_bcast_wait, (void *) 0, BCAST_TEST_THREAD_PRI_H, NULL);
+    (void) eexThreadCreate(thread_bcast_wait, (void *) 1, BCAST_TEST_THREAD_PRI_M, NULL);
+    (void) eexThreadCreate(thread_bcast_post, NULL, BCAST_TEST_THREAD_PRI_L, NULL);
+
+    dispatch(false);                                                              // H waits
+    dispatch(false);                                                              // M waits
+    dispatch(false);                                                              // L posts and is preempted
+    TEST_ASSERT_EQUAL(BCAST_TEST_THREAD_PRI_L, eexThreadID());
+    dispatch(false);                                                              // H runs
+    dispatch(false);                                                              // M runs
+    TEST_ASSERT_EQUAL(2, g_bcast_n);
+    dispatch(false);                                                              // L clears the signal
+    TEST_ASSERT_EQUAL(BCAST_TEST_THREAD_PRI_L, eexThreadID());
+    TEST_ASSERT_EQUAL(0, ((eex_signal_cb_t *) sig_shutdown)->signal);
+}
+
+void test_thread_abort_suspend(void) {
+    (void) eexThreadCreate(thread_abort_wait, NULL, ABORT_TEST_THREAD_PRI_H, NULL);
+    (void) eexThreadCreate(thread_abort_post, NULL, ABORT_TEST_THREAD_PRI_L, NULL);
+
+    dispatch(false);                                                              // H waits
+    dispatch(false);                                                              // L aborts the wait and delays
+    dispatch(false);                                                              // H records the abort and waits again
+    TEST_ASSERT_EQUAL(1, g_abort_n);
+    TEST_ASSERT_EQUAL(eexStatusThreadAborted, g_abort_status[0]);
+    for (int i=0; (i<4) && (g_abort_n < 2); ++i) { dispatch(false); }
+    TEST_ASSERT_EQUAL(2, g_abort_n);
+    TEST_ASSERT_EQUAL(eexStatusOK, g_abort_status[1]);
+    TEST_ASSERT_EQUAL(0, g_thread_suspended_list);
+}
+
+void test_thread_exit_join(void) {
+    (void) eexThreadCreate(thread_join_wait, NULL, JOIN_TEST_THREAD_PRI_H, NULL);
+    (void) eexThreadCreate(thread_join_worker, (void *) true, JOIN_TEST_THREAD_PRI_L, NULL);
+
+    dispatch(false);                                                              // H waits for L
+    dispatch(false);                                                              // L exits and is preempted
+    TEST_ASSERT_EQUAL(JOIN_TEST_THREAD_PRI_L, eexThreadID());
+    dispatch(false);                                                              // H gets the exit code
+    TEST_ASSERT_EQUAL(0x101, g_join_code);
+    TEST_ASSERT_EQUAL(1, g_join_n);
+    TEST_ASSERT_EQUAL(0, (g_thread_ready_list | g_thread_waiting_list) & (1 << (JOIN_TEST_THREAD_PRI_L-1)));
+    TEST_ASSERT_NULL(eexThreadTCB(JOIN_TEST_THREAD_PRI_L)->fn_thread);
+
+    // freed slot is reused without a notification left for the exited thread,
+    // the worker exits without a joiner and keeps its slot
+    eexThreadTCB(JOIN_TEST_THREAD_PRI_L)->notify.value   = 0x55;
+    eexThreadTCB(JOIN_TEST_THREAD_PRI_L)->notify.pending = 1;
+    TEST_ASSERT_EQUAL(eexStatusOK, eexThreadCreate(thread_join_worker, (void *) false, JOIN_TEST_THREAD_PRI_L, NULL));
+    TEST_ASSERT_EQUAL(0, eexThreadTCB(JOIN_TEST_THREAD_PRI_L)->notify.value);
+    TEST_ASSERT_EQUAL(0, eexThreadTCB(JOIN_TEST_THREAD_PRI_L)->notify.pending);
+    dispatch(false);
+    TEST_ASSERT_EQUAL(2, g_join_n);
+    TEST_ASSERT_EQUAL(0x102, eexThreadTCB(JOIN_TEST_THREAD_PRI_L)->join.exit_code);
+    TEST_ASSERT_EQUAL(eexStatusThreadPriorityErr, eexThreadCreate(thread_join_worker, NULL, JOIN_TEST_THREAD_PRI_L, NULL));
+}
+
+bool _eexIdleJobRun(int32_t ms_next);
+void test_idle_jobs(void) {
+    (void) eexThreadCreate(thread_delay, (void *) 3, IDLE_TEST_THREAD_PRI_L, NULL);
+    (void) eexThreadCreate(thread_delay, (void *) 50, IDLE_TEST_THREAD_PRI_H, NULL);
+    eexThreadSuspend(IDLE_TEST_THREAD_PRI_H);
+    dispatch(false);                                                              // L delays until 3
+
+    // jobs run in idle time until one readies a thread, the rest wait for the next idle time
+    for (uint32_t i=0; i<3; ++i) { TEST_ASSERT_EQUAL(eexStatusOK, eexIdleJobSubmit(job_idle, (void *) i, 500)); }
+    dispatch(false);                                                              // job 1 resumes H, H delays
+    TEST_ASSERT_EQUAL(2, g_idle_n);
+    TEST_ASSERT_EQUAL(IDLE_TEST_THREAD_PRI_H, eexThreadID());
+    g_f_thread = false;
+    dispatch(false);                                                              // job 2, then idle until L wakes
+    TEST_ASSERT_EQUAL(3, g_idle_n);
+    TEST_ASSERT_TRUE(g_f_thread);
+    TEST_ASSERT_EQUAL(3, g_timer_ms);
+    for (uint32_t i=0; i<3; ++i) { TEST_ASSERT_EQUAL(i, g_idle_order[i]); }
+
+    // a job that doesn't fit before the next timeout waits
+    TEST_ASSERT_EQUAL(eexStatusOK, eexIdleJobSubmit(job_idle, (void *) 3, 5000));
+    dispatch(false);                                                              // L wakes at 6
+    TEST_ASSERT_EQUAL(6, g_timer_ms);
+    TEST_ASSERT_EQUAL(3, g_idle_n);
+
+    // a full queue drops the job
+    for (uint32_t i=1; i<EEX_CFG_IDLE_JOBS; ++i) { TEST_ASSERT_EQUAL(eexStatusOK, eexIdleJobSubmit(job_idle, (void *) 4, 0)); }
+    TEST_ASSERT_EQUAL(eexStatusKOErr, eexIdleJobSubmit(job_idle, (void *) 4, 0));
+
+    // the job that didn't fit fits an idle time of over 71 minutes, which doesn't overflow in us
+    TEST_ASSERT_TRUE(_eexIdleJobRun(4294968));
+    TEST_ASSERT_EQUAL(4, g_idle_n);
+    TEST_ASSERT_EQUAL(3, g_idle_order[3]);
+}
+
+void test_fast_handler(void) {
+    eex_status_t  rtn_status;
+
+    TEST_ASSERT_EQUAL(eexStatusOK, eexHandlerCreate(fast_handler, (void *) FAST_TEST_HANDLER_PRI, FAST_TEST_HANDLER_PRI, sem_fast, 0, NULL));
+    TEST_ASSERT_EQUAL(eexStatusThreadPriorityErr, eexHandlerCreate(fast_handler, NULL, FAST_TEST_HANDLER_PRI, sem_fast, 0, NULL));
+    (void) eexThreadCreate(thread_fast_post, (void *) FAST_TEST_THREAD_PRI_L, FAST_TEST_THREAD_PRI_L, NULL);
+
+    // a post to the handler preempts the poster, the handler runs in the scheduler pass that resumes it
+    dispatch(false);                                                              // L posts and is preempted
+    TEST_ASSERT_EQUAL(0, g_fast_n);
+    dispatch(false);                                                              // handler runs, L records and delays
+    TEST_ASSERT_EQUAL(2, g_fast_n);
+    TEST_ASSERT_EQUAL(FAST_TEST_HANDLER_PRI, g_fast_order[0]);
+    TEST_ASSERT_EQUAL(FAST_TEST_THREAD_PRI_L, g_fast_order[1]);
+    TEST_ASSERT_EQUAL(eexStatusOK, g_fast_status);
+    TEST_ASSERT_EQUAL(FAST_TEST_THREAD_PRI_L, eexThreadID());
+
+    // an interrupt post to the handler is ordered with threads by priority
+    (void) eexThreadCreate(thread_fast_record, (void *) FAST_TEST_THREAD_PRI_H, FAST_TEST_THREAD_PRI_H, NULL);
+    g_mock_interrupt_level = 1;
+    eexPost(&rtn_status, 0, 0, sem_fast);
+    g_mock_interrupt_level = 0;
+    TEST_ASSERT_EQUAL(eexStatusOK, rtn_status);
+    dispatch(false);                                                              // H runs first
+    TEST_ASSERT_EQUAL(FAST_TEST_THREAD_PRI_H, g_fast_order[2]);
+    dispatch(false);                                                              // handler runs, idle until L posts again
+    TEST_ASSERT_EQUAL(FAST_TEST_HANDLER_PRI, g_fast_order[3]);
+    TEST_ASSERT_EQUAL(5, g_timer_ms);
+    dispatch(false);
+    TEST_ASSERT_EQUAL(6, g_fast_n);
+    TEST_ASSERT_EQUAL(FAST_TEST_HANDLER_PRI, g_fast_order[4]);
+    TEST_ASSERT_EQUAL(FAST_TEST_THREAD_PRI_L, g_fast_order[5]);
+    TEST_ASSERT_EQUAL(0, ((eex_sema_mutex_cb_t *) sem_fast)->count.data);
+    TEST_ASSERT_NOT_EQUAL(0, g_thread_waiting_list & (1 << (FAST_TEST_HANDLER_PRI-1)));                 // waiting again
+}
+
+void test_deferred_work(void) {
+    (void) eexThreadCreate(_eexDeferThread, NULL, DEFER_TEST_THREAD_PRI, NULL);
+    (void) eexThreadCreate(thread_delay, (void *) 10, DEFER_TEST_THREAD_PRI_L, NULL);
+    dispatch(false);                                                              // deferred work thread waits
+    dispatch(false);                                                              // L delays
+    TEST_ASSERT_NOT_EQUAL(0, defer_kobj.pend & (1 << (DEFER_TEST_THREAD_PRI-1)));
+
+    // the first push pends the scheduler, an item already queued isn't pushed again
+    g_f_pend_scheduler = false;
+    g_mock_interrupt_level = 1;
+    TEST_ASSERT_TRUE(eexDefer(defer_a));
+    TEST_ASSERT_TRUE(g_f_pend_scheduler);
+    g_f_pend_scheduler = false;
+    TEST_ASSERT_TRUE(eexDefer(defer_b));
+    TEST_ASSERT_FALSE(eexDefer(defer_a));
+    g_mock_interrupt_level = 0;
+    TEST_ASSERT_FALSE(g_f_pend_scheduler);
+
+    // items run in the order deferred, then the thread waits again
+    dispatch(false);
+    TEST_ASSERT_EQUAL(2, g_defer_n);
+    TEST_ASSERT_EQUAL(1, g_defer_order[0]);
+    TEST_ASSERT_EQUAL(2, g_defer_order[1]);
+    TEST_ASSERT_NULL(g_defer_head);
+    TEST_ASSERT_EQUAL(0, ((eex_defer_t *) defer_a)->queued);
+    TEST_ASSERT_NOT_EQUAL(0, defer_kobj.pend & (1 << (DEFER_TEST_THREAD_PRI-1)));
+
+    // a push that interrupts a higher priority thread leaves it running
+    g_thread_running = DEFER_TEST_THREAD_PRI + 1;
+    g_mock_interrupt_level = 1;
+    TEST_ASSERT_TRUE(eexDefer(defer_b));
+    g_mock_interrupt_level = 0;
+    TEST_ASSERT_FALSE(g_f_pend_scheduler);
+}
+
 
 
 
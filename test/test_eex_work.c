@@ -0,0 +1,229 @@
+/*******************************************************************************
+ *    INCLUDED FILES
+ ******************************************************************************/
+#include <string.h>
+
+//-- unity: unit test framework
+#include "unity.h"
+#include "assert_test_helpers.h"
+
+//-- module being tested
+#include "eex_os.h"
+#include "eex_work.h"
+#include "eex_platform_mock.c"
+
+#pragma GCC diagnostic ignored "-Wmultichar"            // to allow e.g. 'MUTX'
+#pragma GCC diagnostic ignored "-Wpointer-to-int-cast"  // console 64 bit pointers don't like cast to uint32_t
+#pragma GCC diagnostic ignored "-Wint-to-pointer-cast"
+
+
+/*******************************************************************************
+ *    DEFINITIONS
+ ******************************************************************************/
+
+#define SERVER_THREAD_PRI     20
+#define WORKER_THREAD_PRI     10      // and WORKER_THREAD_PRI + 1
+#define SPIN_THREAD_PRI       1
+
+
+/*******************************************************************************
+ *    MODULE INTERNAL DATA
+ ******************************************************************************/
+
+extern eex_thread_cb_t    g_thread_tcb[EEX_CFG_THREADS_MAX+1];
+extern eex_thread_list_t  g_thread_ready_list;
+extern eex_thread_list_t  g_thread_waiting_list;
+extern eex_thread_list_t  g_thread_interrupted_list;
+extern eex_thread_list_t  g_thread_preempted_list;
+extern eex_thread_list_t  g_thread_budget_list;
+extern eex_thread_list_t  g_thread_exhausted_list;
+extern eex_thread_list_t  g_thread_running;
+
+bool  _eexServerGet(eex_server_cb_t *server, eex_job_t *job);
+
+
+/*******************************************************************************
+ *    PRIVATE DATA
+ ******************************************************************************/
+
+bool  g_all_tests_run;
+
+EEX_SERVER_NEW(server_4, 4);
+EEX_WORKERS_NEW(pool_2x4, 2, 4);
+
+uint32_t  g_job_order[8];
+uint32_t  g_job_n;
+
+
+/*******************************************************************************
+ *    PRIVATE FUNCTIONS
+ ******************************************************************************/
+
+// simulate eexKernelStart function dispatching threads
+void dispatch(bool from_interrupt) {
+    eex_thread_cb_t * tcb;
+
+    tcb = eexScheduler(from_interrupt);
+    if (g_f_pend_scheduler) {    // rerun scheduler before dispatching thread
+        g_f_pend_scheduler = false;
+        tcb = eexScheduler(from_interrupt);
+    }
+    tcb->fn_thread(tcb->arg);
+}
+
+// increment the global timer by 1 ms when there are no threads ready to dispatch
+uint32_t eexIdleHook(int32_t sleep_for_ms)  {
+    return (1);
+}
+
+// each job takes 200 us
+static void job_200us(void * const argument) {
+    g_job_order[g_job_n++] = (uint32_t) argument;
+    g_timer_us += 200;
+}
+
+// lowest priority thread, always ready so the scheduler never idles
+static void thread_spin(void * const argument) {
+    eexThreadEntry();
+    for (;;) { eexYield(); }
+}
+
+
+/*******************************************************************************
+ *    SETUP, TEARDOWN
+ ******************************************************************************/
+void setUp(void) {
+    (void) memset(g_thread_tcb, 0, sizeof(g_thread_tcb));
+    g_thread_ready_list       = 0;
+    g_thread_waiting_list     = 0;
+    g_thread_interrupted_list = 0;
+    g_thread_preempted_list   = 0;
+    g_thread_budget_list      = 0;
+    g_thread_exhausted_list   = 0;
+    g_thread_running          = 0;
+    g_timer_ms                = 0;
+    g_timer_us                = 0;
+    g_mock_interrupt_level    = 0;
+    g_job_n                   = 0;
+    g_all_tests_run = false;
+}
+
+void tearDown(void) {
+    TEST_ASSERT_TRUE(g_all_tests_run);
+    g_all_tests_run = false;
+}
+
+
+/*******************************************************************************
+ *    TESTS
+ ******************************************************************************/
+
+void test_job_queue(void) {
+    eex_server_cb_t *server = (eex_server_cb_t *) server_4;
+    eex_job_t        job;
+
+    TEST_ASSERT_EQUAL(eexStatusOK, eexServerCreate(server_4, SERVER_THREAD_PRI, 0, 0, NULL));
+    TEST_ASSERT_FALSE(_eexServerGet(server, &job));
+
+    // fill the queue, the next job is dropped
+    for (uint32_t i=0; i<4; ++i) { TEST_ASSERT_EQUAL(eexStatusOK, _eexServerPut(server, job_200us, (void *) i)); }
+    TEST_ASSERT_EQUAL(eexStatusKOErr, _eexServerPut(server, job_200us, (void *) 4));
+    TEST_ASSERT_EQUAL(1, server->n_dropped);
+
+    // jobs come out in order, and the freed slots are reused around the ring
+    for (uint32_t i=0; i<2; ++i) {
+        TEST_ASSERT_TRUE(_eexServerGet(server, &job));
+        TEST_ASSERT_EQUAL(i, (uint32_t) job.arg);
+    }
+    for (uint32_t i=4; i<6; ++i) { TEST_ASSERT_EQUAL(eexStatusOK, _eexServerPut(server, job_200us, (void *) i)); }
+    for (uint32_t i=2; i<6; ++i) {
+        TEST_ASSERT_TRUE(_eexServerGet(server, &job));
+        TEST_ASSERT_EQUAL(i, (uint32_t) job.arg);
+    }
+    TEST_ASSERT_FALSE(_eexServerGet(server, &job));
+
+    // a claimed slot that isn't published yet holds up the jobs behind it
+    TEST_ASSERT_EQUAL(eexStatusOK, _eexServerPut(server, job_200us, (void *) 6));
+    server->jobs[server->head & server->mask].seq -= 1;
+    TEST_ASSERT_FALSE(_eexServerGet(server, &job));
+    server->jobs[server->head & server->mask].seq += 1;
+    TEST_ASSERT_TRUE(_eexServerGet(server, &job));
+
+    TEST_ASSERTION_SHOULD_ASSERT(_eexServerPut(server, NULL, NULL));
+
+    g_all_tests_run = true;
+}
+
+void test_server_budget(void) {
+    eex_status_t  rtn_status;
+
+    TEST_ASSERT_EQUAL(eexStatusOK, eexServerCreate(server_4, SERVER_THREAD_PRI, 500, 10, NULL));
+    dispatch(false);                                                // server waits for work
+
+    // a burst of jobs from an interrupt handler
+    g_mock_interrupt_level = 1;
+    for (uint32_t i=0; i<4; ++i) {
+        eexServerSubmit(&rtn_status, server_4, job_200us, (void *) i);
+        TEST_ASSERT_EQUAL(eexStatusOK, rtn_status);
+    }
+    g_mock_interrupt_level = 0;
+
+    // one job per dispatch until the budget is used up
+    for (uint32_t i=0; i<3; ++i) { dispatch(false); }
+    TEST_ASSERT_EQUAL(3, g_job_n);
+    TEST_ASSERT_EQUAL(0, g_timer_ms);
+
+    // exhausted, the last job waits for the budget to be replenished
+    dispatch(false);
+    TEST_ASSERT_EQUAL(4, g_job_n);
+    TEST_ASSERT_EQUAL(10, g_timer_ms);
+    TEST_ASSERT_EQUAL(400, eexThreadTCB(SERVER_THREAD_PRI)->budget.remaining_us);
+    for (uint32_t i=0; i<4; ++i) { TEST_ASSERT_EQUAL(i, g_job_order[i]); }
+
+    g_all_tests_run = true;
+}
+
+void test_worker_pool(void) {
+    eex_workers_cb_t *pool = (eex_workers_cb_t *) pool_2x4;
+    eex_status_t      rtn_status;
+
+    TEST_ASSERT_EQUAL(eexStatusOK, eexWorkersCreate(pool_2x4, WORKER_THREAD_PRI, 2, 2, NULL));
+    (void) eexThreadCreate(thread_spin, NULL, SPIN_THREAD_PRI, NULL);
+    for (uint32_t i=0; i<3; ++i) { dispatch(false); }                  // workers wait, spin runs
+    TEST_ASSERT_EQUAL(SPIN_THREAD_PRI, eexThreadID());
+
+    // jobs from an interrupt handler, the first submit wakes a worker
+    g_mock_interrupt_level = 1;
+    for (uint32_t i=0; i<3; ++i) {
+        eexWorkersSubmit(&rtn_status, pool_2x4, 0, job_200us, (void *) i);
+        TEST_ASSERT_EQUAL(eexStatusOK, rtn_status);
+    }
+    eexWorkersSubmit(&rtn_status, pool_2x4, 1, job_200us, (void *) 10);
+    TEST_ASSERT_EQUAL(eexStatusOK, rtn_status);
+    TEST_ASSERT_EQUAL(1, pool->sema->count.data);
+    g_mock_interrupt_level = 0;
+
+    // a batch of two per dispatch, the higher level first
+    dispatch(false);
+    TEST_ASSERT_EQUAL(WORKER_THREAD_PRI+1, eexThreadID());
+    TEST_ASSERT_EQUAL(2, g_job_n);
+    TEST_ASSERT_EQUAL(10, g_job_order[0]);
+    TEST_ASSERT_EQUAL(0,  g_job_order[1]);
+    dispatch(false);
+    TEST_ASSERT_EQUAL(4, g_job_n);
+    TEST_ASSERT_EQUAL(1,  g_job_order[2]);
+    TEST_ASSERT_EQUAL(2,  g_job_order[3]);
+    dispatch(false);                                                    // queues empty, the worker waits again
+    dispatch(false);
+    TEST_ASSERT_EQUAL(SPIN_THREAD_PRI, eexThreadID());
+    TEST_ASSERT_EQUAL(4, g_job_n);
+    TEST_ASSERT_EQUAL(0, pool->sema->count.data);
+
+    // a full level drops the job
+    for (uint32_t i=0; i<4; ++i) { TEST_ASSERT_EQUAL(eexStatusOK, _eexWorkersPut(pool, 1, job_200us, (void *) i)); }
+    TEST_ASSERT_EQUAL(eexStatusKOErr, _eexWorkersPut(pool, 1, job_200us, (void *) 4));
+    TEST_ASSERT_EQUAL(1, pool->queues[1].n_dropped);
+    TEST_ASSERTION_SHOULD_ASSERT(_eexWorkersPut(pool, 2, job_200us, NULL));
+
+    g_all_tests_run = true;
+}
@@ -0,0 +1,119 @@
+/*******************************************************************************
+
+    eex_stack_threshold.c - Worst case system stack under preemption thresholds.
+
+    Every preemption leaves the interrupted thread's stack in place on the
+    single system stack, so the worst case is the deepest chain of threads
+    that can preempt each other. Without thresholds any higher priority
+    thread can preempt, and the worst case is the sum over all threads.
+    With thresholds a thread can only be preempted by threads above its
+    threshold, and the worst case is the heaviest chain t1 < t2 < ... where
+    each priority is above the threshold of the thread before it. This is
+    the scheduler's rule: a thread preempts only above the threshold of the
+    highest priority unfinished thread, the top of the chain, whose
+    threshold is the highest in it. A thread held unfinished after its own
+    post released a thread above its threshold has returned from its
+    function and holds no stack, so the chain is an upper bound for it.
+
+    Reads one thread per line from a file or stdin:
+
+        priority  threshold  stack_bytes    # comment
+
+    where stack_bytes is the deepest the thread's stack gets, including the
+    exception frame pushed when it is interrupted. Blank lines and lines
+    starting with # are ignored. A threshold of 0 means the thread's priority.
+    Each priority may appear only once.
+
+    gcc -std=gnu99 -O2 -Ihdr tools/eex_stack_threshold.c -o eex_stack_threshold
+    ./eex_stack_threshold threads.txt
+
+    COPYRIGHT NOTICE: (c) ee-quipment.com
+    All Rights Reserved
+
+ ******************************************************************************/
+
+
+#include  <stdint.h>
+#include  <stdio.h>
+#include  "eex_os.h"
+
+#define TOOL_LINE_MAX   256
+
+typedef struct {
+    uint32_t    threshold;      // 0 if there is no thread at this priority
+    uint32_t    stack_bytes;
+} thread_stack_t;
+
+static thread_stack_t   g_thread[EEX_CFG_THREADS_MAX+1];
+static uint32_t         g_chain_pri[EEX_CFG_THREADS_MAX+1];    // thread below each one in its heaviest chain
+
+
+// Heaviest preemption chain ending at each priority, lowest priority first.
+// Returns the worst case stack and leaves the top of the worst chain in *p_top.
+static uint32_t _worstCase(bool f_thresholds, uint32_t *p_top) {
+    uint32_t chain[EEX_CFG_THREADS_MAX+1] = { 0 };
+    uint32_t worst = 0, threshold;
+
+    *p_top = 0;
+    for (uint32_t pri=1; pri<=EEX_CFG_THREADS_MAX; ++pri) {
+        if (g_thread[pri].threshold == 0) { continue; }
+        g_chain_pri[pri] = 0;
+        for (uint32_t below=1; below<pri; ++below) {
+            if (g_thread[below].threshold == 0) { continue; }
+            threshold = f_thresholds ? g_thread[below].threshold : below;
+            if ((pri > threshold) && (chain[below] > chain[g_chain_pri[pri]])) { g_chain_pri[pri] = below; }
+        }
+        chain[pri] = g_thread[pri].stack_bytes + chain[g_chain_pri[pri]];
+        if (chain[pri] > worst) { worst = chain[pri];  *p_top = pri; }
+    }
+    return (worst);
+}
+
+static void _printChain(uint32_t top) {
+    printf("    chain:");
+    for (uint32_t pri=top; pri; pri=g_chain_pri[pri]) { printf(" %u", (unsigned) pri); }
+    printf("\n");
+}
+
+
+int main(int argc, char *argv[]) {
+    FILE       *fp = stdin;
+    char        line[TOOL_LINE_MAX], first[2];
+    unsigned    pri, threshold, stack_bytes;
+    uint32_t    n_line = 0, top, without, with;
+
+    if (argc > 1) {
+        fp = fopen(argv[1], "r");
+        if (fp == NULL) { fprintf(stderr, "can't open %s\n", argv[1]);  return (1); }
+    }
+
+    while (fgets(line, sizeof(line), fp)) {
+        ++n_line;
+        if (sscanf(line, " %u %u %u", &pri, &threshold, &stack_bytes) != 3) {
+            if ((sscanf(line, " %1s", first) != 1) || (first[0] == '#')) { continue; }   // blank or comment
+            fprintf(stderr, "line %u: expected priority threshold stack_bytes\n", (unsigned) n_line);
+            return (1);
+        }
+        if (threshold == 0) { threshold = pri; }
+        if ((pri == 0) || (pri > EEX_CFG_THREADS_MAX) || (threshold < pri) || (threshold > EEX_CFG_THREADS_MAX)) {
+            fprintf(stderr, "line %u: priority 1-%u and threshold priority-%u\n", (unsigned) n_line,
+                    (unsigned) EEX_CFG_THREADS_MAX, (unsigned) EEX_CFG_THREADS_MAX);
+            return (1);
+        }
+        if (g_thread[pri].threshold) {
+            fprintf(stderr, "line %u: priority %u is already listed\n", (unsigned) n_line, pri);
+            return (1);
+        }
+        g_thread[pri].threshold   = threshold;
+        g_thread[pri].stack_bytes = stack_bytes;
+    }
+
+    without = _worstCase(false, &top);
+    printf("worst case stack without thresholds: %6u bytes\n", (unsigned) without);
+    _printChain(top);
+    with = _worstCase(true, &top);
+    printf("worst case stack with thresholds:    %6u bytes\n", (unsigned) with);
+    _printChain(top);
+    printf("saved:                               %6u bytes\n", (unsigned) (without - with));
+    return (0);
+}